@@ -49,16 +49,16 @@ static void leaderTestAA(uint8_t seq_index) {
   serial_port.println(F("leaderTestAA"));
 }
 
-static const kaleidoscope::plugin::Leader::dictionary_t leader_dictionary[] PROGMEM =
-  LEADER_DICT({LEADER_SEQ(LEAD(0), Key_A), leaderTestA},
-              {LEADER_SEQ(LEAD(0), Key_A, Key_A), leaderTestAA});
+LEADER_DICTIONARY(leader_dictionary,
+                  {LEADER_SEQ(LEAD(0), Key_A), leaderTestA},
+                  {LEADER_SEQ(LEAD(0), Key_A, Key_A), leaderTestAA});
 
 KALEIDOSCOPE_INIT_PLUGINS(Leader);
 
 void setup() {
   Kaleidoscope.setup();
 
-  Leader.dictionary = leader_dictionary;
+  Leader.setDictionary(leader_dictionary);
 }
 
 void loop() {
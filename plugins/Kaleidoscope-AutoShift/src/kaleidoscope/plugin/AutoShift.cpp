@@ -146,6 +146,7 @@ EventHandlerResult AutoShift::onKeyswitchEvent(KeyEvent &event) {
     // The key is eligible to be auto-shifted, so we add it to the queue and
     // defer processing of the event.
     queue_.append(event);
+    Runtime.armDeadline(timeout_deadline_, settings_.timeout);
     return EventHandlerResult::ABORT;
   }
 
@@ -153,17 +154,11 @@ EventHandlerResult AutoShift::onKeyswitchEvent(KeyEvent &event) {
 }
 
 // -----------------------------------------------------------------------------
-EventHandlerResult AutoShift::afterEachCycle() {
-  // If there's a pending AutoShift event, and it has timed out, we need to
-  // release the event with the `shift` flag applied.
-  if (!queue_.isEmpty() &&
-      Runtime.hasTimeExpired(queue_.timestamp(0), settings_.timeout)) {
-    // Toggle the state of the `SHIFT_HELD` bit in the modifier flags for the
-    // key for the pending event.
-    flushEvent(true);
-    flushQueue();
-  }
-  return EventHandlerResult::OK;
+void AutoShift::onTimeoutDeadline() {
+  // The pending AutoShift event has timed out, so we need to release the event
+  // with the `shift` flag applied.
+  ::AutoShift.flushEvent(true);
+  ::AutoShift.flushQueue();
 }
 
 void AutoShift::flushQueue() {
@@ -174,6 +169,7 @@ void AutoShift::flushQueue() {
       return;
     }
   }
+  Runtime.cancelDeadline(timeout_deadline_);
 }
 
 bool AutoShift::checkForRelease() const {
@@ -24,6 +24,7 @@
 
 #include <stdint.h>  // for uint8_t, uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
@@ -235,7 +236,6 @@ class AutoShift : public Plugin {
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  private:
   // ---------------------------------------------------------------------------
@@ -267,7 +267,12 @@ class AutoShift : public Plugin {
   // of `KeyAddr::none()`, so the plugin will start in an inactive state.
   KeyEvent pending_event_;
 
+  // Expires when the pending keypress has been held long enough to become a
+  // long press
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
   void flushQueue();
+  static void onTimeoutDeadline();
   void flushEvent(bool is_long_press = false);
   bool checkForRelease() const;
 
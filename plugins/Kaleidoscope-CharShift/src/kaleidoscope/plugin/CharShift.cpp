@@ -26,9 +26,8 @@
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <Kaleidoscope-Ranges.h>       // for CS_FIRST, CS_LAST
 
-#include "kaleidoscope/KeyAddrMap.h"                      // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddrBitfield.h"                 // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"                        // for KeyEvent
-#include "kaleidoscope/KeyMap.h"                          // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                        // for LiveKeys, live_keys
 #include "kaleidoscope/Runtime.h"                         // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"                   // for Base<>::HID, VirtualProps::HID
@@ -73,8 +72,8 @@ EventHandlerResult CharShift::onKeyEvent(KeyEvent &event) {
 
   // Determine if a shift key is being held.
   bool shift_held = false;
-  for (Key key : live_keys.all()) {
-    if (key.isKeyboardShift()) {
+  for (KeyAddr key_addr : live_keys.active()) {
+    if (live_keys[key_addr].isKeyboardShift()) {
       shift_held = true;
       break;
     }
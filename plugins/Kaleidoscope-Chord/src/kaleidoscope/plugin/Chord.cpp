@@ -50,33 +50,63 @@ EventHandlerResult Chord::onKeyswitchEvent(KeyEvent &event) {
 
   if (isChordStrictSubset()) {
     start_time_ = Runtime.millisAtCycleStart();
+    Runtime.armDeadline(timeout_deadline_, timeout_);
     return EventHandlerResult::ABORT;
   }
 
   Key target_key = getChord();
 
   if (target_key == Key_NoKey) {
-    potential_chord_size_--;
+    removeLastEvent();
     resolveOrArpeggiate();
     return EventHandlerResult::OK;
   }
 
   potential_chord_size_ = 0;
+  potential_chord_keys_ = 0;
   event.key             = target_key;
   return EventHandlerResult::OK;
 }
 
-EventHandlerResult Chord::afterEachCycle() {
-  if (Runtime.hasTimeExpired(start_time_, timeout_) && potential_chord_size_ > 0) {
-    resolveOrArpeggiate();
-  }
-  return EventHandlerResult::OK;
+void Chord::onTimeoutDeadline() {
+  if (::Chord.potential_chord_size_ > 0)
+    ::Chord.resolveOrArpeggiate();
 }
 
 void Chord::setTimeout(uint8_t timeout) {
   timeout_ = timeout;
 }
 
+chord::KeyMask Chord::chordKeyMask(Key key) {
+  for (uint8_t i = 0; i < chord_key_count_; i++) {
+    if (cloneFromProgmem(chord_keys_[i]) == key)
+      return chord::KeyMask(1) << i;
+  }
+  return kOtherKeyBit;
+}
+
+// Finds the chords that could be made of the keys pressed so far: they all have
+// each of those keys, so it's enough to look at the chords of the key that is
+// in the fewest. Returns false if there are none.
+bool Chord::findCandidates(uint16_t &first, uint16_t &last) {
+  if (potential_chord_keys_ == 0 || (potential_chord_keys_ & kOtherKeyBit))
+    return false;
+
+  bool found = false;
+  for (uint8_t i = 0; i < chord_key_count_; i++) {
+    if (!(potential_chord_keys_ & (chord::KeyMask(1) << i)))
+      continue;
+    uint16_t begin = pgm_read_word(&candidate_offsets_[i]);
+    uint16_t end   = pgm_read_word(&candidate_offsets_[i + 1]);
+    if (!found || end - begin < last - first) {
+      first = begin;
+      last  = end;
+      found = true;
+    }
+  }
+  return found;
+}
+
 void Chord::resolveOrArpeggiate() {
   Key target_key = getChord();
   if (target_key == Key_NoKey) {
@@ -89,83 +119,36 @@ void Chord::resolveOrArpeggiate() {
 void Chord::resolve(Key target_key) {
   KeyEvent event        = potential_chord_[potential_chord_size_ - 1];
   potential_chord_size_ = 0;
+  potential_chord_keys_ = 0;
 
   KeyEventId stored_id    = event.id();
   KeyEvent restored_event = KeyEvent(event.addr, event.state, target_key, stored_id);
   Runtime.handleKeyEvent(restored_event);
 }
 
-bool Chord::inChord(uint8_t index, Key key) {
-  for (uint8_t i = index; index < chord_defs_size_ - 1; i++) {
-    Key chord_key = cloneFromProgmem(chord_defs_[i]);
-    if (chord_key == Key_NoKey) {
-      return false;
-    }
-    if (chord_key == key) {
-      return true;
-    }
-  }
-  return false;
-}
-
+// Whether the keys pressed so far are part of a chord that has more keys.
 bool Chord::isChordStrictSubset() {
-  uint8_t c = 0;
-  while (c < chord_defs_size_) {
-    uint8_t cs = chordSize(c);
-    if (isChordStrictSubsetOf(c, cs)) {
+  uint16_t first, last;
+  if (!findCandidates(first, last))
+    return false;
+  for (uint16_t i = first; i < last; i++) {
+    chord::KeyMask keys = cloneFromProgmem(chord_entries_[pgm_read_word(&candidates_[i])]).keys;
+    if ((potential_chord_keys_ & ~keys) == 0 && potential_chord_keys_ != keys)
       return true;
-    }
-    c += cs + 2;
   }
   return false;
 }
 
-bool Chord::isChordStrictSubsetOf(uint8_t c, uint8_t cs) {
-  if (cs <= potential_chord_size_) {
-    return false;
-  }
-  for (uint8_t i = 0; i < potential_chord_size_; i++) {
-    if (!inChord(c, potential_chord_[i].key)) {
-      return false;
-    }
-  }
-  return true;
-}
-
-uint8_t Chord::chordSize(uint8_t index) {
-  uint8_t size = 0;
-  uint8_t i    = index;
-  while (i < chord_defs_size_ - 1) {
-    Key key = cloneFromProgmem(chord_defs_[i]);
-    if (key == Key_NoKey) {
-      break;
-    }
-    size++;
-    i++;
-  }
-  return size;
-}
-
-bool Chord::isChord(uint8_t c, uint8_t cs) {
-  if (cs != potential_chord_size_) {
-    return false;
-  }
-  for (uint8_t i = 0; i < potential_chord_size_; i++) {
-    if (!inChord(c, potential_chord_[i].key)) {
-      return false;
-    }
-  }
-  return true;
-}
-
+// Returns the result of the first chord made of exactly the keys pressed so
+// far, or `Key_NoKey` if there isn't one.
 Key Chord::getChord() {
-  uint8_t c = 0;
-  while (c < chord_defs_size_) {
-    uint8_t cs = chordSize(c);
-    if (isChord(c, cs)) {
-      return cloneFromProgmem(chord_defs_[c + cs + 1]);
-    }
-    c += cs + 2;
+  uint16_t first, last;
+  if (!findCandidates(first, last))
+    return Key_NoKey;
+  for (uint16_t i = first; i < last; i++) {
+    chord::Entry entry = cloneFromProgmem(chord_entries_[pgm_read_word(&candidates_[i])]);
+    if (entry.keys == potential_chord_keys_)
+      return entry.result;
   }
   return Key_NoKey;
 }
@@ -174,9 +157,17 @@ void Chord::appendEvent(KeyEvent event) {
   if (potential_chord_size_ < kMaxChordSize) {
     potential_chord_[potential_chord_size_] = event;
     potential_chord_size_++;
+    potential_chord_keys_ |= chordKeyMask(event.key);
   }
 }
 
+void Chord::removeLastEvent() {
+  potential_chord_size_--;
+  potential_chord_keys_ = 0;
+  for (uint8_t i = 0; i < potential_chord_size_; i++)
+    potential_chord_keys_ |= chordKeyMask(potential_chord_[i].key);
+}
+
 void Chord::arpeggiate() {
   for (uint8_t i = 0; i < potential_chord_size_; i++) {
     KeyEvent event          = potential_chord_[i];
@@ -185,6 +176,7 @@ void Chord::arpeggiate() {
     Runtime.handleKeyEvent(restored_event);
   }
   potential_chord_size_ = 0;
+  potential_chord_keys_ = 0;
 }
 }  // namespace plugin
 }  // namespace kaleidoscope
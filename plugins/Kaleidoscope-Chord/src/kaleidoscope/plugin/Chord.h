@@ -24,6 +24,7 @@
 #include <Arduino.h>  // for PROGMEM
 #include <stdint.h>   // for uint8_t, uint16_t, int8_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
@@ -35,39 +36,358 @@
 
 namespace kaleidoscope {
 namespace plugin {
+
+namespace chord {
+
+// A set of chord keys, as a bitmask over the distinct keys used in chords (see
+// `Index::keys`).
+typedef uint32_t KeyMask;
+
+struct Entry {
+  KeyMask keys;
+  Key result;
+};
+
+// The index of a `CHORDS()` table, built at compile time and stored in PROGMEM.
+template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count>
+struct Index {
+  // The distinct keys used in chords; the one at index `i` is bit `i` of a
+  // `KeyMask`.
+  Key keys[_key_count];  // NOLINT(runtime/arrays)
+  // One entry per chord, in the order they were defined in
+  Entry chords[_chord_count];  // NOLINT(runtime/arrays)
+  // The chords that have key `i` among their keys are listed in `candidates`,
+  // from `offsets[i]` up to `offsets[i + 1]`, in the order they were defined in.
+  uint16_t offsets[_key_count + 1];       // NOLINT(runtime/arrays)
+  uint16_t candidates[_candidate_count];  // NOLINT(runtime/arrays)
+};
+
+// Everything below builds the index at compile time. The keys get their bits
+// in the order of their raw values.
+
+// A chord table, as written with `CHORDS()`: the keys of every chord, followed
+// by `Key_NoKey` and its result.
+struct Table {
+  const Key *keys;
+  uint16_t size;
+};
+
+constexpr bool isResult(Table t, uint16_t p) {
+  return p > 0 && t.keys[p - 1] == Key_NoKey;
+}
+
+typedef bool (*Predicate)(Table t, uint16_t p, uint16_t arg);
+
+constexpr bool isStart(Table t, uint16_t p, uint16_t = 0) {
+  return p == 0 || isResult(t, p - 1);
+}
+
+constexpr bool isChordKey(Table t, uint16_t p, uint16_t = 0) {
+  return !isResult(t, p) && t.keys[p] != Key_NoKey;
+}
+
+constexpr bool isEmptyEntry(Table t, uint16_t p, uint16_t = 0) {
+  return p > 0 && t.keys[p] == Key_NoKey && t.keys[p - 1] == Key_NoKey;
+}
+
+constexpr uint16_t chordLength(Table t, uint16_t p) {
+  return p >= t.size || t.keys[p] == Key_NoKey ? 0 : 1 + chordLength(t, p + 1);
+}
+
+constexpr bool isLongerThan(Table t, uint16_t p, uint16_t length) {
+  return isStart(t, p) && chordLength(t, p) > length;
+}
+
+// The searches below split their range in halves, to keep the recursion depth
+// well below the compiler's limit for large tables.
+
+// The number of positions in [lo, hi) for which `pred` holds
+constexpr uint16_t count(Predicate pred, Table t, uint16_t arg, uint16_t lo, uint16_t hi) {
+  return hi <= lo ? 0
+         : hi - lo == 1
+           ? uint16_t(pred(t, lo, arg))
+           : uint16_t(count(pred, t, arg, lo, lo + (hi - lo) / 2) +
+                      count(pred, t, arg, lo + (hi - lo) / 2, hi));
+}
+
+constexpr uint16_t selectSplit(Predicate pred, Table t, uint16_t arg, uint16_t n,
+                               uint16_t lo, uint16_t mid, uint16_t hi, uint16_t below);
+
+// The `n`th position (from 0) in [lo, hi) for which `pred` holds
+constexpr uint16_t select(Predicate pred, Table t, uint16_t arg, uint16_t n,
+                          uint16_t lo, uint16_t hi) {
+  return hi - lo <= 1 ? lo
+                      : selectSplit(pred, t, arg, n, lo, lo + (hi - lo) / 2, hi,
+                                    count(pred, t, arg, lo, lo + (hi - lo) / 2));
+}
+
+constexpr uint16_t selectSplit(Predicate pred, Table t, uint16_t arg, uint16_t n,
+                               uint16_t lo, uint16_t mid, uint16_t hi, uint16_t below) {
+  return n < below ? select(pred, t, arg, n, lo, mid)
+                   : select(pred, t, arg, n - below, mid, hi);
+}
+
+static constexpr uint32_t kNoKeyAbove = 0x10000;
+
+constexpr uint32_t lower(uint32_t a, uint32_t b) {
+  return a < b ? a : b;
+}
+
+// The lowest raw value of a chord key in [lo, hi) that is at least `floor`
+constexpr uint32_t lowestKey(Table t, uint32_t floor, uint16_t lo, uint16_t hi) {
+  return hi <= lo ? kNoKeyAbove
+         : hi - lo == 1
+           ? (isChordKey(t, lo) && t.keys[lo].getRaw() >= floor ? t.keys[lo].getRaw() : kNoKeyAbove)
+           : lower(lowestKey(t, floor, lo, lo + (hi - lo) / 2),
+                   lowestKey(t, floor, lo + (hi - lo) / 2, hi));
+}
+
+constexpr uint16_t keysFrom(Table t, uint32_t raw) {
+  return raw == kNoKeyAbove ? 0 : 1 + keysFrom(t, lowestKey(t, raw + 1, 0, t.size));
+}
+
+// The raw value of the key of bit `bit`
+constexpr uint16_t keyOfBit(Table t, uint8_t bit) {
+  return bit == 0 ? lowestKey(t, 0, 0, t.size)
+                  : lowestKey(t, keyOfBit(t, bit - 1) + 1, 0, t.size);
+}
+
+// A table must have at least one chord, and every chord at least one key and a
+// result.
+constexpr bool isValid(Table t) {
+  return t.size >= 3 &&
+         t.keys[0] != Key_NoKey &&
+         t.keys[t.size - 2] == Key_NoKey &&
+         count(isEmptyEntry, t, 0, 0, t.size) == 0;
+}
+
+constexpr uint16_t keyCount(Table t) {
+  return keysFrom(t, lowestKey(t, 0, 0, t.size));
+}
+
+constexpr uint16_t chordCount(Table t) {
+  return count(isStart, t, 0, 0, t.size);
+}
+
+constexpr uint16_t candidateCount(Table t) {
+  return count(isChordKey, t, 0, 0, t.size);
+}
+
+constexpr uint16_t longestChord(Table t, uint16_t length = 0) {
+  return count(isLongerThan, t, length, 0, t.size) == 0 ? length : longestChord(t, length + 1);
+}
+
+template<uint16_t... _indices>
+struct Indices {};
+
+template<uint16_t _count, uint16_t... _indices>
+struct MakeIndices : MakeIndices<_count - 1, _count - 1, _indices...> {};
+
+template<uint16_t... _indices>
+struct MakeIndices<0, _indices...> {
+  typedef Indices<_indices...> type;
+};
+
+// The index is built in stages, each computed once and handed to the next, so
+// that no value is computed more than once.
+
+static constexpr uint8_t kNoBit = 0xff;
+
+// The raw values of the keys, by bit
+template<uint8_t _key_count>
+struct Keys {
+  uint16_t raw[_key_count];  // NOLINT(runtime/arrays)
+};
+
+// For every position in the table, the bit of the chord key at it, or `kNoBit`
+// (for the `Key_NoKey` after the keys of a chord, and its result)
+template<uint16_t _size>
+struct KeyBits {
+  uint8_t bit[_size];  // NOLINT(runtime/arrays)
+};
+
+// Where the candidates of every key start in `Index::candidates`
+template<uint8_t _key_count>
+struct Offsets {
+  uint16_t offset[_key_count + 1];  // NOLINT(runtime/arrays)
+};
+
+template<uint8_t _key_count, uint16_t... _bits>
+constexpr Keys<_key_count> makeKeys(Table t, Indices<_bits...>) {
+  return Keys<_key_count>{{keyOfBit(t, _bits)...}};
+}
+
+template<uint8_t _key_count>
+constexpr uint8_t bitOf(const Keys<_key_count> &k, uint16_t raw, uint8_t bit = 0) {
+  return bit >= _key_count || k.raw[bit] == raw ? bit : bitOf(k, raw, bit + 1);
+}
+
+template<uint16_t _size, uint8_t _key_count, uint16_t... _positions>
+constexpr KeyBits<_size> makeKeyBits(Table t, const Keys<_key_count> &k, Indices<_positions...>) {
+  return KeyBits<_size>{{(isChordKey(t, _positions)
+                            ? bitOf(k, t.keys[_positions].getRaw())
+                            : kNoBit)...}};
+}
+
+// The number of positions in [lo, hi) with a key whose bit is below `bit`
+// (`below == true`) or equal to it
+template<uint16_t _size>
+constexpr uint16_t countBits(const KeyBits<_size> &b, uint8_t bit, bool below,
+                             uint16_t lo, uint16_t hi) {
+  return hi <= lo ? 0
+         : hi - lo == 1 ? uint16_t(below ? b.bit[lo] < bit : b.bit[lo] == bit)
+                        : uint16_t(countBits(b, bit, below, lo, lo + (hi - lo) / 2) +
+                                   countBits(b, bit, below, lo + (hi - lo) / 2, hi));
+}
+
+template<uint16_t _size>
+constexpr uint16_t selectBitSplit(const KeyBits<_size> &b, uint8_t bit, uint16_t n,
+                                  uint16_t lo, uint16_t mid, uint16_t hi, uint16_t below);
+
+// The `n`th position (from 0) in [lo, hi) with the key of bit `bit`
+template<uint16_t _size>
+constexpr uint16_t selectBit(const KeyBits<_size> &b, uint8_t bit, uint16_t n,
+                             uint16_t lo, uint16_t hi) {
+  return hi - lo <= 1 ? lo
+                      : selectBitSplit(b, bit, n, lo, lo + (hi - lo) / 2, hi,
+                                       countBits(b, bit, false, lo, lo + (hi - lo) / 2));
+}
+
+template<uint16_t _size>
+constexpr uint16_t selectBitSplit(const KeyBits<_size> &b, uint8_t bit, uint16_t n,
+                                  uint16_t lo, uint16_t mid, uint16_t hi, uint16_t below) {
+  return n < below ? selectBit(b, bit, n, lo, mid)
+                   : selectBit(b, bit, n - below, mid, hi);
+}
+
+template<uint8_t _key_count, uint16_t _size, uint16_t... _bits>
+constexpr Offsets<_key_count> makeOffsets(const KeyBits<_size> &b, Indices<_bits...>) {
+  return Offsets<_key_count>{{countBits(b, _bits, true, 0, _size)...}};
+}
+
+template<uint16_t _size>
+constexpr KeyMask maskFrom(const KeyBits<_size> &b, uint16_t p) {
+  return p >= _size || b.bit[p] == kNoBit ? 0 : (KeyMask(1) << b.bit[p]) | maskFrom(b, p + 1);
+}
+
+constexpr Key resultFrom(Table t, uint16_t p) {
+  return p + 1 >= t.size ? Key_NoKey
+         : t.keys[p] == Key_NoKey ? t.keys[p + 1]
+                                  : resultFrom(t, p + 1);
+}
+
+template<uint16_t _size>
+constexpr Entry entryAt(Table t, const KeyBits<_size> &b, uint16_t start) {
+  return Entry{maskFrom(b, start), resultFrom(t, start)};
+}
+
+// The key among whose candidates the `n`th one is
+template<uint8_t _key_count>
+constexpr uint8_t candidateBit(const Offsets<_key_count> &o, uint16_t n, uint8_t bit = 0) {
+  return o.offset[bit + 1] > n ? bit : candidateBit(o, n, bit + 1);
+}
+
+// The chord of the `n`th candidate, which is among those of key `bit`
+template<uint8_t _key_count, uint16_t _size>
+constexpr uint16_t candidateOf(Table t, const KeyBits<_size> &b, const Offsets<_key_count> &o,
+                               uint16_t n, uint8_t bit) {
+  return count(isStart, t, 0, 0, selectBit(b, bit, n - o.offset[bit], 0, _size) + 1) - 1;
+}
+
+template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count, uint16_t _size,
+         uint16_t... _keys, uint16_t... _chords, uint16_t... _offsets, uint16_t... _candidates>
+constexpr Index<_key_count, _chord_count, _candidate_count> makeIndex(
+  Table t, const Keys<_key_count> &k, const KeyBits<_size> &b, const Offsets<_key_count> &o,
+  Indices<_keys...>, Indices<_chords...>, Indices<_offsets...>, Indices<_candidates...>) {
+  return Index<_key_count, _chord_count, _candidate_count>{
+    {Key(k.raw[_keys])...},
+    {entryAt(t, b, select(isStart, t, 0, _chords, 0, t.size))...},
+    {o.offset[_offsets]...},
+    {candidateOf(t, b, o, _candidates, candidateBit(o, _candidates))...}};
+}
+
+template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count, uint16_t _size>
+constexpr Index<_key_count, _chord_count, _candidate_count> makeIndex(
+  Table t, const Keys<_key_count> &k, const KeyBits<_size> &b) {
+  return makeIndex<_key_count, _chord_count, _candidate_count>(
+    t, k, b,
+    makeOffsets<_key_count>(b, typename MakeIndices<_key_count + 1>::type()),
+    typename MakeIndices<_key_count>::type(),
+    typename MakeIndices<_chord_count>::type(),
+    typename MakeIndices<_key_count + 1>::type(),
+    typename MakeIndices<_candidate_count>::type());
+}
+
+template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count, uint16_t _size>
+constexpr Index<_key_count, _chord_count, _candidate_count> makeIndex(Table t,
+                                                                      const Keys<_key_count> &k) {
+  return makeIndex<_key_count, _chord_count, _candidate_count>(
+    t, k, makeKeyBits<_size>(t, k, typename MakeIndices<_size>::type()));
+}
+
+template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count, uint16_t _size>
+constexpr Index<_key_count, _chord_count, _candidate_count> makeIndex(const Key (&keys)[_size]) {
+  return makeIndex<_key_count, _chord_count, _candidate_count, _size>(
+    Table{keys, _size},
+    makeKeys<_key_count>(Table{keys, _size}, typename MakeIndices<_key_count>::type()));
+}
+
+}  // namespace chord
+
+
 class Chord : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
   void setTimeout(uint8_t timeout);
 
-  template<uint8_t _chord_defs_size>
-  void configure(Key const (&chords)[_chord_defs_size]) {
-    chord_defs_      = chords;
-    chord_defs_size_ = _chord_defs_size;
+  // The most distinct keys that chords can be made of, in total
+  static constexpr uint8_t kMaxChordKeys{31};
+  // The most keys a single chord can be made of
+  static constexpr uint8_t kMaxChordSize{10};
+
+  // Uses the chords of an index built by `CHORDS()`.
+  template<uint8_t _key_count, uint16_t _chord_count, uint16_t _candidate_count>
+  void configure(const chord::Index<_key_count, _chord_count, _candidate_count> &index) {
+    static_assert(_key_count <= kMaxChordKeys,
+                  "Chords can't use more than Chord::kMaxChordKeys distinct keys");
+    chord_keys_        = index.keys;
+    chord_key_count_   = _key_count;
+    chord_entries_     = index.chords;
+    candidate_offsets_ = index.offsets;
+    candidates_        = index.candidates;
   }
 
  private:
+  chord::KeyMask chordKeyMask(Key key);
+  bool findCandidates(uint16_t &first, uint16_t &last);
   void resolveOrArpeggiate();
   void resolve(Key target_key);
-  bool inChord(uint8_t index, Key key);
   bool isChordStrictSubset();
-  bool isChordStrictSubsetOf(uint8_t c, uint8_t cs);
-  uint8_t chordSize(uint8_t index);
-  bool isChord(uint8_t c, uint8_t cs);
   Key getChord();
   void appendEvent(KeyEvent event);
+  void removeLastEvent();
   void arpeggiate();
+  static void onTimeoutDeadline();
 
   KeyEventTracker event_tracker_;
   uint16_t start_time_;
+  // Expires when the keys pressed so far have waited the timeout for the rest
+  // of a chord
+  Deadline timeout_deadline_{onTimeoutDeadline};
 
-  static constexpr uint8_t kMaxChordSize{10};
   KeyEvent potential_chord_[kMaxChordSize];
   uint8_t potential_chord_size_{0};
+  // The keys of `potential_chord_`
+  chord::KeyMask potential_chord_keys_{0};
 
-  Key const *chord_defs_{nullptr};
-  uint8_t chord_defs_size_{0};
+  // The index set with `configure()`, in PROGMEM. The one remaining bit of a
+  // `KeyMask` stands for any key that isn't used in chords, which no chord has.
+  const Key *chord_keys_{nullptr};
+  uint8_t chord_key_count_{0};
+  static constexpr chord::KeyMask kOtherKeyBit{chord::KeyMask(1) << kMaxChordKeys};
+  const chord::Entry *chord_entries_{nullptr};
+  const uint16_t *candidate_offsets_{nullptr};
+  const uint16_t *candidates_{nullptr};
 
   uint8_t timeout_ = 50;
 };
@@ -76,9 +396,29 @@ class Chord : public kaleidoscope::Plugin {
 
 extern kaleidoscope::plugin::Chord Chord;
 
-#define CHORDS(chord_defs...)                            \
-  {                                                      \
-    static Key const chord_def[] PROGMEM = {chord_defs}; \
-    Chord.configure(chord_def);                          \
+// Defines the chords, and builds their index at compile time. Tables that the
+// plugin can't use are rejected with a compile error.
+#define CHORDS(chord_defs...)                                                      \
+  {                                                                                \
+    static constexpr Key chord_def[] PROGMEM = {chord_defs};                       \
+    static constexpr kaleidoscope::plugin::chord::Table chord_table{               \
+      chord_def, sizeof(chord_def) / sizeof(chord_def[0])};                        \
+    static_assert(kaleidoscope::plugin::chord::isValid(chord_table),               \
+                  "Every chord needs at least one key, and a result");             \
+    static_assert(kaleidoscope::plugin::chord::keyCount(chord_table) <=            \
+                    kaleidoscope::plugin::Chord::kMaxChordKeys,                    \
+                  "Chords can't use more than Chord::kMaxChordKeys keys");        \
+    static_assert(kaleidoscope::plugin::chord::longestChord(chord_table) <=        \
+                    kaleidoscope::plugin::Chord::kMaxChordSize,                    \
+                  "A chord can't have more than Chord::kMaxChordSize keys");       \
+    static constexpr kaleidoscope::plugin::chord::Index<                           \
+      kaleidoscope::plugin::chord::keyCount(chord_table),                          \
+      kaleidoscope::plugin::chord::chordCount(chord_table),                        \
+      kaleidoscope::plugin::chord::candidateCount(chord_table)>                    \
+      chord_index PROGMEM = kaleidoscope::plugin::chord::makeIndex<                \
+        kaleidoscope::plugin::chord::keyCount(chord_table),                        \
+        kaleidoscope::plugin::chord::chordCount(chord_table),                      \
+        kaleidoscope::plugin::chord::candidateCount(chord_table)>(chord_def);      \
+    Chord.configure(chord_index);                                                  \
   }
 #define CHORD(chord_keys...) chord_keys, Key_NoKey
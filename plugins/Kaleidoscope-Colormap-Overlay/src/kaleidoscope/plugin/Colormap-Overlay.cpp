@@ -25,6 +25,7 @@
 #include <stdint.h>  // for uint8_t
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr, MatrixAddr, MatrixAddr<>::...
+#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"         // for cRGB, CRGB
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerRes...
 #include "kaleidoscope/key_defs.h"              // for Key, KEY_FLAGS, Key_NoKey, LockLayer
@@ -60,26 +61,39 @@ bool ColormapOverlay::hasOverlay(KeyAddr k) {
 }
 
 EventHandlerResult ColormapOverlay::onSetup() {
+  ::LEDControl.addLayer(*this);
+  updateCoverage();
   return EventHandlerResult::OK;
 }
 
-void ColormapOverlay::setLEDOverlayColors() {
+EventHandlerResult ColormapOverlay::onLayerChange() {
+  updateCoverage();
+  return EventHandlerResult::OK;
+}
+
+// Which overlays apply depends only on the layer state, so the layer covers
+// the same keys until it changes. Their colors may change with it, too.
+void ColormapOverlay::updateCoverage() {
   if (!Runtime.has_leds)
     return;
 
   for (auto key_addr : KeyAddr::all()) {
-    if (ColormapOverlay::hasOverlay(key_addr)) {
-      ::LEDControl.setCrgbAt(KeyAddr(key_addr), selectedColor);
+    if (hasOverlay(key_addr)) {
+      cover(key_addr);
+      refresh(key_addr);
     } else {
-      ::LEDControl.refreshAt(KeyAddr(key_addr));
+      uncover(key_addr);
     }
   }
 }
 
-EventHandlerResult ColormapOverlay::beforeSyncingLeds() {
-  setLEDOverlayColors();
-
-  return EventHandlerResult::OK;
+cRGB ColormapOverlay::colorAt(uint8_t led_index) {
+  for (uint8_t i{0}; i < overlay_count_; ++i) {
+    KeyAddr k = overlays_[i].addr;
+    if (Runtime.device().getLedIndex(k) == led_index && hasOverlay(k))
+      return selectedColor;
+  }
+  return CRGB(0, 0, 0);
 }
 
 }  // namespace plugin
@@ -24,13 +24,14 @@
 
 #include <stdint.h>  // for uint8_t
 
-#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
-#include "kaleidoscope/device/device.h"         // for cRGB
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/key_defs.h"              // for Key, KEY_FLAGS, Key_NoKey, LockLayer
-#include "kaleidoscope/layers.h"                // for Layer, Layer_
-#include "kaleidoscope/plugin/LEDControl.h"     // for LEDControl
-#include <Kaleidoscope-LED-Palette-Theme.h>     // for LEDPaletteTheme
+#include "kaleidoscope/KeyAddr.h"                     // for KeyAddr
+#include "kaleidoscope/device/device.h"               // for cRGB
+#include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult
+#include "kaleidoscope/key_defs.h"                    // for Key, KEY_FLAGS, Key_NoKey, LockLayer
+#include "kaleidoscope/layers.h"                      // for Layer, Layer_
+#include "kaleidoscope/plugin/LEDControl.h"           // for LEDControl
+#include "kaleidoscope/plugin/LEDControl/LEDLayer.h"  // for LEDLayer
+#include <Kaleidoscope-LED-Palette-Theme.h>           // for LEDPaletteTheme
 
 namespace kaleidoscope {
 namespace plugin {
@@ -51,7 +52,8 @@ struct Overlay {
     : layer(layer), addr(k), palette_index(palette_index) {}
 };
 
-class ColormapOverlay : public kaleidoscope::Plugin {
+class ColormapOverlay : public kaleidoscope::Plugin,
+                        public LEDLayer {
  public:
   static void setup();
   // Function for defining the array of overlays. It's a template function that
@@ -73,6 +75,7 @@ class ColormapOverlay : public kaleidoscope::Plugin {
 
     overlays_      = new_overlays;
     overlay_count_ = _overlay_count;
+    updateCoverage();
   }
 
   template<uint8_t _layer_count>
@@ -112,13 +115,16 @@ class ColormapOverlay : public kaleidoscope::Plugin {
     // Update member variables
     overlays_      = new_overlays;
     overlay_count_ = count;
+    updateCoverage();
   }
   // A wildcard value for an overlay that applies on every layer.
   static constexpr int8_t layer_wildcard{-1};
   static constexpr int8_t no_color_overlay{-1};
 
   EventHandlerResult onSetup();
-  EventHandlerResult beforeSyncingLeds();
+  EventHandlerResult onLayerChange();
+
+  cRGB colorAt(uint8_t led_index) final;
 
   ~ColormapOverlay() {
     if (overlays_ != nullptr) {
@@ -132,7 +138,7 @@ class ColormapOverlay : public kaleidoscope::Plugin {
   cRGB selectedColor;
 
   bool hasOverlay(KeyAddr k);
-  void setLEDOverlayColors();
+  void updateCoverage();
 };
 
 // clang-format off
@@ -22,17 +22,35 @@
 
 #include "kaleidoscope/plugin/CycleTimeReport.h"
 
-#include <Arduino.h>                   // for micros, F, __FlashStringHelper
+#include <Arduino.h>                   // for micros, F, PSTR, __FlashStringHelper
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
-#include <stdint.h>                    // for uint16_t, uint32_t
+#include <stdint.h>                    // for uint8_t, uint16_t, uint32_t
+#include <string.h>                    // for memset
 
-#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/Runtime.h"                       // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"                 // for Device
+#include "kaleidoscope/driver/i2c/Telemetry.h"          // for Telemetry
+#include "kaleidoscope/driver/keyscanner/ScanTiming.h"  // for ScanTiming
+#include "kaleidoscope/event_handler_result.h"          // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope_internal/hook_profiler.h"        // for hook_stats, plugin_count, hook_count, ...
+#include "kaleidoscope_internal/latency_trace.h"        // for sample, sampleCount, Sample
 
 namespace kaleidoscope {
 namespace plugin {
 
 EventHandlerResult CycleTimeReport::beforeEachCycle() {
+  // The time since the start of the previous cycle goes into the histogram.
+  uint32_t now = micros();
+  if (last_cycle_start_ != 0) {
+    recordCycleTime(now - last_cycle_start_);
+    if (idle_cycle_)
+      recordIdleCycle(now - last_cycle_start_);
+  }
+  last_cycle_start_ = now;
+  // Cycles that start with no keys held count as idle, to show how much time
+  // the keyboard spends (or saves) between keystrokes.
+  idle_cycle_ = Runtime.device().pressedKeyswitchCount() == 0;
+
   // A counter storing the number of cycles since the last mean cycle time
   // report was sent:
   static uint16_t elapsed_cycles = 0;
@@ -56,6 +74,178 @@ EventHandlerResult CycleTimeReport::beforeEachCycle() {
   return EventHandlerResult::OK;
 }
 
+void CycleTimeReport::recordCycleTime(uint32_t cycle_time) {
+  uint8_t bucket = 0;
+  for (uint32_t t = cycle_time; t > 1 && bucket < histogram_buckets - 1; t >>= 1)
+    ++bucket;
+  ++histogram_[bucket];
+
+  if (cycle_count_ == 0 || cycle_time < min_cycle_time_)
+    min_cycle_time_ = cycle_time;
+  if (cycle_time > max_cycle_time_)
+    max_cycle_time_ = cycle_time;
+  ++cycle_count_;
+}
+
+void CycleTimeReport::recordIdleCycle(uint32_t cycle_time) {
+  ++idle_cycles_;
+  // Idle time is kept in seconds and microseconds, because a 32-bit count of
+  // microseconds overflows after about 71 minutes.
+  idle_micros_ += cycle_time;
+  while (idle_micros_ >= 1000000) {
+    idle_micros_ -= 1000000;
+    ++idle_seconds_;
+  }
+}
+
+uint32_t CycleTimeReport::idleCyclesPerSecond() const {
+  uint64_t idle_millis = uint64_t(idle_seconds_) * 1000 + idle_micros_ / 1000;
+  if (idle_millis == 0)
+    return 0;
+  return uint64_t(idle_cycles_) * 1000 / idle_millis;
+}
+
+uint32_t CycleTimeReport::percentileCycleTime(uint8_t percent) const {
+  // The number of cycles that have to be at or below the percentile, rounded up
+  uint32_t threshold = cycle_count_ - (cycle_count_ * (100 - percent)) / 100;
+  uint32_t cycles    = 0;
+  for (uint8_t bucket = 0; bucket < histogram_buckets - 1; ++bucket) {
+    cycles += histogram_[bucket];
+    if (cycles >= threshold) {
+      uint32_t bucket_top = (uint32_t(2) << bucket) - 1;
+      return bucket_top < max_cycle_time_ ? bucket_top : max_cycle_time_;
+    }
+  }
+  return max_cycle_time_;
+}
+
+void CycleTimeReport::resetStats() {
+  cycle_count_    = 0;
+  min_cycle_time_ = 0;
+  max_cycle_time_ = 0;
+  memset(histogram_, 0, sizeof(histogram_));
+  idle_cycles_  = 0;
+  idle_seconds_ = 0;
+  idle_micros_  = 0;
+  // Don't count the cycle that did the reset.
+  last_cycle_start_ = 0;
+
+  kaleidoscope_internal::hook_profiler::reset();
+  kaleidoscope_internal::latency_trace::reset();
+
+  driver::i2c::Telemetry *telemetry;
+  for (uint8_t n = 0; (telemetry = Runtime.device().i2cTelemetry(n)) != nullptr; ++n)
+    telemetry->reset();
+
+  Runtime.device().resetScanTiming();
+}
+
+EventHandlerResult CycleTimeReport::onFocusEvent(const char *input) {
+  namespace hook_profiler = kaleidoscope_internal::hook_profiler;
+  namespace latency_trace = kaleidoscope_internal::latency_trace;
+
+  const char *cmd_histogram = PSTR("cycletime.histogram");
+  const char *cmd_hooks     = PSTR("cycletime.hooks");
+  const char *cmd_i2c       = PSTR("cycletime.i2c");
+  const char *cmd_idle      = PSTR("cycletime.idle");
+  const char *cmd_latency   = PSTR("cycletime.latency");
+  const char *cmd_reset     = PSTR("cycletime.reset");
+  const char *cmd_scan      = PSTR("cycletime.scan");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_histogram, cmd_hooks, cmd_i2c, cmd_idle, cmd_latency, cmd_reset, cmd_scan);
+
+  if (::Focus.inputMatchesCommand(input, cmd_histogram)) {
+    // First line: cycle count, min, max & p99 cycle times; then one line per
+    // bucket: its lowest cycle time, and its count.
+    ::Focus.send(cycle_count_, min_cycle_time_, max_cycle_time_, percentileCycleTime(99));
+    for (uint8_t bucket = 0; bucket < histogram_buckets; ++bucket) {
+      ::Focus.sendRaw(::Focus.NEWLINE);
+      ::Focus.send(bucket == 0 ? 0 : uint32_t(1) << bucket, histogram_[bucket]);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_hooks)) {
+    // One line for each profiled hook that has been called: hook name, `all`,
+    // calls, total time & max time; followed by a line in the same format for
+    // each plugin that handled it. Empty unless the sketch was built with
+    // `KALEIDOSCOPE_HOOK_PROFILING`.
+    if (hook_profiler::plugin_count == 0)
+      return EventHandlerResult::EVENT_CONSUMED;
+
+    bool first_line = true;
+    for (uint8_t hook = 0; hook < hook_profiler::hook_count; ++hook) {
+      for (uint8_t row = 0; row <= hook_profiler::plugin_count; ++row) {
+        const hook_profiler::Stats &stats = hook_profiler::hook_stats[row][hook];
+        if (stats.calls == 0)
+          continue;
+        if (!first_line)
+          ::Focus.sendRaw(::Focus.NEWLINE);
+        first_line = false;
+        ::Focus.send(hook_profiler::name(hook_profiler::hook_names, hook));
+        if (row == 0) {
+          ::Focus.send(F("all"));
+        } else {
+          ::Focus.send(hook_profiler::name(hook_profiler::plugin_names, row - 1));
+        }
+        ::Focus.send(stats.calls, stats.total_time, stats.max_time);
+      }
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_i2c)) {
+    // One line per device on the keyboard's I2C bus (such as the two halves of
+    // a split keyboard): scan cycles, transactions, bytes, NACKs, total time on
+    // the bus, and the most time spent on it in one cycle. Empty if the keyboard
+    // doesn't keep I2C statistics.
+    driver::i2c::Telemetry *telemetry;
+    for (uint8_t n = 0; (telemetry = Runtime.device().i2cTelemetry(n)) != nullptr; ++n) {
+      if (n > 0)
+        ::Focus.sendRaw(::Focus.NEWLINE);
+      ::Focus.send(telemetry->cycles, telemetry->transactions, telemetry->bytes,
+                   telemetry->nacks, telemetry->bus_time, telemetry->max_cycle_bus_time);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_idle)) {
+    // Idle cycles, the time they took in milliseconds, and cycles per second
+    ::Focus.send(idle_cycles_, idle_seconds_ * 1000 + idle_micros_ / 1000, idleCyclesPerSecond());
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_latency)) {
+    // One line per traced key event, oldest first: row, col, 1 for a press or
+    // 0 for a release, and the latency. Empty unless the sketch was built with
+    // `KALEIDOSCOPE_LATENCY_TRACING`.
+    for (uint8_t i = 0; i < latency_trace::sampleCount(); ++i) {
+      const latency_trace::Sample &sample = latency_trace::sample(i);
+      if (i > 0)
+        ::Focus.sendRaw(::Focus.NEWLINE);
+      ::Focus.send(sample.row, sample.col, sample.pressed ? 1 : 0, sample.latency);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_reset)) {
+    resetStats();
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_scan)) {
+    // Matrix scans, and their mean and longest duration in CPU cycles. Empty
+    // unless the key scanner times its scans.
+    driver::keyscanner::ScanTiming scan_timing;
+    if (Runtime.device().scanTiming(scan_timing))
+      ::Focus.send(scan_timing.scans, scan_timing.meanCycles(), scan_timing.max_cycles);
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  return EventHandlerResult::OK;
+}
+
 __attribute__((weak)) void CycleTimeReport::report(uint16_t mean_cycle_time) {
   Focus.send(Focus.COMMENT,
              F("mean cycle time:"),
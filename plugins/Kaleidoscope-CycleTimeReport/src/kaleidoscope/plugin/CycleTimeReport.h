@@ -22,9 +22,10 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint16_t, uint32_t
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
 
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/focus_commands.h"        // for KALEIDOSCOPE_FOCUS_COMMANDS
 #include "kaleidoscope/plugin.h"                // for Plugin
 // -----------------------------------------------------------------------------
 // Deprecation warning messages
@@ -41,6 +42,14 @@ namespace plugin {
 class CycleTimeReport : public kaleidoscope::Plugin {
  public:
   EventHandlerResult beforeEachCycle();
+  KALEIDOSCOPE_FOCUS_COMMANDS("cycletime.histogram",
+                              "cycletime.hooks",
+                              "cycletime.i2c",
+                              "cycletime.idle",
+                              "cycletime.latency",
+                              "cycletime.reset",
+                              "cycletime.scan")
+  EventHandlerResult onFocusEvent(const char *input);
 
 #ifndef NDEPRECATED
   DEPRECATED(CYCLETIMEREPORT_AVG_TIME)
@@ -55,6 +64,25 @@ class CycleTimeReport : public kaleidoscope::Plugin {
   /// Report the given mean cycle time in microseconds
   void report(uint16_t mean_cycle_time);
 
+  /// Clear the cycle time histogram, the idle cycle statistics, the hook
+  /// timing statistics, the latency trace, the I2C bus statistics, and the
+  /// matrix scan timing
+  void resetStats();
+
+  /// Returns the number of main loop iterations per second while no keys were
+  /// held, since the last reset
+  uint32_t idleCyclesPerSecond() const;
+
+  /// Returns the cycle time (in microseconds) that `percent` percent of the
+  /// cycles since the last reset didn't exceed, rounded up to the top of its
+  /// histogram bucket.
+  uint32_t percentileCycleTime(uint8_t percent) const;
+
+  // The cycle time histogram has one bucket per power of two: bucket `i` counts
+  // the cycles that took at least 2^i µs (but less than 2^(i+1) µs, except in
+  // the last bucket, which counts all the longer ones, too).
+  static constexpr uint8_t histogram_buckets = 16;
+
  private:
   // Interval between reports, in milliseconds
   uint16_t report_interval_ = 1000;
@@ -62,6 +90,22 @@ class CycleTimeReport : public kaleidoscope::Plugin {
   // Timestamps recording when the last report was sent
   uint16_t last_report_millis_ = 0;
   uint32_t last_report_micros_ = 0;
+
+  // Cycle time statistics since the last reset, in microseconds
+  uint32_t last_cycle_start_ = 0;
+  uint32_t cycle_count_      = 0;
+  uint32_t min_cycle_time_   = 0;
+  uint32_t max_cycle_time_   = 0;
+  uint32_t histogram_[histogram_buckets] = {};
+
+  // The number and total length of the cycles that started with no keys held
+  bool idle_cycle_       = false;
+  uint32_t idle_cycles_  = 0;
+  uint32_t idle_seconds_ = 0;
+  uint32_t idle_micros_  = 0;
+
+  void recordCycleTime(uint32_t cycle_time);
+  void recordIdleCycle(uint32_t cycle_time);
 };
 
 }  // namespace plugin
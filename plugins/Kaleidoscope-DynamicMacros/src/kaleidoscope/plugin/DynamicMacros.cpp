@@ -22,7 +22,7 @@
 
 #include "kaleidoscope/plugin/DynamicMacros.h"
 
-#include <Arduino.h>                   // for delay, PSTR, F, __FlashStri...
+#include <Arduino.h>                   // for PSTR, F, __FlashStringHelper
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <Kaleidoscope-Ranges.h>       // for DYNAMIC_MACRO_FIRST, DYNAMIC_MACRO_LAST
 
@@ -103,93 +103,13 @@ uint8_t DynamicMacros::updateDynamicMacroCache() {
 
 // public
 void DynamicMacros::play(uint8_t macro_id) {
-  macro_t macro    = MACRO_ACTION_END;
-  uint8_t interval = 0;
-  uint16_t pos;
-  Key key;
-
   // If the requested ID is higher than the number of macros we found during the
   // cache update, bail out. Our map beyond `macro_count_` is unreliable.
   if (macro_id >= macro_count_)
     return;
 
-  auto &storage = Runtime.storage();
-  // Define a lambda function for common key operations to reduce redundancy
-  auto setKeyAndAction = [this, &key, &macro, &pos]() {
-    // Keycode variants of actions don't have flags to set, but we want to make sure
-    // we're still initializing them properly.
-
-    key.setFlags((macro == MACRO_ACTION_STEP_KEYCODEDOWN || macro == MACRO_ACTION_STEP_KEYCODEUP || macro == MACRO_ACTION_STEP_TAPCODE) ? 0
-                                                                                                                                        : Runtime.storage().read(pos++));
-
-    key.setKeyCode(Runtime.storage().read(pos++));
-
-    switch (macro) {
-    case MACRO_ACTION_STEP_KEYCODEDOWN:
-    case MACRO_ACTION_STEP_KEYDOWN:
-      this->press(key);
-      break;
-    case MACRO_ACTION_STEP_KEYCODEUP:
-    case MACRO_ACTION_STEP_KEYUP:
-      this->release(key);
-      break;
-    case MACRO_ACTION_STEP_TAP:
-    case MACRO_ACTION_STEP_TAPCODE:
-      this->tap(key);
-      break;
-    default:
-      break;
-    }
-  };
-
-
-  pos = storage_base_ + map_[macro_id];
-
-  while (pos < storage_base_ + storage_size_) {
-    switch (macro = Runtime.storage().read(pos++)) {
-    case MACRO_ACTION_STEP_EXPLICIT_REPORT:
-    case MACRO_ACTION_STEP_IMPLICIT_REPORT:
-    case MACRO_ACTION_STEP_SEND_REPORT:
-      break;
-
-    case MACRO_ACTION_STEP_INTERVAL:
-      interval = Runtime.storage().read(pos++);
-      break;
-    case MACRO_ACTION_STEP_WAIT: {
-      uint8_t wait = Runtime.storage().read(pos++);
-      delay(wait);
-      break;
-    }
-
-    case MACRO_ACTION_STEP_KEYDOWN:
-    case MACRO_ACTION_STEP_KEYUP:
-    case MACRO_ACTION_STEP_TAP:
-    case MACRO_ACTION_STEP_KEYCODEUP:
-    case MACRO_ACTION_STEP_TAPCODE:
-    case MACRO_ACTION_STEP_KEYCODEDOWN:
-      setKeyAndAction();
-      break;
-
-    case MACRO_ACTION_STEP_TAP_SEQUENCE:
-    case MACRO_ACTION_STEP_TAP_CODE_SEQUENCE: {
-      bool isKeycodeSequence = macro == MACRO_ACTION_STEP_TAP_CODE_SEQUENCE;
-      while (true) {
-        key.setFlags(isKeycodeSequence ? 0 : storage.read(pos++));
-        key.setKeyCode(storage.read(pos++));
-        if (key == Key_NoKey || pos >= storage_base_ + storage_size_)
-          break;
-        tap(key);
-        delay(interval);
-      }
-      break;
-    }
-    case MACRO_ACTION_END:
-    default:
-      return;
-    }
-
-    delay(interval);
-  }
+  ::MacroSupport.playFromStorage(storage_base_ + map_[macro_id],
+                                 storage_base_ + storage_size_);
 }
 
 bool isDynamicMacrosKey(Key key) {
@@ -207,7 +127,7 @@ EventHandlerResult DynamicMacros::onKeyEvent(KeyEvent &event) {
     uint8_t macro_id = event.key.getRaw() - ranges::DYNAMIC_MACRO_FIRST;
     play(macro_id);
   } else {
-    clear();
+    ::MacroSupport.clearWhenDone();
   }
 
   return EventHandlerResult::EVENT_CONSUMED;
@@ -234,11 +154,18 @@ EventHandlerResult DynamicMacros::onFocusEvent(const char *input) {
     } else {
       uint16_t pos = 0;
 
-      while (!::Focus.isEOL() && pos < storage_size_) {
-        uint8_t b;
-        ::Focus.read(b);
+      // Don't keep playing a sequence we're about to overwrite.
+      ::MacroSupport.abort();
+
+      if (::Focus.isBinary()) {
+        ::Focus.receiveFramesIntoStorage(storage_base_, storage_size_);
+      } else {
+        while (!::Focus.isEOL() && pos < storage_size_) {
+          uint8_t b;
+          ::Focus.read(b);
 
-        Runtime.storage().update(storage_base_ + pos++, b);
+          Runtime.storage().update(storage_base_ + pos++, b);
+        }
       }
       Runtime.storage().commit();
       macro_count_ = updateDynamicMacroCache();
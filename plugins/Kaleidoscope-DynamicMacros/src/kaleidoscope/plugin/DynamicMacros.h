@@ -45,6 +45,9 @@ class DynamicMacros : public kaleidoscope::Plugin {
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult beforeEachCycle() {
+    return ::MacroSupport.beforeEachCycle();
+  }
   EventHandlerResult beforeReportingState(const KeyEvent &event) {
     return ::MacroSupport.beforeReportingState(event);
   }
@@ -61,10 +64,6 @@ class DynamicMacros : public kaleidoscope::Plugin {
   uint8_t macro_count_;
   uint8_t updateDynamicMacroCache();
 
-  inline void press(Key key) { ::MacroSupport.press(key); }
-  inline void release(Key key) { ::MacroSupport.release(key); }
-  inline void tap(Key key) const { ::MacroSupport.tap(key); }
-  inline void clear() { ::MacroSupport.clear(); }
 };
 
 }  // namespace plugin
@@ -54,6 +54,7 @@ void EEPROMKeymapProgrammer::nextState() {
   case WAIT_FOR_SOURCE_KEY:
     ::EEPROMKeymap.updateKey(update_position_, new_key_);
     Runtime.storage().commit();
+    Layer.updateActiveLayers();
     cancel();
     break;
   }
@@ -36,9 +36,18 @@
 
 namespace kaleidoscope {
 namespace plugin {
+
+namespace eeprom_keymap {
+// Without `EEPROM_KEYMAP_CACHE()`, there are no slots, and `cache` must not be
+// used at all.
+__attribute__((weak)) CachedLayer *cache   = nullptr;
+__attribute__((weak)) uint8_t cache_size = 0;
+}  // namespace eeprom_keymap
+
 uint16_t EEPROMKeymap::keymap_base_;
 uint8_t EEPROMKeymap::max_layers_;
 uint8_t EEPROMKeymap::progmem_layers_;
+uint8_t EEPROMKeymap::cache_generation_;
 
 EventHandlerResult EEPROMKeymap::onSetup() {
   progmem_layers_ = layer_count;
@@ -49,6 +58,19 @@ EventHandlerResult EEPROMKeymap::onNameQuery() {
   return ::Focus.sendName(F("EEPROMKeymap"));
 }
 
+// Works out which cached layers are active, so that looking up keys doesn't
+// have to. Only slots holding inactive layers can be handed to another layer.
+EventHandlerResult EEPROMKeymap::onLayerChange() {
+  using eeprom_keymap::cache;
+  using eeprom_keymap::no_cached_layer;
+
+  for (uint8_t i = 0; i < eeprom_keymap::cache_size; ++i) {
+    if (cache[i].layer != no_cached_layer)
+      cache[i].active = isLayerActive(cache[i].layer);
+  }
+  return EventHandlerResult::OK;
+}
+
 void EEPROMKeymap::setup(uint8_t max) {
   layer_count = max;
   if (::EEPROMSettings.ignoreHardcodedLayers()) {
@@ -58,23 +80,92 @@ void EEPROMKeymap::setup(uint8_t max) {
     Layer.getKey = getKeyExtended;
   }
   max_layers(max);
+  // The active layer keymap cache was built with the PROGMEM keymap.
+  Layer.updateActiveLayers();
 }
 
 void EEPROMKeymap::max_layers(uint8_t max) {
   max_layers_  = max;
   keymap_base_ = ::EEPROMSettings.requestSlice(max_layers_ * Runtime.device().numKeys() * 2);
+  invalidateCache();
 }
 
 Key EEPROMKeymap::getKey(uint8_t layer, KeyAddr key_addr) {
   if (layer >= max_layers_)
     return Key_NoKey;
 
+  const Key *keys = cachedLayer(layer);
+  if (keys != nullptr)
+    return keys[key_addr.toInt()];
+
+  return readKey(layer, key_addr);
+}
+
+Key EEPROMKeymap::readKey(uint8_t layer, KeyAddr key_addr) {
   uint16_t pos = ((layer * Runtime.device().numKeys()) + key_addr.toInt()) * 2;
 
   return Key(Runtime.storage().read(keymap_base_ + pos + 1),  // key_code
              Runtime.storage().read(keymap_base_ + pos));     // flags
 }
 
+// Returns the decoded keys of the EEPROM layer `layer`, loading it into the
+// cache if necessary, or `nullptr` if it isn't cached and there's no room for
+// it. A cached layer only gets replaced by another one if it is not active, and
+// inactive layers only get loaded into free slots, so that lookups from more
+// layers than fit in the cache can't keep evicting each other.
+const Key *EEPROMKeymap::cachedLayer(uint8_t layer) {
+  using eeprom_keymap::cache;
+  using eeprom_keymap::cache_size;
+  using eeprom_keymap::no_cached_layer;
+
+  if (cache_generation_ != ::EEPROMSettings.generation())
+    invalidateCache();
+
+  eeprom_keymap::CachedLayer *free_slot     = nullptr;
+  eeprom_keymap::CachedLayer *inactive_slot = nullptr;
+  for (uint8_t i = 0; i < cache_size; ++i) {
+    if (cache[i].layer == layer)
+      return cache[i].keys;
+    if (cache[i].layer == no_cached_layer) {
+      if (free_slot == nullptr)
+        free_slot = &cache[i];
+    } else if (!cache[i].active && inactive_slot == nullptr) {
+      inactive_slot = &cache[i];
+    }
+  }
+
+  if (free_slot == nullptr && inactive_slot == nullptr)
+    return nullptr;
+
+  bool active                      = isLayerActive(layer);
+  eeprom_keymap::CachedLayer *slot = free_slot;
+  if (slot == nullptr) {
+    if (!active)
+      return nullptr;
+    slot = inactive_slot;
+  }
+
+  slot->layer  = layer;
+  slot->active = active;
+  for (auto key_addr : KeyAddr::all()) {
+    slot->keys[key_addr.toInt()] = readKey(layer, key_addr);
+  }
+  return slot->keys;
+}
+
+bool EEPROMKeymap::isLayerActive(uint8_t layer) {
+  if (!::EEPROMSettings.ignoreHardcodedLayers())
+    layer += progmem_layers_;
+  return Layer.isActive(layer);
+}
+
+void EEPROMKeymap::invalidateCache() {
+  for (uint8_t i = 0; i < eeprom_keymap::cache_size; ++i) {
+    eeprom_keymap::cache[i].layer = eeprom_keymap::no_cached_layer;
+  }
+  cache_generation_ = ::EEPROMSettings.generation();
+}
+
 Key EEPROMKeymap::getKeyExtended(uint8_t layer, KeyAddr key_addr) {
 
   // If the layer is within PROGMEM bounds, look it up from there
@@ -93,6 +184,13 @@ uint16_t EEPROMKeymap::keymap_base() {
 void EEPROMKeymap::updateKey(uint16_t base_pos, Key key) {
   Runtime.storage().update(keymap_base_ + base_pos * 2, key.getFlags());
   Runtime.storage().update(keymap_base_ + base_pos * 2 + 1, key.getKeyCode());
+
+  // Update the cached copy of the key, if there is one.
+  uint8_t layer = base_pos / Runtime.device().numKeys();
+  for (uint8_t i = 0; i < eeprom_keymap::cache_size; ++i) {
+    if (eeprom_keymap::cache[i].layer == layer)
+      eeprom_keymap::cache[i].keys[base_pos % Runtime.device().numKeys()] = key;
+  }
 }
 
 void EEPROMKeymap::dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr)) {
@@ -129,6 +227,7 @@ EventHandlerResult EEPROMKeymap::onFocusEvent(const char *input) {
         layer_count += progmem_layers_;
         Layer.getKey = getKeyExtended;
       }
+      Layer.updateActiveLayers();
     }
     return EventHandlerResult::EVENT_CONSUMED;
   }
@@ -152,6 +251,13 @@ EventHandlerResult EEPROMKeymap::onFocusEvent(const char *input) {
     // we actually want.
     //
     dumpKeymap(max_layers_, static_cast<Key (*)(uint8_t, KeyAddr)>(getKey));
+  } else if (::Focus.isBinary()) {
+    // The frames hold the keymap as it is laid out in storage: the flags and
+    // the keycode of each key, in that order.
+    ::Focus.receiveFramesIntoStorage(keymap_base_, Runtime.device().numKeys() * max_layers_ * 2);
+    invalidateCache();
+    Runtime.storage().commit();
+    Layer.updateActiveLayers();
   } else {
     uint16_t i = 0;
 
@@ -163,6 +269,7 @@ EventHandlerResult EEPROMKeymap::onFocusEvent(const char *input) {
       i++;
     }
     Runtime.storage().commit();
+    Layer.updateActiveLayers();
   }
 
   return EventHandlerResult::EVENT_CONSUMED;
@@ -26,11 +26,52 @@
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/focus_commands.h"        // for KALEIDOSCOPE_FOCUS_COMMANDS
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope_internal/device.h"       // for device
 
 namespace kaleidoscope {
 namespace plugin {
+
+namespace eeprom_keymap {
+
+// Marks an unused cache slot.
+constexpr uint8_t no_cached_layer = 0xff;
+
+// One layer of the EEPROM keymap, decoded into RAM.
+struct CachedLayer {
+  uint8_t layer = no_cached_layer;
+  // Whether `layer` was active when it was loaded, or at the last layer change.
+  bool active;
+  Key keys[kaleidoscope_internal::device.numKeys()];  // NOLINT(runtime/arrays)
+};
+
+// The cache slots reserved by `EEPROM_KEYMAP_CACHE()`, if any.
+extern CachedLayer *cache;
+extern uint8_t cache_size;
+
+}  // namespace eeprom_keymap
+
+// clang-format off
+
+// Reserve RAM for caching up to `layers` layers of the EEPROM keymap, so that
+// looking up keys from those layers doesn't need to read from storage. Each
+// cached layer costs `sizeof(Key)` bytes per key, plus two.
+#define EEPROM_KEYMAP_CACHE(layers)                                     \
+  namespace kaleidoscope {                                              \
+  namespace plugin {                                                    \
+  namespace eeprom_keymap {                                             \
+  static_assert((layers) > 0, "The cache needs room for a layer");      \
+  CachedLayer cache_slots[layers]; /* NOLINT(runtime/arrays) */         \
+  CachedLayer *cache = cache_slots;                                     \
+  uint8_t cache_size = layers;                                          \
+  } /* eeprom_keymap */                                                 \
+  } /* plugin */                                                        \
+  } /* kaleidoscope */
+
+// clang-format on
+
 class EEPROMKeymap : public kaleidoscope::Plugin {
  public:
   enum class Mode {
@@ -40,6 +81,8 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
 
   EventHandlerResult onSetup();
   EventHandlerResult onNameQuery();
+  EventHandlerResult onLayerChange();
+  KALEIDOSCOPE_FOCUS_COMMANDS("keymap.custom", "keymap.default", "keymap.onlyCustom")
   EventHandlerResult onFocusEvent(const char *input);
 
   static void setup(uint8_t max);
@@ -53,10 +96,17 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
 
   static void updateKey(uint16_t base_pos, Key key);
 
+  static void invalidateCache();
+
  private:
   static uint16_t keymap_base_;
   static uint8_t max_layers_;
   static uint8_t progmem_layers_;
+  static uint8_t cache_generation_;
+
+  static Key readKey(uint8_t layer, KeyAddr key_addr);
+  static const Key *cachedLayer(uint8_t layer);
+  static bool isLayerActive(uint8_t layer);
 
   static Key parseKey();
   static void printKey(Key key);
@@ -231,6 +231,9 @@ EventHandlerResult FocusEEPROMCommand::onFocusEvent(const char *input) {
         Runtime.storage().update(i, d);
       }
       Runtime.storage().commit();
+      ::EEPROMSettings.contentsUpdated();
+      // The new contents might include changes to the keymap.
+      Layer.updateActiveLayers();
     }
   } else if (::Focus.inputMatchesCommand(input, cmd_free)) {
     ::Focus.send(Runtime.storage().length() - ::EEPROMSettings.used());
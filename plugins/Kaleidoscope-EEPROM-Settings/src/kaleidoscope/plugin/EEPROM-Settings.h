@@ -24,6 +24,7 @@
 #include <stdint.h>                             // for uint8_t, uint16_t
 #include <stddef.h>                             // for size_t
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/focus_commands.h"        // for KALEIDOSCOPE_FOCUS_COMMANDS
 #include "kaleidoscope/plugin.h"                // for Plugin
 #include "kaleidoscope/Runtime.h"               // for Runtime
 
@@ -102,23 +103,36 @@ class EEPROMSettings : public kaleidoscope::Plugin {
 
   bool isSliceValid(uint16_t start, size_t size);
 
+  // Changes every time the storage contents are overwritten wholesale (through
+  // the `eeprom.contents` Focus command), so that plugins that keep a copy of
+  // their data in RAM know when to reload it.
+  uint8_t generation() {
+    return generation_;
+  }
+  void contentsUpdated() {
+    ++generation_;
+  }
+
  private:
   static constexpr uint8_t IGNORE_HARDCODED_LAYER = 0x7e;
 
   uint16_t next_start_ = sizeof(EEPROMSettings::Settings);
   bool is_valid_;
   bool sealed_;
+  uint8_t generation_ = 0;
 
   Settings settings_;
 };
 
 class FocusSettingsCommand : public kaleidoscope::Plugin {
  public:
+  KALEIDOSCOPE_FOCUS_COMMANDS("settings.defaultLayer", "settings.valid?", "settings.version", "settings.crc")
   EventHandlerResult onFocusEvent(const char *input);
 };
 
 class FocusEEPROMCommand : public kaleidoscope::Plugin {
  public:
+  KALEIDOSCOPE_FOCUS_COMMANDS("eeprom.contents", "eeprom.free", "eeprom.erase")
   EventHandlerResult onFocusEvent(const char *input);
 };
 
@@ -29,6 +29,7 @@
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/hooks.h"                 // for Hooks
+#include "kaleidoscope/util/crc16.h"            // for _crc16_update
 
 #ifdef __AVR__
 #include <avr/pgmspace.h>
@@ -37,6 +38,8 @@
 namespace kaleidoscope {
 namespace plugin {
 
+uint16_t FocusSerial::frame_storage_base_;
+
 EventHandlerResult FocusSerial::afterEachCycle() {
   int c;
   // GD32 doesn't currently autoflush the very last packet. So manually flush here
@@ -142,6 +145,99 @@ bool FocusSerial::isEOL() {
   return true;
 }
 
+// Like `peek()`, but waits (up to the same timeout as `isEOL()`) for the next
+// character to arrive. Returns -1 if it doesn't.
+int FocusSerial::timedPeek() {
+  auto start = millis();
+
+  do {
+    int c = Runtime.serialPort().peek();
+    if (c >= 0)
+      return c;
+  } while ((millis() - start) < input_timeout_ms_);
+  return -1;
+}
+
+// Once the frames can't be trusted to say where the next one starts, the rest of
+// the request (which might hold newlines anywhere) is dropped, up to the point
+// where the host stops sending and waits for the response.
+void FocusSerial::discardUntilIdle() {
+  while (timedPeek() >= 0)
+    Runtime.serialPort().read();
+}
+
+uint16_t FocusSerial::receiveFrames(uint16_t max_length, FrameHandler handler) {
+  uint8_t payload[MAX_FRAME_SIZE];
+  uint16_t received = 0;
+  bool accepting    = true;
+
+  bool in_sync      = true;
+
+  while (timedPeek() == FRAME_START) {
+    Runtime.serialPort().read();
+
+    uint8_t length;
+    if (Runtime.serialPort().readBytes(&length, 1) != 1) {
+      in_sync = false;
+      break;
+    }
+
+    // A frame that is too long for the buffer is still read (in pieces), so
+    // that the ones after it can be found, but it won't be accepted.
+    uint16_t crc  = _crc16_update(0xffff, length);
+    uint8_t left  = length;
+    bool complete = true;
+    while (left > 0) {
+      uint8_t size = left < MAX_FRAME_SIZE ? left : MAX_FRAME_SIZE;
+      if (Runtime.serialPort().readBytes(payload, size) != size) {
+        complete = false;
+        break;
+      }
+      for (uint8_t i = 0; i < size; i++)
+        crc = _crc16_update(crc, payload[i]);
+      left -= size;
+    }
+
+    // A truncated frame, or one that fails its CRC check (which might be
+    // because its length is wrong), leaves us without a way to find the next.
+    uint8_t frame_crc[2];
+    if (!complete ||
+        Runtime.serialPort().readBytes(frame_crc, 2) != 2 ||
+        crc != (frame_crc[0] | (frame_crc[1] << 8))) {
+      in_sync = false;
+      break;
+    }
+
+    // Frames after one that doesn't fit are still read, but none is accepted.
+    if (length > MAX_FRAME_SIZE || length > max_length - received)
+      accepting = false;
+    if (!accepting)
+      continue;
+
+    (*handler)(received, payload, length);
+    received += length;
+  }
+
+  // The frames end where the request does, with a newline. Anything else is a
+  // frame whose start byte got lost.
+  int c = timedPeek();
+  if (!in_sync || (c >= 0 && c != NEWLINE))
+    discardUntilIdle();
+
+  send(received);
+  return received;
+}
+
+void FocusSerial::storeFrame(uint16_t offset, const uint8_t *data, uint8_t length) {
+  for (uint8_t i = 0; i < length; i++)
+    Runtime.storage().update(frame_storage_base_ + offset + i, data[i]);
+}
+
+uint16_t FocusSerial::receiveFramesIntoStorage(uint16_t base, uint16_t max_length) {
+  frame_storage_base_ = base;
+  return receiveFrames(max_length, storeFrame);
+}
+
 }  // namespace plugin
 }  // namespace kaleidoscope
 
@@ -29,6 +29,7 @@
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"         // for cRGB
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/focus_commands.h"        // for KALEIDOSCOPE_FOCUS_COMMANDS
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
 
@@ -127,8 +128,31 @@ class FocusSerial : public kaleidoscope::Plugin {
 
   bool isEOL();
 
+  // Binary frames, for uploading large amounts of data without the overhead of
+  // the text protocol (see "Binary uploads" in the README). `isBinary()` tells
+  // whether the arguments of the current command are frames, rather than text.
+  static constexpr uint8_t FRAME_START    = 0x02;
+  static constexpr uint8_t MAX_FRAME_SIZE = 64;
+
+  typedef void (*FrameHandler)(uint16_t offset, const uint8_t *data, uint8_t length);
+
+  bool isBinary() {
+    return timedPeek() == FRAME_START;
+  }
+  // Reads the frames of the current command, and passes the payload of each
+  // valid one to `handler`, along with its offset in the upload. Once a frame
+  // would take the upload past `max_length` bytes, the rest are skipped. Once
+  // one is truncated or fails its CRC check, the rest of the request is dropped,
+  // until no input arrives for `input_timeout_ms_`. Responds with the number of
+  // bytes passed to `handler`, and returns it.
+  uint16_t receiveFrames(uint16_t max_length, FrameHandler handler);
+  // Like `receiveFrames()`, but writes the payloads to `Runtime.storage()`,
+  // starting at `base`.
+  uint16_t receiveFramesIntoStorage(uint16_t base, uint16_t max_length);
+
   /* Hooks */
   EventHandlerResult afterEachCycle();
+  KALEIDOSCOPE_FOCUS_COMMANDS("device.reset", "led.modes", "plugins")
   EventHandlerResult onFocusEvent(const char *input);
 
  private:
@@ -136,6 +160,15 @@ class FocusSerial : public kaleidoscope::Plugin {
   uint8_t buf_cursor_ = 0;
   void printBool(bool b);
 
+  // How long `timedPeek()` waits for input, and how long the input has to stop
+  // for `discardUntilIdle()` to return
+  static constexpr uint16_t input_timeout_ms_ = 1000;
+  int timedPeek();
+  void discardUntilIdle();
+
+  static uint16_t frame_storage_base_;
+  static void storeFrame(uint16_t offset, const uint8_t *data, uint8_t length);
+
   // This is a hacky workaround for the host seemingly dropping characters
   // when a client spams its serial port too quickly
   // Verified on GD32 and macOS 12.3 2022-03-29
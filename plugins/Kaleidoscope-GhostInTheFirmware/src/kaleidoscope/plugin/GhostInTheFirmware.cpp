@@ -27,7 +27,6 @@
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/keyswitch_state.h"       // for IS_PRESSED, WAS_PRESSED
 #include "kaleidoscope/progmem_helpers.h"       // for loadFromProgmem
 
@@ -36,55 +35,63 @@ namespace plugin {
 
 void GhostInTheFirmware::activate() {
   is_active_ = true;
+  Runtime.armDeadline(step_deadline_, 0);
 }
 
-EventHandlerResult GhostInTheFirmware::afterEachCycle() {
-  if (!is_active_)
-    return EventHandlerResult::OK;
+void GhostInTheFirmware::onStepDeadline() {
+  ::GhostInTheFirmware.step();
+}
 
-  // This stores the current GhostKey in the active sequence.
-  static GhostKey ghost_key{KeyAddr::none(), 0, 0};
+void GhostInTheFirmware::step() {
+  if (!is_active_)
+    return;
 
   // When a ghost key has finished playing, it sets its delay to zero,
   // indicating that it's time to read the next one from memory.
-  if (ghost_key.delay == 0) {
+  if (ghost_key_.delay == 0) {
     // Read the settings for the key from PROGMEM:
-    loadFromProgmem(ghost_keys[current_pos_], ghost_key);
+    loadFromProgmem(ghost_keys[current_pos_], ghost_key_);
     // The end of the sequence is marked by a GhostKey with an invalid KeyAddr
     // value (i.e. KeyAddr::none()). If we read this sentinel value, reset and
     // deactivate.
-    if (!ghost_key.addr.isValid()) {
-      current_pos_    = 0;
-      ghost_key.delay = 0;
-      is_active_      = false;
-      return EventHandlerResult::OK;
+    if (!ghost_key_.addr.isValid()) {
+      current_pos_     = 0;
+      ghost_key_.delay = 0;
+      is_active_       = false;
+      return;
     }
     // If we're not at the end of the sequence, send the first keypress event,
     // and start the timer.
-    Runtime.handleKeyEvent(KeyEvent(ghost_key.addr, IS_PRESSED));
+    Runtime.handleKeyEvent(KeyEvent(ghost_key_.addr, IS_PRESSED));
     start_time_ = Runtime.millisAtCycleStart();
 
-  } else if (ghost_key.addr.isValid()) {
+  } else if (ghost_key_.addr.isValid()) {
     // If the ghost key's address is still valid, that means that the virtual
     // key is still being held.
-    if (Runtime.hasTimeExpired(start_time_, ghost_key.press_time)) {
+    if (Runtime.hasTimeExpired(start_time_, ghost_key_.press_time)) {
       // The key press has timed out, so we send the release event.
-      Runtime.handleKeyEvent(KeyEvent(ghost_key.addr, WAS_PRESSED));
+      Runtime.handleKeyEvent(KeyEvent(ghost_key_.addr, WAS_PRESSED));
       // Next, we invalidate the ghost key's address to prevent checking the
       // hold timeout again, then restart the timer for checking the delay.
-      ghost_key.addr.clear();
+      ghost_key_.addr.clear();
       start_time_ = Runtime.millisAtCycleStart();
     }
 
-  } else if (Runtime.hasTimeExpired(start_time_, ghost_key.delay)) {
+  } else if (Runtime.hasTimeExpired(start_time_, ghost_key_.delay)) {
     // The ghost key has been (virtually) pressed and released, and its delay
     // has now elapsed, so we set the delay to zero and increment the index
     // value to indicate that the next key should be loaded in the next cycle.
-    ghost_key.delay = 0;
+    ghost_key_.delay = 0;
     ++current_pos_;
   }
 
-  return EventHandlerResult::OK;
+  if (ghost_key_.delay == 0) {
+    Runtime.armDeadline(step_deadline_, 0);
+  } else if (ghost_key_.addr.isValid()) {
+    Runtime.armDeadline(step_deadline_, Runtime.millisUntilTimeExpires(start_time_, ghost_key_.press_time));
+  } else {
+    Runtime.armDeadline(step_deadline_, Runtime.millisUntilTimeExpires(start_time_, ghost_key_.delay));
+  }
 }
 
 }  // namespace plugin
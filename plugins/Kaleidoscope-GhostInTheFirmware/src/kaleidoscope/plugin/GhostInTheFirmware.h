@@ -24,8 +24,8 @@
 
 #include <stdint.h>  // for uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
 
 namespace kaleidoscope {
@@ -41,12 +41,20 @@ class GhostInTheFirmware : public kaleidoscope::Plugin {
 
   void activate();
 
-  EventHandlerResult afterEachCycle();
-
  private:
   bool is_active_       = false;
   uint16_t current_pos_ = 0;
   uint16_t start_time_;
+
+  // The current GhostKey in the active sequence
+  GhostKey ghost_key_{KeyAddr::none(), 0, 0};
+
+  // Expires when the current ghost key is due to be pressed, released, or
+  // followed by the next one
+  Deadline step_deadline_{onStepDeadline};
+
+  static void onStepDeadline();
+  void step();
 };
 
 }  // namespace plugin
@@ -87,15 +87,9 @@ uint8_t Model01LEDDriver::getBrightness() {
 
 void Model01LEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
   if (i < 32) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
-
-    Model01Hands::leftHand.ledData.leds[i] = crgb;
+    isLEDChanged |= Model01Hands::leftHand.setCrgbAt(i, crgb);
   } else if (i < 64) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
-
-    Model01Hands::rightHand.ledData.leds[i - 32] = crgb;
+    isLEDChanged |= Model01Hands::rightHand.setCrgbAt(i - 32, crgb);
   } else {
     // TODO(anyone):
     // how do we want to handle debugging assertions about crazy user
@@ -114,6 +108,11 @@ cRGB Model01LEDDriver::getCrgbAt(uint8_t i) {
   }
 }
 
+// Roughly how long it takes to send one LED bank, in microseconds, at the
+// 400kHz the TWI bus runs at once `Model01::setup()` has set `TWBR`: nine bits
+// for each byte of the bank, plus the command and address bytes.
+static constexpr uint16_t led_bank_send_time = (LED_BYTES_PER_BANK + 2) * 9 * 1000000UL / 400000;
+
 void Model01LEDDriver::syncLeds() {
   if (!isLEDChanged)
     return;
@@ -122,21 +121,23 @@ void Model01LEDDriver::syncLeds() {
   // We send it all at once to make it look nicer.
   // We alternate left and right hands because otherwise
   // we run into a race condition with updating the next bank
-  // on an ATTiny before it's done writing the previous one to memory
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
+  // on an ATTiny before it's done writing the previous one to memory.
+  // Each hand only sends the banks that changed (if any), so when only one of
+  // them sent a bank, we wait for about as long as the other one would have
+  // taken before sending the next.
+  for (uint8_t bank = 0; bank < LED_BANKS; bank++) {
+    bool left_sent  = Model01Hands::leftHand.sendLEDData();
+    bool right_sent = Model01Hands::rightHand.sendLEDData();
+    if (!left_sent && !right_sent)
+      break;
+    if (left_sent != right_sent &&
+        (Model01Hands::leftHand.isLEDDataDirty() ||
+         Model01Hands::rightHand.isLEDDataDirty()))
+      delayMicroseconds(led_bank_send_time);
+  }
 
-  isLEDChanged = false;
+  isLEDChanged = Model01Hands::leftHand.isLEDDataDirty() ||
+                 Model01Hands::rightHand.isLEDDataDirty();
 }
 
 bool Model01LEDDriver::ledPowerFault() {
@@ -171,6 +172,10 @@ void Model01KeyScanner::readMatrix() {
   previousLeftHandState  = leftHandState;
   previousRightHandState = rightHandState;
 
+  // Reading the keys starts a new cycle on the bus
+  Model01Hands::leftHand.telemetry.startCycle();
+  Model01Hands::rightHand.telemetry.startCycle();
+
   if (Model01Hands::leftHand.readKeys()) {
     leftHandState = Model01Hands::leftHand.getKeyData();
   }
@@ -244,6 +249,17 @@ uint8_t Model01KeyScanner::previousPressedKeyswitchCount() {
 
 /********* Hardware plugin *********/
 
+driver::i2c::Telemetry *Model01::i2cTelemetry(uint8_t n) {
+  switch (n) {
+  case 0:
+    return &Model01Hands::leftHand.telemetry;
+  case 1:
+    return &Model01Hands::rightHand.telemetry;
+  default:
+    return nullptr;
+  }
+}
+
 void Model01::setup() {
   Model01Hands::setup();
   kaleidoscope::device::Base<Model01Props>::setup();
@@ -0,0 +1,150 @@
+/* Kaleidoscope-Hardware-Keyboardio-Model01 -- Keyboardio Model01 hardware support for Kaleidoscope
+ * Copyright 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(KALEIDOSCOPE_VIRTUAL_BUILD) && defined(ARDUINO_AVR_MODEL01)
+
+#include "kaleidoscope/device/keyboardio/VirtualTWI.h"
+
+#include <string.h>  // for memcpy, memset
+
+extern "C" {
+#include "kaleidoscope/device/keyboardio/twi.h"
+}
+
+// Kaleidoscope-Hardware-Keyboardio-Model01 headers
+#include "kaleidoscope/driver/keyboardio/wire-protocol-constants.h"
+
+namespace kaleidoscope {
+namespace device {
+namespace keyboardio {
+
+#define SCANNER_I2C_ADDR_BASE 0x58
+
+// The scanner firmware version reported by the simulated scanners
+#define VIRTUAL_SCANNER_VERSION 3
+
+// twi_writeTo() results
+#define TWI_SUCCESS      0
+#define TWI_ADDRESS_NACK 2
+
+VirtualTWI::Scanner VirtualTWI::scanners_[VirtualTWI::scanner_count];
+
+void VirtualTWI::reset() {
+  memset(scanners_, 0, sizeof(scanners_));
+  for (Scanner &scanner : scanners_) {
+    scanner.connected                            = true;
+    scanner.registers[TWI_CMD_VERSION]           = VIRTUAL_SCANNER_VERSION;
+    scanner.registers[TWI_CMD_LED_SPI_FREQUENCY] = LED_SPI_FREQUENCY_DEFAULT;
+    scanner.selected_register                    = TWI_CMD_NONE;
+  }
+}
+
+VirtualTWI::Scanner *VirtualTWI::find(uint8_t address) {
+  if ((address & ~(scanner_count - 1)) != SCANNER_I2C_ADDR_BASE)
+    return nullptr;
+
+  Scanner &scanner = scanners_[address - SCANNER_I2C_ADDR_BASE];
+  if (!scanner.connected)
+    return nullptr;
+  if (scanner.nacks) {
+    --scanner.nacks;
+    return nullptr;
+  }
+  return &scanner;
+}
+
+uint8_t VirtualTWI::writeTo(uint8_t address, const uint8_t *data, uint8_t length) {
+  Scanner *scanner = find(address);
+  if (!scanner)
+    return TWI_ADDRESS_NACK;
+  if (length == 0)
+    return TWI_SUCCESS;
+
+  uint8_t command            = data[0];
+  scanner->selected_register = TWI_CMD_NONE;
+
+  if (command >= TWI_CMD_LED_BASE) {
+    uint8_t bank = command - TWI_CMD_LED_BASE;
+    if (bank < led_banks && length == led_bytes_per_bank + 1) {
+      memcpy(scanner->led_data[bank], data + 1, led_bytes_per_bank);
+      ++scanner->led_bank_writes;
+    }
+  } else if (command == TWI_CMD_LED_SET_ALL_TO && length == 4) {
+    for (uint8_t bank = 0; bank < led_banks; bank++) {
+      for (uint8_t i = 0; i < led_bytes_per_bank; i += 3)
+        memcpy(&scanner->led_data[bank][i], data + 1, 3);
+    }
+    ++scanner->led_set_all_writes;
+  } else if (command < register_count) {
+    // A command on its own selects a register to read the next time.
+    if (length == 1) {
+      scanner->selected_register = command;
+    } else if (command != TWI_CMD_VERSION) {
+      scanner->registers[command] = data[1];
+    }
+  }
+  return TWI_SUCCESS;
+}
+
+uint8_t VirtualTWI::readFrom(uint8_t address, uint8_t *data, uint8_t length) {
+  Scanner *scanner = find(address);
+  if (!scanner)
+    return 0;
+
+  uint8_t reply[5];
+  uint8_t reply_length;
+  if (scanner->selected_register != TWI_CMD_NONE) {
+    reply[0]                   = scanner->registers[scanner->selected_register];
+    reply_length               = 1;
+    scanner->selected_register = TWI_CMD_NONE;
+  } else {
+    reply[0] = TWI_REPLY_KEYDATA;
+    memcpy(reply + 1, scanner->rows, sizeof(scanner->rows));
+    reply_length = sizeof(reply);
+    ++scanner->key_reads;
+  }
+
+  if (length > reply_length)
+    length = reply_length;
+  memcpy(data, reply, length);
+  return length;
+}
+
+}  // namespace keyboardio
+}  // namespace device
+}  // namespace kaleidoscope
+
+using kaleidoscope::device::keyboardio::VirtualTWI;
+
+void twi_init(void) {
+  VirtualTWI::reset();
+}
+
+uint8_t twi_readFrom(uint8_t address, uint8_t *data, uint8_t length, uint8_t sendStop) {
+  return VirtualTWI::readFrom(address, data, length);
+}
+
+uint8_t twi_writeTo(uint8_t address, uint8_t *data, uint8_t length, uint8_t wait, uint8_t sendStop) {
+  return VirtualTWI::writeTo(address, data, length);
+}
+
+#endif
@@ -0,0 +1,87 @@
+/* Kaleidoscope-Hardware-Keyboardio-Model01 -- Keyboardio Model01 hardware support for Kaleidoscope
+ * Copyright 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(KALEIDOSCOPE_VIRTUAL_BUILD) && defined(ARDUINO_AVR_MODEL01)
+
+#include <stdint.h>  // for uint8_t, uint16_t
+
+namespace kaleidoscope {
+namespace device {
+namespace keyboardio {
+
+// The I2C bus of a Model01 in virtual builds, with a simulated key scanner at
+// each of the four scanner addresses. `Model01Side` talks to these through the
+// `twi_*` functions declared in twi.h, which lets tests exercise it (and see
+// what it sent) without the hardware.
+class VirtualTWI {
+ public:
+  static constexpr uint8_t scanner_count      = 4;
+  static constexpr uint8_t led_banks          = 4;
+  static constexpr uint8_t led_bytes_per_bank = 24;
+  static constexpr uint8_t register_count     = 7;
+
+  struct Scanner {
+    // A scanner that isn't connected doesn't acknowledge its address.
+    bool connected;
+    // The number of transactions left to fail before the next one succeeds
+    uint8_t nacks;
+    // The key state reported for each row
+    uint8_t rows[4];
+    // The registers that can be read, indexed by `TWI_CMD_*`
+    uint8_t registers[register_count];  // NOLINT(runtime/arrays)
+    // The LED data last written to each bank, as sent (brightness adjusted and
+    // gamma corrected)
+    uint8_t led_data[led_banks][led_bytes_per_bank];
+    uint16_t led_bank_writes;
+    uint16_t led_set_all_writes;
+    uint16_t key_reads;
+
+    // The register selected for reading, if any
+    uint8_t selected_register;
+  };
+
+  // Returns the scanner with the relative address `ad01` (0-3).
+  static Scanner &scanner(uint8_t ad01) {
+    return scanners_[ad01 % scanner_count];
+  }
+
+  // Puts every scanner back in its power-on state: connected, with no keys
+  // pressed, and no LED data received.
+  static void reset();
+
+  // Handlers for the `twi_*` functions
+  static uint8_t writeTo(uint8_t address, const uint8_t *data, uint8_t length);
+  static uint8_t readFrom(uint8_t address, uint8_t *data, uint8_t length);
+
+ private:
+  static Scanner scanners_[scanner_count];
+
+  static Scanner *find(uint8_t address);
+};
+
+}  // namespace keyboardio
+}  // namespace device
+}  // namespace kaleidoscope
+
+#endif
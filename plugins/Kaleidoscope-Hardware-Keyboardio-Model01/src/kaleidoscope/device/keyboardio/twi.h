@@ -55,3 +55,14 @@ void twi_releaseBus(void);
 
 #endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 #endif
+
+#if defined(KALEIDOSCOPE_VIRTUAL_BUILD) && defined(ARDUINO_AVR_MODEL01)
+
+#include <inttypes.h>
+
+// In virtual builds, these talk to the simulated scanners in VirtualTWI.cpp.
+void twi_init(void);
+uint8_t twi_readFrom(uint8_t, uint8_t *, uint8_t, uint8_t);
+uint8_t twi_writeTo(uint8_t, uint8_t *, uint8_t, uint8_t, uint8_t);
+
+#endif
@@ -20,7 +20,9 @@
  * SOFTWARE.
  */
 
-#ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+// Virtual builds only have a simulated I2C bus for the Model 01 (see
+// VirtualTWI.h), so the side driver is left out of those for other devices.
+#if !defined(KALEIDOSCOPE_VIRTUAL_BUILD) || defined(ARDUINO_AVR_MODEL01)
 
 #include "kaleidoscope/driver/keyboardio/Model01Side.h"
 
@@ -76,7 +78,7 @@ uint8_t Model01Side::controllerAddress() {
 // https://www.arduino.cc/en/Reference/WireEndTransmission
 uint8_t Model01Side::setKeyscanInterval(uint8_t delay) {
   uint8_t data[] = {TWI_CMD_KEYSCAN_INTERVAL, delay};
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+  uint8_t result = writeData(data, ELEMENTS(data));
 
   return result;
 }
@@ -105,18 +107,36 @@ int Model01Side::readLEDSPIFrequency() {
 // https://www.arduino.cc/en/Reference/WireEndTransmission
 uint8_t Model01Side::setLEDSPIFrequency(uint8_t frequency) {
   uint8_t data[] = {TWI_CMD_LED_SPI_FREQUENCY, frequency};
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+  uint8_t result = writeData(data, ELEMENTS(data));
 
   return result;
 }
 
 
+// Writes `data` to the scanner, and returns the twi_writeTo() result (0 =
+// success).
+uint8_t Model01Side::writeData(uint8_t *data, uint8_t length) {
+  uint32_t start = micros();
+  uint8_t result = twi_writeTo(addr, data, length, 1, 0);
+  telemetry.record(length, micros() - start, result == 0);
+  return result;
+}
+
+// Reads up to `length` bytes from the scanner into `data`, and returns the
+// number of bytes read.
+uint8_t Model01Side::readData(uint8_t *data, uint8_t length) {
+  uint32_t start = micros();
+  uint8_t read   = twi_readFrom(addr, data, length, true);
+  telemetry.record(read, micros() - start, read == length);
+  return read;
+}
+
 int Model01Side::readRegister(uint8_t cmd) {
 
   uint8_t return_value = 0;
 
   uint8_t data[] = {cmd};
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+  uint8_t result = writeData(data, ELEMENTS(data));
 
 
   delayMicroseconds(15);  // We may be able to drop this in the future
@@ -127,7 +147,7 @@ int Model01Side::readRegister(uint8_t cmd) {
   uint8_t rxBuffer[1];
 
   // perform blocking read into buffer
-  uint8_t read = twi_readFrom(addr, rxBuffer, ELEMENTS(rxBuffer), true);
+  uint8_t read = readData(rxBuffer, ELEMENTS(rxBuffer));
   if (read > 0) {
     return rxBuffer[0];
   } else {
@@ -142,8 +162,8 @@ bool Model01Side::readKeys() {
   uint8_t rxBuffer[5];
 
   // perform blocking read into buffer
-  uint8_t read = twi_readFrom(addr, rxBuffer, ELEMENTS(rxBuffer), true);
-  if (rxBuffer[0] == TWI_REPLY_KEYDATA) {
+  uint8_t read = readData(rxBuffer, ELEMENTS(rxBuffer));
+  if (read == ELEMENTS(rxBuffer) && rxBuffer[0] == TWI_REPLY_KEYDATA) {
     keyData.rows[0] = rxBuffer[1];
     keyData.rows[1] = rxBuffer[2];
     keyData.rows[2] = rxBuffer[3];
@@ -158,53 +178,104 @@ keydata_t Model01Side::getKeyData() {
   return keyData;
 }
 
-void Model01Side::sendLEDData() {
-  sendLEDBank(nextLEDBank++);
-  if (nextLEDBank == LED_BANKS) {
+auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
+
+bool Model01Side::setCrgbAt(uint8_t i, cRGB color) {
+  cRGB &led = ledData.leds[i];
+  if (led.r == color.r && led.g == color.g && led.b == color.b)
+    return false;
+
+  led = color;
+  bitSet(dirty_led_banks_, i / LEDS_PER_BANK);
+  return true;
+}
+
+bool Model01Side::sendLEDData() {
+  // Banks that haven't changed don't need to be sent again, which leaves the
+  // bus free for reading keys.
+  if (dirty_led_banks_ == 0)
+    return false;
+
+  if (sendUniformLEDData())
+    return true;
+
+  while (!bitRead(dirty_led_banks_, nextLEDBank)) {
+    if (++nextLEDBank == LED_BANKS)
+      nextLEDBank = 0;
+  }
+
+  // If the transmission fails, the bank stays dirty, and gets sent again later.
+  if (sendLEDBank(nextLEDBank) == 0)
+    bitClear(dirty_led_banks_, nextLEDBank);
+
+  if (++nextLEDBank == LED_BANKS) {
     nextLEDBank = 0;
   }
+  return true;
 }
 
-auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
+// If every LED on this side has the same color, sets them all with a single
+// command, and returns true. Otherwise, returns false without sending anything.
+bool Model01Side::sendUniformLEDData() {
+  const cRGB &color = ledData.leds[0];
+  for (uint8_t i = 1; i < LEDS_PER_HAND; i++) {
+    const cRGB &led = ledData.leds[i];
+    if (led.r != color.r || led.g != color.g || led.b != color.b)
+      return false;
+  }
 
-void Model01Side::sendLEDBank(uint8_t bank) {
+  uint8_t data[] = {TWI_CMD_LED_SET_ALL_TO,
+                    pgm_read_byte(&gamma8[adjustBrightness(color.b)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.g)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.r)])};
+  if (writeData(data, ELEMENTS(data)) == 0)
+    dirty_led_banks_ = 0;
+  return true;
+}
+
+/* While the ATTiny controller does have a global brightness command, it is
+ * limited to 32 levels, and those aren't nicely spread out either. For this
+ * reason, we're doing our own brightness adjustment on this side, because
+ * that results in a considerably smoother curve. */
+uint8_t Model01Side::adjustBrightness(uint8_t c) {
+  if (c > brightness_adjustment_)
+    return c - brightness_adjustment_;
+  return 0;
+}
+
+uint8_t Model01Side::sendLEDBank(uint8_t bank) {
   uint8_t data[LED_BYTES_PER_BANK + 1];
   data[0] = TWI_CMD_LED_BASE + bank;
   for (uint8_t i = 0; i < LED_BYTES_PER_BANK; i++) {
-    /* While the ATTiny controller does have a global brightness command, it is
-     * limited to 32 levels, and those aren't nicely spread out either. For this
-     * reason, we're doing our own brightness adjustment on this side, because
-     * that results in a considerably smoother curve. */
-    uint8_t c = ledData.bytes[bank][i];
-    if (c > brightness_adjustment_)
-      c -= brightness_adjustment_;
-    else
-      c = 0;
-
-    data[i + 1] = pgm_read_byte(&gamma8[c]);
+    data[i + 1] = pgm_read_byte(&gamma8[adjustBrightness(ledData.bytes[bank][i])]);
   }
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+  return writeData(data, ELEMENTS(data));
 }
 
+// Both of these keep ledData in step with what the LEDs are showing, so that
+// the next sendLEDData() doesn't overwrite the change with stale colors.
 void Model01Side::setAllLEDsTo(cRGB color) {
-  uint8_t data[] = {TWI_CMD_LED_SET_ALL_TO,
-                    pgm_read_byte(&gamma8[color.b]),
-                    pgm_read_byte(&gamma8[color.g]),
-                    pgm_read_byte(&gamma8[color.r])};
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+  for (uint8_t i = 0; i < LEDS_PER_HAND; i++)
+    setCrgbAt(i, color);
+  sendUniformLEDData();
 }
 
 void Model01Side::setOneLEDTo(uint8_t led, cRGB color) {
+  // The LED's bank stays dirty, because other LEDs in it may be waiting to be
+  // sent too.
+  if (!setCrgbAt(led, color))
+    return;
+
   uint8_t data[] = {TWI_CMD_LED_SET_ONE_TO,
                     led,
-                    pgm_read_byte(&gamma8[color.b]),
-                    pgm_read_byte(&gamma8[color.g]),
-                    pgm_read_byte(&gamma8[color.r])};
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
+                    pgm_read_byte(&gamma8[adjustBrightness(color.b)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.g)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.r)])};
+  writeData(data, ELEMENTS(data));
 }
 
 }  // namespace keyboardio
 }  // namespace driver
 }  // namespace kaleidoscope
 
-#endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+#endif
@@ -26,6 +26,9 @@
 // System headers
 #include <stdint.h>  // for uint8_t, uint32_t
 
+// Kaleidoscope headers
+#include "kaleidoscope/driver/i2c/Telemetry.h"  // for Telemetry
+
 // We allow cRGB/CRGB to be defined already when this is included.
 //
 #ifndef CRGB
@@ -44,6 +47,7 @@ struct cRGB {
 
 #define LEDS_PER_HAND      32
 #define LED_BYTES_PER_BANK sizeof(cRGB) * LEDS_PER_HAND / LED_BANKS
+#define LEDS_PER_BANK      (LEDS_PER_HAND / LED_BANKS)
 
 namespace kaleidoscope {
 namespace driver {
@@ -61,7 +65,6 @@ typedef union {
 
 // config options
 
-#ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 // used to configure interrupts, configuration for a particular controller
 class Model01Side {
  public:
@@ -76,7 +79,10 @@ class Model01Side {
   uint8_t setLEDSPIFrequency(uint8_t frequency);
   int readLEDSPIFrequency();
 
-  void sendLEDData();
+  // Sends the next LED bank that has changed since it was last sent, or all of
+  // the LEDs at once if they are all the same color. Returns false if there was
+  // nothing to send.
+  bool sendLEDData();
   void setOneLEDTo(uint8_t led, cRGB color);
   void setAllLEDsTo(cRGB color);
   keydata_t getKeyData();
@@ -84,23 +90,41 @@ class Model01Side {
   LEDData_t ledData;
   uint8_t controllerAddress();
 
+  // Sets the color of one LED, and marks its bank for sending if the color
+  // changed. Returns true if it did.
+  bool setCrgbAt(uint8_t i, cRGB color);
+  bool isLEDDataDirty() const {
+    return dirty_led_banks_ != 0;
+  }
+
   void setBrightness(uint8_t brightness) {
     brightness_adjustment_ = 255 - brightness;
+    dirty_led_banks_       = ALL_LED_BANKS;
   }
   uint8_t getBrightness() {
     return 255 - brightness_adjustment_;
   }
 
+  // Bus usage of every transaction with this side's scanner
+  i2c::Telemetry telemetry;
+
  private:
   uint8_t brightness_adjustment_ = 0;
   int addr;
   int ad01;
   keydata_t keyData;
   uint8_t nextLEDBank = 0;
-  void sendLEDBank(uint8_t bank);
+  // One bit per LED bank that has changed since it was last sent. The state of
+  // the LEDs on the scanner is unknown to begin with, so they all start dirty.
+  static const uint8_t ALL_LED_BANKS = (1 << LED_BANKS) - 1;
+  uint8_t dirty_led_banks_           = ALL_LED_BANKS;
+  uint8_t sendLEDBank(uint8_t bank);
+  bool sendUniformLEDData();
+  uint8_t adjustBrightness(uint8_t c);
   int readRegister(uint8_t cmd);
+  uint8_t writeData(uint8_t *data, uint8_t length);
+  uint8_t readData(uint8_t *data, uint8_t length);
 };
-#endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 
 }  // namespace keyboardio
 }  // namespace driver
@@ -71,15 +71,9 @@ uint8_t Model100LEDDriver::getBrightness() {
 
 void Model100LEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
   if (i < 32) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
-
-    Model100Hands::leftHand.ledData.leds[i] = crgb;
+    isLEDChanged |= Model100Hands::leftHand.setCrgbAt(i, crgb);
   } else if (i < 64) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
-
-    Model100Hands::rightHand.ledData.leds[i - 32] = crgb;
+    isLEDChanged |= Model100Hands::rightHand.setCrgbAt(i - 32, crgb);
   } else {
     // TODO(anyone):
     // how do we want to handle debugging assertions about crazy user
@@ -98,6 +92,11 @@ cRGB Model100LEDDriver::getCrgbAt(uint8_t i) {
   }
 }
 
+// Roughly how long it takes to send one LED bank, in microseconds, at the
+// 400kHz the bus is set up for: nine bits for each byte of the bank, plus the
+// command and address bytes.
+static constexpr uint16_t led_bank_send_time = (LED_BYTES_PER_BANK + 2) * 9 * 1000000UL / 400000;
+
 void Model100LEDDriver::syncLeds() {
   if (!isLEDChanged)
     return;
@@ -105,21 +104,23 @@ void Model100LEDDriver::syncLeds() {
   // We send it all at once to make it look nicer.
   // We alternate left and right hands because otherwise
   // we run into a race condition with updating the next bank
-  // on an ATTiny before it's done writing the previous one to memory
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
+  // on an ATTiny before it's done writing the previous one to memory.
+  // Each hand only sends the banks that changed (if any), so when only one of
+  // them sent a bank, we wait for about as long as the other one would have
+  // taken before sending the next.
+  for (uint8_t bank = 0; bank < LED_BANKS; bank++) {
+    bool left_sent  = Model100Hands::leftHand.sendLEDData();
+    bool right_sent = Model100Hands::rightHand.sendLEDData();
+    if (!left_sent && !right_sent)
+      break;
+    if (left_sent != right_sent &&
+        (Model100Hands::leftHand.isLEDDataDirty() ||
+         Model100Hands::rightHand.isLEDDataDirty()))
+      delayMicroseconds(led_bank_send_time);
+  }
 
-  isLEDChanged = false;
+  isLEDChanged = Model100Hands::leftHand.isLEDDataDirty() ||
+                 Model100Hands::rightHand.isLEDDataDirty();
 }
 
 /********* Key scanner *********/
@@ -160,6 +161,10 @@ void Model100KeyScanner::readMatrix() {
   previousLeftHandState  = leftHandState;
   previousRightHandState = rightHandState;
 
+  // Reading the keys starts a new cycle on the bus
+  Model100Hands::leftHand.telemetry.startCycle();
+  Model100Hands::rightHand.telemetry.startCycle();
+
   if (Model100Hands::leftHand.readKeys()) {
     leftHandState = Model100Hands::leftHand.getKeyData();
   }
@@ -233,6 +238,17 @@ uint8_t Model100KeyScanner::previousPressedKeyswitchCount() {
 
 /********* Hardware plugin *********/
 
+driver::i2c::Telemetry *Model100::i2cTelemetry(uint8_t n) {
+  switch (n) {
+  case 0:
+    return &Model100Hands::leftHand.telemetry;
+  case 1:
+    return &Model100Hands::rightHand.telemetry;
+  default:
+    return nullptr;
+  }
+}
+
 void Model100::enableHardwareTestMode() {
   // Toggle the programming LEDS on
   // TODO(anyone): PORTD |= (1 << 5);
@@ -74,6 +74,10 @@ struct Model100LEDDriverProps : public kaleidoscope::driver::led::BaseProps {
 class Model100LEDDriver : public kaleidoscope::driver::led::Base<Model100LEDDriverProps> {
  public:
   static void syncLeds();
+  // Banks that failed to send stay dirty, and are sent again by the next sync.
+  static bool isSyncPending() {
+    return isLEDChanged;
+  }
   static void setCrgbAt(uint8_t i, cRGB crgb);
   static cRGB getCrgbAt(uint8_t i);
   static void setBrightness(uint8_t brightness);
@@ -167,6 +171,9 @@ class Model100 : public kaleidoscope::device::Base<Model100Props> {
   }
   static void rebootBootloader();
   static void enableHardwareTestMode();
+
+  // The left hand's scanner is device 0, and the right hand's is device 1.
+  static driver::i2c::Telemetry *i2cTelemetry(uint8_t n);
 };
 
 #endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
@@ -139,15 +139,26 @@ uint8_t Model100Side::writeData(uint8_t *data, uint8_t length) {
   if (isDeviceAvailable() == false) {
     return 1;
   }
+  uint32_t start = micros();
   Wire.beginTransmission(addr);
   Wire.write(data, length);
   uint8_t result = Wire.endTransmission();
+  telemetry.record(length, micros() - start, result == 0);
   if (result) {
     markDeviceUnavailable();
   }
   return result;
 }
 
+// Requests `length` bytes from the scanner, to be read with Wire.read(), and
+// returns the number of bytes it sent.
+uint8_t Model100Side::requestData(uint8_t length) {
+  uint32_t start = micros();
+  uint8_t result = Wire.requestFrom(addr, length);
+  telemetry.record(result, micros() - start, result == length);
+  return result;
+}
+
 int Model100Side::readRegister(uint8_t cmd) {
   uint8_t return_value = 0;
   uint8_t data[]       = {cmd};
@@ -167,7 +178,7 @@ int Model100Side::readRegister(uint8_t cmd) {
 
   // perform blocking read into buffer
 
-  Wire.requestFrom(addr, 1);  // request 1 byte from the keyscanner
+  requestData(1);  // request 1 byte from the keyscanner
   if (Wire.available()) {
     return Wire.read();
   } else {
@@ -187,7 +198,7 @@ bool Model100Side::readKeys() {
   // perform blocking read into buffer
   uint8_t read           = 0;
   uint8_t bytes_returned = 0;
-  bytes_returned         = Wire.requestFrom(addr, 5);  // request 5 bytes from the keyscanner
+  bytes_returned         = requestData(5);  // request 5 bytes from the keyscanner
   if (bytes_returned < 5) {
     return false;
   }
@@ -207,49 +218,100 @@ keydata_t Model100Side::getKeyData() {
   return keyData;
 }
 
-void Model100Side::sendLEDData() {
-  sendLEDBank(nextLEDBank++);
-  if (nextLEDBank == LED_BANKS) {
+auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
+
+bool Model100Side::setCrgbAt(uint8_t i, cRGB color) {
+  cRGB &led = ledData.leds[i];
+  if (led.r == color.r && led.g == color.g && led.b == color.b)
+    return false;
+
+  led = color;
+  bitSet(dirty_led_banks_, i / LEDS_PER_BANK);
+  return true;
+}
+
+bool Model100Side::sendLEDData() {
+  // Banks that haven't changed don't need to be sent again, which leaves the
+  // bus free for reading keys.
+  if (dirty_led_banks_ == 0)
+    return false;
+
+  if (sendUniformLEDData())
+    return true;
+
+  while (!bitRead(dirty_led_banks_, nextLEDBank)) {
+    if (++nextLEDBank == LED_BANKS)
+      nextLEDBank = 0;
+  }
+
+  // If the transmission fails, the bank stays dirty, and gets sent again later.
+  if (sendLEDBank(nextLEDBank) == 0)
+    bitClear(dirty_led_banks_, nextLEDBank);
+
+  if (++nextLEDBank == LED_BANKS) {
     nextLEDBank = 0;
   }
+  return true;
 }
 
-auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
+// If every LED on this side has the same color, sets them all with a single
+// command, and returns true. Otherwise, returns false without sending anything.
+bool Model100Side::sendUniformLEDData() {
+  const cRGB &color = ledData.leds[0];
+  for (uint8_t i = 1; i < LEDS_PER_HAND; i++) {
+    const cRGB &led = ledData.leds[i];
+    if (led.r != color.r || led.g != color.g || led.b != color.b)
+      return false;
+  }
+
+  uint8_t data[] = {TWI_CMD_LED_SET_ALL_TO,
+                    pgm_read_byte(&gamma8[adjustBrightness(color.b)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.g)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.r)])};
+  if (writeData(data, ELEMENTS(data)) == 0)
+    dirty_led_banks_ = 0;
+  return true;
+}
+
+/* While the ATTiny controller does have a global brightness command, it is
+ * limited to 32 levels, and those aren't nicely spread out either. For this
+ * reason, we're doing our own brightness adjustment on this side, because
+ * that results in a considerably smoother curve. */
+uint8_t Model100Side::adjustBrightness(uint8_t c) {
+  if (c > brightness_adjustment_)
+    return c - brightness_adjustment_;
+  return 0;
+}
 
-void Model100Side::sendLEDBank(uint8_t bank) {
+uint8_t Model100Side::sendLEDBank(uint8_t bank) {
   uint8_t data[LED_BYTES_PER_BANK + 1];
   data[0] = TWI_CMD_LED_BASE + bank;
   for (uint8_t i = 0; i < LED_BYTES_PER_BANK; i++) {
-    /* While the ATTiny controller does have a global brightness command, it is
-     * limited to 32 levels, and those aren't nicely spread out either. For this
-     * reason, we're doing our own brightness adjustment on this side, because
-     * that results in a considerably smoother curve. */
-    uint8_t c = ledData.bytes[bank][i];
-    if (c > brightness_adjustment_)
-      c -= brightness_adjustment_;
-    else
-      c = 0;
-
-    data[i + 1] = pgm_read_byte(&gamma8[c]);
+    data[i + 1] = pgm_read_byte(&gamma8[adjustBrightness(ledData.bytes[bank][i])]);
   }
-  uint8_t result = writeData(data, ELEMENTS(data));
+  return writeData(data, ELEMENTS(data));
 }
 
+// Both of these keep ledData in step with what the LEDs are showing, so that
+// the next sendLEDData() doesn't overwrite the change with stale colors.
 void Model100Side::setAllLEDsTo(cRGB color) {
-  uint8_t data[] = {TWI_CMD_LED_SET_ALL_TO,
-                    pgm_read_byte(&gamma8[color.b]),
-                    pgm_read_byte(&gamma8[color.g]),
-                    pgm_read_byte(&gamma8[color.r])};
-  uint8_t result = writeData(data, ELEMENTS(data));
+  for (uint8_t i = 0; i < LEDS_PER_HAND; i++)
+    setCrgbAt(i, color);
+  sendUniformLEDData();
 }
 
 void Model100Side::setOneLEDTo(uint8_t led, cRGB color) {
+  // The LED's bank stays dirty, because other LEDs in it may be waiting to be
+  // sent too.
+  if (!setCrgbAt(led, color))
+    return;
+
   uint8_t data[] = {TWI_CMD_LED_SET_ONE_TO,
                     led,
-                    pgm_read_byte(&gamma8[color.b]),
-                    pgm_read_byte(&gamma8[color.g]),
-                    pgm_read_byte(&gamma8[color.r])};
-  uint8_t result = writeData(data, ELEMENTS(data));
+                    pgm_read_byte(&gamma8[adjustBrightness(color.b)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.g)]),
+                    pgm_read_byte(&gamma8[adjustBrightness(color.r)])};
+  writeData(data, ELEMENTS(data));
 }
 
 }  // namespace keyboardio
@@ -129,6 +129,54 @@ void Preonic::triggerBatteryWarning(bool active) {
   }
 }
 
+void Preonic::idleUntilNextDeadline() {
+  uint32_t now = millis();
+
+  // On USB power, there's nothing to save, and the USB serial port needs the
+  // main loop to keep running.
+  if (mcu().USBPowerDetected())
+    return;
+
+  // Held keys and queued events need the matrix scanned and processed
+  if (keyScanner().pressedKeyswitchCount() || keyScanner().hasQueuedEvents())
+    return;
+
+  if (kaleidoscope::driver::hid::bluefruit::blehid.hasQueuedReports())
+    return;
+
+  // LED effects and the speaker are updated from the main loop
+  if (ledDriver().areAnyLEDsOn() || (now - ledDriver().LEDsLastOn()) < 1000)
+    return;
+  if (speaker().isPlaying())
+    return;
+
+  // The time until the next deadline (such as a TapDance timeout) is counted
+  // from the start of the cycle.
+  uint32_t timeout = kaleidoscope::Runtime.millisUntilNextWake();
+  uint32_t elapsed = now - kaleidoscope::Runtime.millisAtCycleStart();
+  timeout          = timeout > elapsed ? timeout - elapsed : 0;
+  // Wake up at least once a second, so battery monitoring and the deep sleep
+  // timeout still run on time.
+  if (timeout > TICKLESS_IDLE_MAX_MS)
+    timeout = TICKLESS_IDLE_MAX_MS;
+  if (timeout == 0)
+    return;
+
+  // Switch from timer driven scanning to sensing key presses on the columns,
+  // like deep sleep does, so the scanner's timer doesn't wake us every 1.5 ms.
+  keyScanner().suspendTimer();
+  keyScanner().prepareToWait();
+  prepareMatrixForSleep();
+  configureColumnsForSensing();
+  setupPPIInterrupt();
+
+  keyScanner().waitForActivity(timeout);
+
+  restoreMatrixAfterSleep();
+  disableColumnSensing();
+  keyScanner().resumeTimer();
+}
+
 /**
  * @brief Puts the system into System OFF mode after thorough peripheral shutdown.
  *
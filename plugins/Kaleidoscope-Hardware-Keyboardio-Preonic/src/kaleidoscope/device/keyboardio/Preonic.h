@@ -294,6 +294,7 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
   static volatile bool input_event_pending_;
   static uint32_t last_battery_update_;                        // Last battery level update time
   static constexpr uint32_t BATTERY_UPDATE_INTERVAL = 300000;  // 5 minutes in milliseconds
+  static constexpr uint32_t TICKLESS_IDLE_MAX_MS    = 1000;    // Longest wait between cycles while idle
 
   // Battery monitoring variables and thresholds
   static uint16_t last_battery_voltage_mv_;
@@ -638,6 +639,15 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
     return true;
   }
 
+  /**
+   * Tickless idle: when nothing needs the main loop to keep running (no keys
+   * held, no LED effects, no sound, no pending reports, and running on battery),
+   * stop the matrix scan timer, and block the main task until a key press is
+   * sensed on the matrix columns, or the next plugin deadline is due. While it
+   * is blocked, FreeRTOS puts the MCU to sleep.
+   */
+  void idleUntilNextDeadline();
+
   /**
    * Check if we should enter deep sleep based on inactivity time
    * Never enter deep sleep if USB is connected
@@ -814,6 +824,18 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
   Preonic() {
   }
 
+  bool scanTiming(driver::keyscanner::ScanTiming &timing) {
+    if (!KeyScannerProps::time_scans)
+      return false;
+    timing = KeyScanner::scanTiming();
+    return true;
+  }
+
+  void resetScanTiming() {
+    if (KeyScannerProps::time_scans)
+      KeyScanner::resetScanTiming();
+  }
+
   /**
    * @brief Handle USB connection status changes for wake-from-sleep
    * @details This provides a safe way to detect USB connections that can wake the device
@@ -843,6 +865,9 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
     // TODO(jesse): move this into a hook
     updateSpeaker();
 
+    // Let the storage do its background work, if any
+    storage().betweenCycles();
+
     // Check for USB power-only state on startup (delegated to MCU driver)
     mcu().checkUSBPowerOnlyStatus();
 
@@ -881,6 +906,10 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
       // Check if we should enter deep sleep
       // Only enter deep sleep if no keys are pressed and we're not connected via USB
       enterDeepSleep();
+    } else {
+      // Between keystrokes, wait for input or the next plugin deadline instead
+      // of spinning through the main loop.
+      idleUntilNextDeadline();
     }
 
     // Note: USB connection state is now tracked via event-driven callbacks in nRF52840.cpp
@@ -977,6 +1006,7 @@ class Preonic : public kaleidoscope::device::Base<PreonicProps> {
  public:
   static void setInputEventPending() {
     input_event_pending_ = true;
+    KeyScanner::wakeFromISR();
   }
 };
 
@@ -32,6 +32,7 @@ uint32_t USBAutoSwitcher::startup_time_       = 0;
 uint16_t USBAutoSwitcher::startup_delay_ms_   = 1000;  // 1 second startup delay
 bool USBAutoSwitcher::startup_switch_done_    = false;
 uint8_t USBAutoSwitcher::current_host_mode_   = MODE_USB;  // Default to USB mode
+Deadline USBAutoSwitcher::startup_deadline_{USBAutoSwitcher::onStartupDeadline};
 
 EventHandlerResult USBAutoSwitcher::onSetup() {
   // Record startup time for delay calculation
@@ -42,27 +43,20 @@ EventHandlerResult USBAutoSwitcher::onSetup() {
   current_host_mode_ = getCurrentHostMode();
 
   // If no USB detected at startup, we'll need to check after delay
-  // For now, we'll use afterEachCycle but only until startup_switch_done_
+  Runtime.armDeadline(startup_deadline_, startup_delay_ms_);
 
   return EventHandlerResult::OK;
 }
 
-EventHandlerResult USBAutoSwitcher::afterEachCycle() {
-  // Immediate return after startup switching is done - minimal overhead
-  if (startup_switch_done_) {
-    return EventHandlerResult::OK;
-  }
+void USBAutoSwitcher::onStartupDeadline() {
+  if (startup_switch_done_)
+    return;
 
-  // Only during first second of operation
-  if ((Runtime.millisAtCycleStart() - startup_time_) >= startup_delay_ms_) {
-    // Check USB status once and switch if needed
-    if (!Runtime.device().mcu().USBPowerDetected()) {
-      switchToFallbackBLE();
-    }
-    startup_switch_done_ = true;
+  // Check USB status once and switch if needed
+  if (!Runtime.device().mcu().USBPowerDetected()) {
+    ::USBAutoSwitcher.switchToFallbackBLE();
   }
-
-  return EventHandlerResult::OK;
+  startup_switch_done_ = true;
 }
 
 EventHandlerResult USBAutoSwitcher::onHostConnectionStatusChanged(uint8_t device_id, HostConnectionStatus status) {
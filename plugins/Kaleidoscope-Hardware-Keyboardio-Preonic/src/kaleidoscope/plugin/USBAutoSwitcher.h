@@ -23,6 +23,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "kaleidoscope/Deadline.h"
 #include "kaleidoscope/plugin.h"
 #include "kaleidoscope/host_connection_status.h"
 #include "kaleidoscope/Runtime.h"
@@ -63,7 +64,6 @@ class USBAutoSwitcher : public kaleidoscope::Plugin {
 
   // Plugin hooks
   EventHandlerResult onSetup();
-  EventHandlerResult afterEachCycle();
   EventHandlerResult onHostConnectionStatusChanged(uint8_t device_id, HostConnectionStatus status);
 
  private:
@@ -72,6 +72,12 @@ class USBAutoSwitcher : public kaleidoscope::Plugin {
   static uint16_t startup_delay_ms_;    // Delay before auto-switching starts
   static bool startup_switch_done_;     // Prevent multiple startup switches
   static uint8_t current_host_mode_;    // Track current connection mode
+  static Deadline startup_deadline_;    // Expires when the startup delay is over
+
+  /**
+   * @brief Switch to BLE at the end of the startup delay, if there's no USB
+   */
+  static void onStartupDeadline();
 
   /**
    * @brief Check if we're still within the startup delay period
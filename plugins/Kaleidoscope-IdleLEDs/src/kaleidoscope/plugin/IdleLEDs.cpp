@@ -23,6 +23,7 @@
 #include <Kaleidoscope-FocusSerial.h>      // for Focus, FocusSerial
 #include <stdint.h>                        // for uint32_t, uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"         // for VirtualProps::Storage, Base<>::Storage
@@ -35,6 +36,7 @@ namespace plugin {
 uint32_t IdleLEDs::idle_time_limit = 600000;  // 10 minutes
 uint32_t IdleLEDs::start_time_     = 0;
 bool IdleLEDs::idle_;
+Deadline IdleLEDs::idle_deadline_{IdleLEDs::onIdleDeadline};
 
 uint32_t IdleLEDs::idleTimeoutSeconds() {
   return idle_time_limit / 1000;
@@ -42,18 +44,27 @@ uint32_t IdleLEDs::idleTimeoutSeconds() {
 
 void IdleLEDs::setIdleTimeoutSeconds(uint32_t new_limit) {
   idle_time_limit = new_limit * 1000;
+  armIdleDeadline();
 }
 
-EventHandlerResult IdleLEDs::beforeEachCycle() {
-  if (idle_time_limit == 0)
-    return EventHandlerResult::OK;
+void IdleLEDs::armIdleDeadline() {
+  if (idle_time_limit == 0) {
+    Runtime.cancelDeadline(idle_deadline_);
+    return;
+  }
+  // The timeout counts from the last key event, not from now.
+  Runtime.armDeadline(idle_deadline_, Runtime.millisUntilTimeExpires(start_time_, idle_time_limit));
+}
 
-  if (::LEDControl.isEnabled() &&
-      Runtime.hasTimeExpired(start_time_, idle_time_limit)) {
+void IdleLEDs::onIdleDeadline() {
+  if (::LEDControl.isEnabled()) {
     ::LEDControl.disable();
     idle_ = true;
   }
+}
 
+EventHandlerResult IdleLEDs::onSetup() {
+  armIdleDeadline();
   return EventHandlerResult::OK;
 }
 
@@ -64,6 +75,7 @@ EventHandlerResult IdleLEDs::onKeyEvent(KeyEvent &event) {
   }
 
   start_time_ = Runtime.millisAtCycleStart();
+  armIdleDeadline();
 
   return EventHandlerResult::OK;
 }
@@ -87,7 +99,7 @@ EventHandlerResult PersistentIdleLEDs::onSetup() {
   } else {
     IdleLEDs::setIdleTimeoutSeconds(idle_time);
   }
-  return EventHandlerResult::OK;
+  return IdleLEDs::onSetup();
 }
 
 void PersistentIdleLEDs::setIdleTimeoutSeconds(uint32_t new_limit) {
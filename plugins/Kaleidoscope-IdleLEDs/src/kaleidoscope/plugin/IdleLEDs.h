@@ -20,6 +20,7 @@
 
 #include <stdint.h>  // for uint32_t, uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -34,12 +35,16 @@ class IdleLEDs : public kaleidoscope::Plugin {
   static uint32_t idleTimeoutSeconds();
   static void setIdleTimeoutSeconds(uint32_t new_limit);
 
-  EventHandlerResult beforeEachCycle();
+  EventHandlerResult onSetup();
   EventHandlerResult onKeyEvent(KeyEvent &event);
 
  private:
   static bool idle_;
   static uint32_t start_time_;
+  static Deadline idle_deadline_;
+
+  static void armIdleDeadline();
+  static void onIdleDeadline();
 };
 
 class PersistentIdleLEDs : public IdleLEDs {
@@ -28,7 +28,9 @@
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr, MatrixAddr, MatrixAddr<>::Range
 #include "kaleidoscope/KeyAddrBitfield.h"       // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
+#include "kaleidoscope/LEDBitfield.h"           // for LEDBitfield
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
+#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"         // for CRGB, cRGB
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/key_defs.h"              // for Key, Key_Inactive, Key_Masked
@@ -39,12 +41,20 @@ namespace kaleidoscope {
 namespace plugin {
 
 KeyAddrBitfield ActiveModColorEffect::mod_key_bits_;
+LEDBitfield ActiveModColorEffect::oneshot_leds_;
+LEDBitfield ActiveModColorEffect::sticky_leds_;
 bool ActiveModColorEffect::highlight_normal_modifiers_ = true;
 
 cRGB ActiveModColorEffect::highlight_color_ = CRGB(160, 160, 160);
 cRGB ActiveModColorEffect::oneshot_color_   = CRGB(160, 160, 0);
 cRGB ActiveModColorEffect::sticky_color_    = CRGB(160, 0, 0);
 
+// -----------------------------------------------------------------------------
+EventHandlerResult ActiveModColorEffect::onSetup() {
+  ::LEDControl.addLayer(*this);
+  return EventHandlerResult::OK;
+}
+
 // -----------------------------------------------------------------------------
 EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
 
@@ -63,11 +73,9 @@ EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
       mod_key_bits_.set(event.addr);
     }
     if (event.key == OneShot_ActiveStickyKey) {
-      for (KeyAddr entry_addr : KeyAddr::all()) {
-        // Get the entry from the live keys array
-        Key entry_key = live_keys[entry_addr];
-        // Skip empty entries
-        if (entry_key == Key_Inactive || entry_key == Key_Masked) {
+      for (KeyAddr entry_addr : live_keys.active()) {
+        // Skip masked entries (idle ones aren't visited at all)
+        if (live_keys[entry_addr] == Key_Masked) {
           continue;
         }
         // Highlight everything else
@@ -80,7 +88,7 @@ EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
     // release event before we see it here.
     if (mod_key_bits_.read(event.addr) && !::OneShot.isActive(event.addr)) {
       mod_key_bits_.clear(event.addr);
-      ::LEDControl.refreshAt(event.addr);
+      uncover(event.addr);
     }
   }
 
@@ -91,23 +99,45 @@ EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
 EventHandlerResult ActiveModColorEffect::beforeSyncingLeds() {
 
   // This loop iterates through only the `key_addr`s that have their bits in the
-  // `mod_key_bits_` bitfield set.
+  // `mod_key_bits_` bitfield set. The layer covers their LEDs, and only the
+  // ones whose kind of highlight changed need to be composited again.
   for (KeyAddr key_addr : mod_key_bits_) {
-    if (::OneShot.isTemporary(key_addr)) {
-      // Temporary OneShot keys get one color:
-      ::LEDControl.setCrgbAt(key_addr, oneshot_color_);
-    } else if (::OneShot.isSticky(key_addr)) {
-      // Sticky OneShot keys get another color:
-      ::LEDControl.setCrgbAt(key_addr, sticky_color_);
-    } else if (highlight_normal_modifiers_) {
-      // Normal modifiers get a third color:
-      ::LEDControl.setCrgbAt(key_addr, highlight_color_);
+    uint8_t led_index = Runtime.device().getLedIndex(key_addr);
+    if (led_index >= LEDBitfield::size)
+      continue;
+
+    bool oneshot = ::OneShot.isTemporary(key_addr);
+    bool sticky  = !oneshot && ::OneShot.isSticky(key_addr);
+    if (!oneshot && !sticky && !highlight_normal_modifiers_) {
+      uncover(led_index);
+      continue;
+    }
+
+    cover(led_index);
+    if (oneshot != oneshot_leds_.read(led_index) ||
+        sticky != sticky_leds_.read(led_index)) {
+      oneshot_leds_.write(led_index, oneshot);
+      sticky_leds_.write(led_index, sticky);
+      refresh(led_index);
     }
   }
 
   return EventHandlerResult::OK;
 }
 
+// -----------------------------------------------------------------------------
+cRGB ActiveModColorEffect::colorAt(uint8_t led_index) {
+  if (oneshot_leds_.read(led_index)) {
+    // Temporary OneShot keys get one color:
+    return oneshot_color_;
+  } else if (sticky_leds_.read(led_index)) {
+    // Sticky OneShot keys get another color:
+    return sticky_color_;
+  }
+  // Normal modifiers get a third color:
+  return highlight_color_;
+}
+
 }  // namespace plugin
 }  // namespace kaleidoscope
 
@@ -22,17 +22,20 @@
 
 #pragma once
 
-#include "kaleidoscope/KeyAddrBitfield.h"       // for KeyAddrBitfield
-#include "kaleidoscope/KeyEvent.h"              // for KeyEvent
-#include "kaleidoscope/device/device.h"         // for cRGB
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope/KeyAddrBitfield.h"             // for KeyAddrBitfield
+#include "kaleidoscope/KeyEvent.h"                    // for KeyEvent
+#include "kaleidoscope/LEDBitfield.h"                 // for LEDBitfield
+#include "kaleidoscope/device/device.h"               // for cRGB
+#include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                      // for Plugin
+#include "kaleidoscope/plugin/LEDControl/LEDLayer.h"  // for LEDLayer
 
 #define MAX_MODS_PER_LAYER 16
 
 namespace kaleidoscope {
 namespace plugin {
-class ActiveModColorEffect : public kaleidoscope::Plugin {
+class ActiveModColorEffect : public kaleidoscope::Plugin,
+                             public LEDLayer {
  public:
   static void setHighlightColor(cRGB color) {
     highlight_color_ = color;
@@ -48,13 +51,21 @@ class ActiveModColorEffect : public kaleidoscope::Plugin {
     highlight_normal_modifiers_ = value;
   }
 
+  EventHandlerResult onSetup();
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult beforeSyncingLeds();
 
+  cRGB colorAt(uint8_t led_index) final;
+
  private:
   static bool highlight_normal_modifiers_;
   static KeyAddrBitfield mod_key_bits_;
 
+  // The highlighted LEDs of temporary and sticky OneShot keys; the others
+  // covered by the layer are normal modifiers.
+  static LEDBitfield oneshot_leds_;
+  static LEDBitfield sticky_leds_;
+
   static cRGB highlight_color_;
   static cRGB oneshot_color_;
   static cRGB sticky_color_;
@@ -25,6 +25,7 @@
 #include <Arduino.h>                       // for PSTR
 #include <Kaleidoscope-EEPROM-Settings.h>  // for EEPROMSettings
 #include <Kaleidoscope-FocusSerial.h>      // for Focus, FocusSerial
+#include <stddef.h>                        // for offsetof
 #include <stdint.h>                        // for uint8_t, uint16_t
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
@@ -125,6 +126,19 @@ void LEDPaletteTheme::updatePaletteColor(uint8_t palette_index, cRGB color) {
   Runtime.storage().put(palette_base_ + palette_index * sizeof(color), color);
 }
 
+// Stores the colors of a binary `palette` upload, which are sent the same way
+// as in text: as R, G and B bytes, regardless of the order of the components
+// in `cRGB`.
+void LEDPaletteTheme::storePaletteFrame(uint16_t offset, const uint8_t *data, uint8_t length) {
+  static const uint8_t component_offsets[] = {offsetof(cRGB, r), offsetof(cRGB, g), offsetof(cRGB, b)};
+
+  for (uint8_t i = 0; i < length; i++) {
+    uint16_t n = offset + i;
+    Runtime.storage().update(palette_base_ + (n / 3) * sizeof(cRGB) + component_offsets[n % 3],
+                             data[i] ^ 0xff);
+  }
+}
+
 bool LEDPaletteTheme::isThemeUninitialized(uint16_t theme_base, uint8_t max_themes) {
   bool paletteEmpty = Runtime.storage().isSliceUninitialized(palette_base_, palette_size_ * sizeof(cRGB));
   bool themeEmpty   = Runtime.storage().isSliceUninitialized(theme_base, max_themes * Runtime.device().led_count / 2);
@@ -158,6 +172,13 @@ EventHandlerResult LEDPaletteTheme::onFocusEvent(const char *input) {
     return EventHandlerResult::EVENT_CONSUMED;
   }
 
+  if (::Focus.isBinary()) {
+    ::Focus.receiveFrames(palette_size_ * 3, storePaletteFrame);
+    Runtime.storage().commit();
+    ::LEDControl.refreshAll();
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
   uint8_t i = 0;
   while (i < palette_size_ && !::Focus.isEOL()) {
     cRGB color;
@@ -197,6 +218,15 @@ EventHandlerResult LEDPaletteTheme::themeFocusEvent(const char *input,
     return EventHandlerResult::EVENT_CONSUMED;
   }
 
+  if (::Focus.isBinary()) {
+    // The frames hold the theme as it is laid out in storage: two color
+    // indexes per byte, the first one in the high nibble.
+    ::Focus.receiveFramesIntoStorage(theme_base, max_index);
+    Runtime.storage().commit();
+    ::LEDControl.refreshAll();
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
   uint16_t pos = 0;
 
   while (!::Focus.isEOL() && (pos < max_index)) {
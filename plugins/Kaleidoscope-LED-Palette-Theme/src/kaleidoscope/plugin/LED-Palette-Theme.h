@@ -58,6 +58,8 @@ class LEDPaletteTheme : public kaleidoscope::Plugin {
  private:
   static uint16_t palette_base_;
   static uint8_t palette_size_;
+
+  static void storePaletteFrame(uint16_t offset, const uint8_t *data, uint8_t length);
 };
 
 }  // namespace plugin
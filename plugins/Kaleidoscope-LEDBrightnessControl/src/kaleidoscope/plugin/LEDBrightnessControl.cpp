@@ -42,8 +42,8 @@ EventHandlerResult LEDBrightnessControl::onKeyEvent(KeyEvent &event) {
     uint8_t brightness = LEDControl::getBrightness();
     bool increase      = (event.key == Key_LEDBrightnessUp);
 
-    for (Key active_key : live_keys.all()) {
-      if (active_key.isKeyboardShift()) {
+    for (KeyAddr key_addr : live_keys.active()) {
+      if (live_keys[key_addr].isKeyboardShift()) {
         increase = !increase;
         break;
       }
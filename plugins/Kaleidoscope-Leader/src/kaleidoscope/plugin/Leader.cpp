@@ -22,10 +22,10 @@
 
 #include "kaleidoscope/plugin/Leader.h"
 
-#include <Arduino.h>                   // for F, __FlashStringHelper, pgm_read_ptr
+#include <Arduino.h>                   // for F, __FlashStringHelper, pgm_read_ptr, pgm_read_word
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <Kaleidoscope-Ranges.h>       // for LEAD_FIRST, LEAD_LAST
-#include <stdint.h>                    // for uint16_t, uint8_t, int8_t
+#include <stdint.h>                    // for uint16_t, uint8_t, int16_t
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
@@ -52,10 +52,35 @@ uint16_t Leader::time_out = 1000;
 #define isActive()    (sequence_[0] != Key_NoKey)
 
 // --- actions ---
-int8_t Leader::lookup() {
+
+// Follows the index from the first sequence that matches the keys before the
+// last one, until it finds one that matches the last key too.
+void Leader::advanceMatch() {
+  Key key    = sequence_[sequence_pos_];
+  uint16_t i = match_;
+
+  while (i != leader::kNoSequence &&
+         dictionary[i].sequence[sequence_pos_].readFromProgmem() != key)
+    i = pgm_read_word(&nodes_[i].next[sequence_pos_]);
+
+  match_ = i;
+}
+
+int16_t Leader::lookup() {
+  if (isIndexed()) {
+    advanceMatch();
+    if (match_ == leader::kNoSequence)
+      return NO_MATCH;
+    if (dictionary[match_].sequence[sequence_pos_ + 1].readFromProgmem() == Key_NoKey)
+      return match_;
+    return PARTIAL_MATCH;
+  }
+
   bool match;
 
-  for (uint8_t seq_index = 0;; seq_index++) {
+  // Sequences past `LEADER_MAX_SEQUENCES` couldn't be told apart by their
+  // actions, so they're never matched.
+  for (uint16_t seq_index = 0; seq_index < LEADER_MAX_SEQUENCES; seq_index++) {
     match = true;
 
     if (dictionary[seq_index].sequence[0].readFromProgmem() == Key_NoKey)
@@ -88,10 +113,17 @@ int8_t Leader::lookup() {
 // --- api ---
 
 void Leader::reset() {
+  Runtime.cancelDeadline(timeout_deadline_);
   sequence_pos_ = 0;
   sequence_[0]  = Key_NoKey;
 }
 
+void Leader::setDictionary(const dictionary_t *const *sequences, const leader::Node *nodes) {
+  dictionary          = (const dictionary_t *)pgm_read_ptr(sequences);
+  indexed_dictionary_ = dictionary;
+  nodes_              = nodes;
+}
+
 #ifndef NDEPRECATED
 void Leader::inject(Key key, uint8_t key_state) {
   Runtime.handleKeyEvent(KeyEvent(KeyAddr::none(), key_state | INJECTED, key));
@@ -120,6 +152,12 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     sequence_pos_            = 0;
     sequence_[sequence_pos_] = event.key;
 
+    if (isIndexed()) {
+      match_ = 0;
+      advanceMatch();
+    }
+
+    armTimeoutDeadline();
     return EventHandlerResult::ABORT;
   }
 
@@ -131,13 +169,14 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
 
   start_time_              = Runtime.millisAtCycleStart();
   sequence_[sequence_pos_] = event.key;
-  int8_t action_index      = lookup();
+  int16_t action_index     = lookup();
 
   if (action_index == NO_MATCH) {
     reset();
     return EventHandlerResult::OK;
   }
   if (action_index == PARTIAL_MATCH) {
+    armTimeoutDeadline();
     return EventHandlerResult::ABORT;
   }
 
@@ -148,22 +187,38 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
   return EventHandlerResult::ABORT;
 }
 
-EventHandlerResult Leader::afterEachCycle() {
-  if (!isActive())
-    return EventHandlerResult::OK;
+// --- timeout ---
 
+uint16_t Leader::currentTimeout() const {
 #ifndef NDEPRECATED
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time_, time_out))
-    reset();
+  return time_out;
 #pragma GCC diagnostic pop
 #else
-  if (Runtime.hasTimeExpired(start_time_, timeout_))
-    reset();
+  return timeout_;
 #endif
+}
+
+// The sequence times out when no key has been added to it for the timeout.
+void Leader::armTimeoutDeadline() {
+  Runtime.armDeadline(timeout_deadline_, Runtime.millisUntilTimeExpires(start_time_, currentTimeout()));
+}
 
-  return EventHandlerResult::OK;
+void Leader::onTimeoutDeadline() {
+  ::Leader.resetIfTimedOut();
+}
+
+void Leader::resetIfTimedOut() {
+  if (!isActive())
+    return;
+
+  // Check the timeout again, in case it was changed since the deadline was armed
+  if (Runtime.hasTimeExpired(start_time_, currentTimeout())) {
+    reset();
+  } else {
+    armTimeoutDeadline();
+  }
 }
 
 }  // namespace plugin
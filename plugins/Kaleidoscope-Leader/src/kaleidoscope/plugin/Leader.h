@@ -24,8 +24,9 @@
 
 #include <Kaleidoscope-Ranges.h>  // for LEAD_FIRST
 #include <stddef.h>               // for NULL
-#include <stdint.h>               // for uint16_t, uint8_t, int8_t
+#include <stdint.h>               // for uint16_t, uint8_t, int16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
@@ -48,6 +49,10 @@
 
 #define LEADER_MAX_SEQUENCE_LENGTH 4
 
+// Actions get the index of their sequence as an 8-bit number, so a dictionary
+// can't hold more sequences than this.
+#define LEADER_MAX_SEQUENCES 256
+
 #define LEAD(n)                    kaleidoscope::plugin::LeaderKey(n)
 
 #define LEADER_SEQ(...) \
@@ -59,6 +64,15 @@
     }                    \
   }
 
+// Defines `name` as a dictionary of the given sequences, indexed at compile
+// time, to be used with `Leader.setDictionary(name)`.
+#define LEADER_DICTIONARY(name, ...)                                         \
+  static constexpr kaleidoscope::plugin::Leader::dictionary_t                \
+    name##_sequences[] PROGMEM = LEADER_DICT(__VA_ARGS__);                   \
+  static constexpr kaleidoscope::plugin::leader::Dictionary<                 \
+    sizeof(name##_sequences) / sizeof(name##_sequences[0])>                  \
+    name PROGMEM = kaleidoscope::plugin::leader::makeDictionary(name##_sequences)
+
 namespace kaleidoscope {
 namespace plugin {
 
@@ -66,6 +80,12 @@ constexpr Key LeaderKey(uint8_t n) {
   return Key(kaleidoscope::ranges::LEAD_FIRST + n);
 }
 
+namespace leader {
+struct Node;
+template<uint16_t _size>
+struct Dictionary;
+}  // namespace leader
+
 class Leader : public kaleidoscope::Plugin {
  public:
   typedef void (*action_t)(uint8_t seq_index);
@@ -76,6 +96,15 @@ class Leader : public kaleidoscope::Plugin {
 
   const dictionary_t *dictionary;
 
+  // Uses a dictionary defined with `LEADER_DICTIONARY()`. Instead of comparing
+  // the keys typed so far with every sequence on each key press, the plugin
+  // follows the index built for it, and only compares the new key with the
+  // ones that can follow the keys before it.
+  template<uint16_t _size>
+  void setDictionary(const leader::Dictionary<_size> &indexed_dictionary) {
+    setDictionary(&indexed_dictionary.sequences, indexed_dictionary.nodes);
+  }
+
   void reset();
 
 #ifndef NDEPRECATED
@@ -98,7 +127,6 @@ class Leader : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  private:
   Key sequence_[LEADER_MAX_SEQUENCE_LENGTH + 1];
@@ -107,9 +135,215 @@ class Leader : public kaleidoscope::Plugin {
   uint16_t start_time_ = 0;
   uint16_t timeout_    = 1000;
 
-  int8_t lookup();
+  // Expires when the current sequence times out
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
+  // The index of `dictionary`, if it was set with `setDictionary()`
+  const dictionary_t *indexed_dictionary_ = nullptr;
+  const leader::Node *nodes_              = nullptr;
+  // The first sequence that starts with the keys in `sequence_`
+  uint16_t match_ = 0;
+
+  void setDictionary(const dictionary_t *const *sequences, const leader::Node *nodes);
+  bool isIndexed() const {
+    return nodes_ != nullptr && dictionary == indexed_dictionary_;
+  }
+  void advanceMatch();
+  int16_t lookup();
+  uint16_t currentTimeout() const;
+  void armTimeoutDeadline();
+  static void onTimeoutDeadline();
+  void resetIfTimedOut();
+};
+
+namespace leader {
+
+// The index of a dictionary tells, for every sequence and position in it, the
+// next sequence that starts with the same keys before that position, and is
+// the first one to have its key at that position. Following these links from
+// the first sequence that matches the keys typed so far visits every key that
+// can come next once, in dictionary order.
+static constexpr uint16_t kNoSequence = 0xffff;
+
+struct Node {
+  uint16_t next[LEADER_MAX_SEQUENCE_LENGTH + 1];
+};
+
+template<uint16_t _size>
+struct Dictionary {
+  const Leader::dictionary_t *sequences;
+  Node nodes[_size];  // NOLINT(runtime/arrays)
+};
+
+// Everything below builds the index at compile time.
+
+typedef Leader::dictionary_t Sequence;
+
+template<uint16_t... _indices>
+struct Indices {};
+
+template<uint16_t _count, uint16_t... _indices>
+struct MakeIndices : MakeIndices<_count - 1, _count - 1, _indices...> {};
+
+template<uint16_t... _indices>
+struct MakeIndices<0, _indices...> {
+  typedef Indices<_indices...> type;
+};
+
+// For every sequence, the first sequence that starts with the same `length`
+// keys as it does. Sequences that start with the same keys share this number,
+// so it stands for the prefix in the comparisons below.
+template<uint16_t _size>
+struct PrefixHeads {
+  uint16_t first[_size];  // NOLINT(runtime/arrays)
+};
+
+// The searches below split their range in halves, to keep the recursion depth
+// well below the compiler's limit for large dictionaries, and stop at the first
+// match.
+
+// The first sequence in [lo, hi) that starts with the same `length` keys as
+// `j`, given the same for `length - 1` keys in `shorter`
+template<uint16_t _size>
+constexpr uint16_t firstWithPrefix(const Sequence *d, const PrefixHeads<_size> &shorter,
+                                   uint16_t j, uint8_t length, uint16_t lo, uint16_t hi);
+
+template<uint16_t _size>
+constexpr uint16_t firstWithPrefixOr(uint16_t found, const Sequence *d,
+                                     const PrefixHeads<_size> &shorter,
+                                     uint16_t j, uint8_t length, uint16_t lo, uint16_t hi) {
+  return found != kNoSequence ? found : firstWithPrefix(d, shorter, j, length, lo, hi);
+}
+
+template<uint16_t _size>
+constexpr uint16_t firstWithPrefix(const Sequence *d, const PrefixHeads<_size> &shorter,
+                                   uint16_t j, uint8_t length, uint16_t lo, uint16_t hi) {
+  return hi <= lo ? kNoSequence
+         : hi - lo == 1
+           ? (shorter.first[lo] == shorter.first[j] &&
+                  d[lo].sequence[length - 1] == d[j].sequence[length - 1]
+                ? lo
+                : kNoSequence)
+           : firstWithPrefixOr(firstWithPrefix(d, shorter, j, length, lo, lo + (hi - lo) / 2),
+                               d, shorter, j, length, lo + (hi - lo) / 2, hi);
+}
+
+template<uint16_t _size, uint16_t... _sequences>
+constexpr PrefixHeads<_size> makePrefixHeads(const Sequence *d, const PrefixHeads<_size> &shorter,
+                                             uint8_t length, Indices<_sequences...>) {
+  // No sequence before the first one with the same `length - 1` keys can have
+  // the same `length` keys.
+  return PrefixHeads<_size>{
+    {firstWithPrefix(d, shorter, _sequences, length, shorter.first[_sequences], _sequences + 1)...}};
+}
+
+// The prefix heads for every length up to `_length`
+template<uint16_t _size, uint8_t _length>
+struct PrefixTable {
+  PrefixTable<_size, _length - 1> shorter;
+  PrefixHeads<_size> heads;
+
+  constexpr const PrefixHeads<_size> &operator[](uint8_t length) const {
+    return length == _length ? heads : shorter[length];
+  }
 };
 
+template<uint16_t _size>
+struct PrefixTable<_size, 0> {
+  PrefixHeads<_size> heads;
+
+  constexpr const PrefixHeads<_size> &operator[](uint8_t) const {
+    return heads;
+  }
+};
+
+// All sequences start with the same zero keys. (The pack only provides the
+// number of entries.)
+template<uint16_t _size, uint16_t... _sequences>
+constexpr PrefixTable<_size, 0> makePrefixTable(const Sequence *, Indices<_sequences...>,
+                                                const PrefixTable<_size, 0> *) {
+  return PrefixTable<_size, 0>{{{uint16_t(_sequences * 0)...}}};
+}
+
+template<uint16_t _size, uint8_t _length, uint16_t... _sequences>
+constexpr PrefixTable<_size, _length> extendPrefixTable(const Sequence *d,
+                                                        const PrefixTable<_size, _length - 1> &shorter,
+                                                        Indices<_sequences...> sequences) {
+  return PrefixTable<_size, _length>{
+    shorter, makePrefixHeads(d, shorter.heads, _length, sequences)};
+}
+
+template<uint16_t _size, uint8_t _length, uint16_t... _sequences>
+constexpr PrefixTable<_size, _length> makePrefixTable(const Sequence *d,
+                                                      Indices<_sequences...> sequences,
+                                                      const PrefixTable<_size, _length> *) {
+  return extendPrefixTable<_size, _length>(
+    d,
+    makePrefixTable(d, sequences, static_cast<const PrefixTable<_size, _length - 1> *>(nullptr)),
+    sequences);
+}
+
+constexpr uint16_t firstOf(uint16_t a, uint16_t b) {
+  return a != kNoSequence ? a : b;
+}
+
+// The first sequence in [lo, hi) that starts with the same `position` keys as
+// `j`, and is the first one with its key at `position` among those
+template<uint16_t _size>
+constexpr uint16_t nextBranch(const PrefixHeads<_size> &prefix, const PrefixHeads<_size> &branch,
+                              uint16_t j, uint16_t lo, uint16_t hi);
+
+template<uint16_t _size>
+constexpr uint16_t nextBranchOr(uint16_t found,
+                                const PrefixHeads<_size> &prefix, const PrefixHeads<_size> &branch,
+                                uint16_t j, uint16_t lo, uint16_t hi) {
+  return found != kNoSequence ? found : nextBranch(prefix, branch, j, lo, hi);
+}
+
+template<uint16_t _size>
+constexpr uint16_t nextBranch(const PrefixHeads<_size> &prefix, const PrefixHeads<_size> &branch,
+                              uint16_t j, uint16_t lo, uint16_t hi) {
+  return hi <= lo ? kNoSequence
+         : hi - lo == 1
+           ? (prefix.first[lo] == prefix.first[j] && branch.first[lo] == lo ? lo : kNoSequence)
+           : nextBranchOr(nextBranch(prefix, branch, j, lo, lo + (hi - lo) / 2),
+                          prefix, branch, j, lo + (hi - lo) / 2, hi);
+}
+
+// Only the links of sequences that are the first with their key at a position
+// are ever followed, the others are left empty.
+template<uint16_t _size, uint8_t _length, uint16_t... _positions>
+constexpr Node makeNode(const PrefixTable<_size, _length> &prefixes,
+                        uint16_t count, uint16_t j, Indices<_positions...>) {
+  return Node{{(prefixes[_positions + 1].first[j] == j
+                  ? nextBranch(prefixes[_positions], prefixes[_positions + 1], j, j + 1, count)
+                  : kNoSequence)...}};
+}
+
+template<uint16_t _size, uint8_t _length, uint16_t... _sequences>
+constexpr Dictionary<_size> makeDictionary(const Sequence *d,
+                                           const PrefixTable<_size, _length> &prefixes,
+                                           Indices<_sequences...>) {
+  // The last entry is the end marker added by `LEADER_DICT()`.
+  return Dictionary<_size>{
+    d,
+    {makeNode(prefixes, _size - 1, _sequences,
+              typename MakeIndices<LEADER_MAX_SEQUENCE_LENGTH + 1>::type())...}};
+}
+
+template<uint16_t _size>
+constexpr Dictionary<_size> makeDictionary(const Sequence (&d)[_size]) {
+  static_assert(_size - 1 <= LEADER_MAX_SEQUENCES,
+                "A Leader dictionary can't hold more than LEADER_MAX_SEQUENCES sequences");
+  return makeDictionary(
+    d,
+    makePrefixTable(d, typename MakeIndices<_size>::type(),
+                    static_cast<const PrefixTable<_size, LEADER_MAX_SEQUENCE_LENGTH + 1> *>(nullptr)),
+    typename MakeIndices<_size>::type());
+}
+
+}  // namespace leader
+
 }  // namespace plugin
 }  // namespace kaleidoscope
 
@@ -149,6 +149,7 @@ EventHandlerResult LongPress::onKeyswitchEvent(KeyEvent &event) {
     // be auto-shifted, so we add it to the queue and defer processing of
     // the event.
     queue_.append(event);
+    Runtime.armDeadline(timeout_deadline_, settings_.timeout);
     return EventHandlerResult::ABORT;
   }
 
@@ -196,17 +197,11 @@ bool LongPress::isExplicitlyMapped(KeyAddr addr, Key key) {
 
 
 // -----------------------------------------------------------------------------
-EventHandlerResult LongPress::afterEachCycle() {
-  // If there's a pending LongPress event, and it has timed out, we need to
-  // release the event with the `shift` flag applied.
-  if (!queue_.isEmpty() &&
-      Runtime.hasTimeExpired(queue_.timestamp(0), settings_.timeout)) {
-    // Toggle the state of the `SHIFT_HELD` bit in the modifier flags for the
-    // key for the pending event.
-    flushEvent(true);
-    flushQueue();
-  }
-  return EventHandlerResult::OK;
+void LongPress::onTimeoutDeadline() {
+  // The pending LongPress event has timed out, so we need to release the event
+  // with the `shift` flag applied.
+  ::LongPress.flushEvent(true);
+  ::LongPress.flushQueue();
 }
 
 void LongPress::flushQueue() {
@@ -217,6 +212,7 @@ void LongPress::flushQueue() {
       return;
     }
   }
+  Runtime.cancelDeadline(timeout_deadline_);
 }
 
 bool LongPress::checkForRelease() const {
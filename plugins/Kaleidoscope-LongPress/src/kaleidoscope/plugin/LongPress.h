@@ -24,6 +24,7 @@
 
 #include <stdint.h>  // for uint8_t, uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
@@ -191,7 +192,6 @@ class LongPress : public Plugin {
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
   template<uint8_t _explicitmappings_count>
   void configureLongPresses(LongPressKey const (&explicitmappings)[_explicitmappings_count]) {
@@ -229,7 +229,12 @@ class LongPress : public Plugin {
   // of `KeyAddr::none()`, so the plugin will start in an inactive state.
   KeyEvent pending_event_;
 
+  // Expires when the pending keypress has been held long enough to become a
+  // long press
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
   void flushQueue();
+  static void onTimeoutDeadline();
   void flushEvent(bool is_long_press = false);
   bool checkForRelease() const;
 
@@ -22,16 +22,21 @@
 
 #include "kaleidoscope/plugin/MacroSupport.h"
 
-#include <Arduino.h>                   // for F, __FlashStringHelper
+#include <Arduino.h>                   // for F, __FlashStringHelper, pgm_read_byte
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
-#include <stdint.h>                    // for uint8_t
+#include <stdint.h>                    // for uint8_t, uint16_t, uintptr_t, UINTPTR_MAX
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"         // for VirtualProps::Storage, Base<>::Storage
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
 #include "kaleidoscope/keyswitch_state.h"       // for INJECTED, IS_PRESSED, WAS_PRESSED
+// This is a special exception to the rule of only including a plugin's
+// top-level header file, because MacroSupport doesn't depend on the Macros
+// plugin itself; it's just using the same macro step definitions.
+#include "kaleidoscope/plugin/Macros/MacroSteps.h"  // for macro_t, MACRO_ACTION_END, MACRO_ACTION_STEP_...
 
 // =============================================================================
 // `Macros` plugin code
@@ -68,12 +73,15 @@ void MacroSupport::release(Key key) {
 }
 
 void MacroSupport::clear() {
-  // Clear the active macro keys array.
+  // Clear the active macro keys array. As in `release()`, each key must be
+  // removed from the array before its release event is sent, or it will get
+  // inserted into the report anyway.
   for (Key &macro_key : active_macro_keys_) {
     if (macro_key == Key_NoKey)
       continue;
-    Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), release_state, macro_key});
+    Key key   = macro_key;
     macro_key = Key_NoKey;
+    Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), release_state, key});
   }
 }
 
@@ -84,17 +92,226 @@ void MacroSupport::tap(Key key) const {
   Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), press_state, key});
   // Because some HID implementations coalesce reports sent within a short
   // period of time, we need to insert a small delay between programmatic press and
-  // release events.
-  // In particular, Windows BLE HID can turn a press and release inside the same
-  // transmission interval into a no-op, causing dropped keystrokes.
-
-  delay(25);
+  // release events (see `MACRO_TAP_RELEASE_DELAY`).
+  delay(MACRO_TAP_RELEASE_DELAY);
   Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), release_state, key});
 }
 
+// Presses the key of a tap step. `run()` releases it once
+// `MACRO_TAP_RELEASE_DELAY` has passed, instead of waiting here. Until then, it
+// is held like the keys of `press()` steps, so that other events don't drop it
+// from the report.
+void MacroSupport::startTap(Key key) {
+  press(key);
+  pending_release_ = key;
+}
+
+// -----------------------------------------------------------------------------
+// Macro sequence playback
+
+bool MacroSupport::play(const uint8_t *macro) {
+  if (macro == MACRO_NONE)
+    return true;
+  return enqueue(reinterpret_cast<uintptr_t>(macro), UINTPTR_MAX, false);
+}
+
+bool MacroSupport::playFromStorage(uint16_t start, uint16_t end) {
+  return enqueue(start, end, true);
+}
+
+void MacroSupport::abort() {
+  Runtime.cancelDeadline(step_deadline_);
+  queue_length_    = 0;
+  interval_        = 0;
+  tap_sequence_    = MACRO_ACTION_END;
+  wait_            = 0;
+  pending_release_ = Key_NoKey;
+  clear_when_done_ = false;
+  clear();
+}
+
+void MacroSupport::clearWhenDone() {
+  if (isPlaying()) {
+    clear_when_done_ = true;
+  } else {
+    clear();
+  }
+}
+
+bool MacroSupport::enqueue(uintptr_t pos, uintptr_t end, bool in_storage) {
+  if (queue_length_ == MAX_QUEUED_MACROS)
+    return false;
+
+  Sequence &sequence = queue_[(queue_head_ + queue_length_) % MAX_QUEUED_MACROS];
+  sequence.pos        = pos;
+  sequence.end        = end;
+  sequence.in_storage = in_storage;
+  ++queue_length_;
+
+  // Play the start of the sequence now, so that short macros take effect
+  // within the event that triggered them, like they always have.
+  run();
+  return true;
+}
+
+void MacroSupport::dequeue() {
+  queue_head_   = (queue_head_ + 1) % MAX_QUEUED_MACROS;
+  interval_     = 0;
+  tap_sequence_ = MACRO_ACTION_END;
+  --queue_length_;
+}
+
+void MacroSupport::run() {
+  // A macro step can trigger another macro (by pressing a Macros key, for
+  // example). That one gets queued, and played once its turn comes.
+  if (running_)
+    return;
+  running_ = true;
+
+  while (isPlaying() && cycle_steps_ < MACRO_STEPS_PER_CYCLE) {
+    if (!Runtime.hasTimeExpired(wait_start_time_, wait_))
+      break;
+    wait_ = 0;
+
+    if (pending_release_ != Key_NoKey) {
+      // The release of a tap is a step of its own, after which the wait that
+      // followed the tap begins.
+      Key key          = pending_release_;
+      pending_release_ = Key_NoKey;
+      wait_            = wait_after_release_;
+      release(key);
+    } else if (!playStep(queue_[queue_head_])) {
+      // Playing the step might have aborted playback.
+      if (isPlaying())
+        dequeue();
+      continue;
+    } else if (pending_release_ != Key_NoKey) {
+      wait_after_release_ = wait_;
+      wait_               = MACRO_TAP_RELEASE_DELAY;
+    }
+    ++cycle_steps_;
+    wait_start_time_ = Runtime.millisAtCycleStart();
+  }
+
+  if (clear_when_done_ && !isPlaying()) {
+    clear_when_done_ = false;
+    clear();
+  }
+
+  // The next step is due once the current wait is over, or in the next cycle if
+  // this one has played as many steps as it may.
+  if (!isPlaying()) {
+    Runtime.cancelDeadline(step_deadline_);
+  } else if (cycle_steps_ < MACRO_STEPS_PER_CYCLE) {
+    Runtime.armDeadline(step_deadline_, Runtime.millisUntilTimeExpires(wait_start_time_, wait_));
+  } else {
+    Runtime.armDeadline(step_deadline_, 0);
+  }
+
+  running_ = false;
+}
+
+void MacroSupport::onStepDeadline() {
+  ::MacroSupport.run();
+}
+
+// Plays the next step of `sequence`, and sets the time to wait before the one
+// after that. Returns `false` when the end of the sequence has been reached.
+bool MacroSupport::playStep(Sequence &sequence) {
+  Key key;
+
+  if (tap_sequence_ != MACRO_ACTION_END) {
+    // Each key in a tap sequence is a step of its own.
+    key.setFlags(tap_sequence_ == MACRO_ACTION_STEP_TAP_CODE_SEQUENCE ? 0 : readByte(sequence));
+    key.setKeyCode(readByte(sequence));
+    if (key == Key_NoKey) {
+      tap_sequence_ = MACRO_ACTION_END;
+    } else {
+      startTap(key);
+    }
+    wait_ = interval_;
+    return true;
+  }
+
+  macro_t step = readByte(sequence);
+  switch (step) {
+  // These are unlikely to be useful now that we have KeyEvent. I think the
+  // whole `explicit_report` came about as a result of scan-order bugs.
+  case MACRO_ACTION_STEP_EXPLICIT_REPORT:
+  case MACRO_ACTION_STEP_IMPLICIT_REPORT:
+  case MACRO_ACTION_STEP_SEND_REPORT:
+    break;
+  // End legacy macro step commands
+
+  // Timing
+  case MACRO_ACTION_STEP_INTERVAL:
+    interval_ = readByte(sequence);
+    break;
+  case MACRO_ACTION_STEP_WAIT:
+    wait_ = readByte(sequence);
+    break;
+
+  case MACRO_ACTION_STEP_KEYDOWN:
+  case MACRO_ACTION_STEP_KEYUP:
+  case MACRO_ACTION_STEP_TAP:
+    key.setFlags(readByte(sequence));
+    key.setKeyCode(readByte(sequence));
+    break;
+  case MACRO_ACTION_STEP_KEYCODEDOWN:
+  case MACRO_ACTION_STEP_KEYCODEUP:
+  case MACRO_ACTION_STEP_TAPCODE:
+    // Keycode variants of actions don't have flags to set.
+    key.setFlags(0);
+    key.setKeyCode(readByte(sequence));
+    break;
+
+  case MACRO_ACTION_STEP_TAP_SEQUENCE:
+  case MACRO_ACTION_STEP_TAP_CODE_SEQUENCE:
+    tap_sequence_ = step;
+    return playStep(sequence);
+
+  case MACRO_ACTION_END:
+  default:
+    return false;
+  }
+
+  switch (step) {
+  case MACRO_ACTION_STEP_KEYDOWN:
+  case MACRO_ACTION_STEP_KEYCODEDOWN:
+    press(key);
+    break;
+  case MACRO_ACTION_STEP_KEYUP:
+  case MACRO_ACTION_STEP_KEYCODEUP:
+    release(key);
+    break;
+  case MACRO_ACTION_STEP_TAP:
+  case MACRO_ACTION_STEP_TAPCODE:
+    startTap(key);
+    break;
+  default:
+    break;
+  }
+
+  wait_ += interval_;
+  return true;
+}
+
+uint8_t MacroSupport::readByte(Sequence &sequence) {
+  if (sequence.pos >= sequence.end)
+    return MACRO_ACTION_END;
+  if (sequence.in_storage)
+    return Runtime.storage().read(sequence.pos++);
+  return pgm_read_byte(reinterpret_cast<const macro_t *>(sequence.pos++));
+}
+
 // -----------------------------------------------------------------------------
 // Event handlers
 
+EventHandlerResult MacroSupport::beforeEachCycle() {
+  cycle_steps_ = 0;
+  return EventHandlerResult::OK;
+}
+
 EventHandlerResult MacroSupport::beforeReportingState(const KeyEvent &event) {
   // Do this in beforeReportingState(), instead of `onAddToReport()` because
   // `live_keys` won't get updated until after the macro sequence is played from
@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <stdint.h>  // for uint8_t, uint16_t, uintptr_t
+
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
@@ -36,6 +39,27 @@
 #define MAX_CONCURRENT_MACRO_KEYS 8
 #endif
 
+// The number of macro sequences that can be waiting to play (including the one
+// that is currently playing). Sequences played while the queue is full are
+// dropped.
+#if !defined(MAX_QUEUED_MACROS)
+#define MAX_QUEUED_MACROS 4
+#endif
+
+// The maximum number of macro steps played in a single cycle. The rest of a
+// longer sequence is played in the following cycles.
+#if !defined(MACRO_STEPS_PER_CYCLE)
+#define MACRO_STEPS_PER_CYCLE 8
+#endif
+
+// The time (in milliseconds) between the press and the release of a tapped key.
+// Some HID implementations coalesce reports sent within a short period of time;
+// in particular, Windows BLE HID can turn a press and release inside the same
+// transmission interval into a no-op, causing dropped keystrokes.
+#if !defined(MACRO_TAP_RELEASE_DELAY)
+#define MACRO_TAP_RELEASE_DELAY 25
+#endif
+
 namespace kaleidoscope {
 namespace plugin {
 
@@ -65,17 +89,99 @@ class MacroSupport : public Plugin {
   /// Send a key "tap event" from a Macro
   ///
   /// Generates two new `KeyEvent` objects, one each to press and release the
-  /// specified `key`, passing both in sequence to `Runtime.handleKeyEvent()`.
+  /// specified `key`, passing both in sequence to `Runtime.handleKeyEvent()`,
+  /// `MACRO_TAP_RELEASE_DELAY` milliseconds apart. This blocks for that long;
+  /// taps in macro sequences played with `play()` don't, as their releases
+  /// are steps of their own.
   void tap(Key key) const;
 
+  /// Play a macro sequence stored in PROGMEM
+  ///
+  /// The sequence is made of the steps defined in the Macros plugin's
+  /// "MacroSteps.h" (usually with the `MACRO()` helper).
+  ///
+  /// Adds the sequence to the queue of macros to play, and plays as much of it
+  /// as it can right away: steps are played until the sequence has to wait
+  /// (because of an interval or a `W()` step), or until
+  /// `MACRO_STEPS_PER_CYCLE` steps have been played. The rest is played in
+  /// later cycles, as each step comes due, so the keyboard keeps working while
+  /// a long macro is playing. Returns `false` if the queue was full, and the sequence dropped.
+  bool play(const uint8_t *macro);
+
+  /// Play a macro sequence stored in `Runtime.storage()`
+  ///
+  /// Like `play()`, but reads the steps from storage, starting at `start`, and
+  /// never reading at or past `end`.
+  bool playFromStorage(uint16_t start, uint16_t end);
+
+  /// Stop playing macros
+  ///
+  /// Drops the sequence that is currently playing along with any queued ones,
+  /// then releases all the virtual keys held by MacroSupport (see `clear()`).
+  void abort();
+
+  /// Returns `true` if a macro sequence is playing (or waiting to play)
+  bool isPlaying() const {
+    return queue_length_ != 0;
+  }
+
+  /// Clear all virtual keys once all the queued macros have been played
+  ///
+  /// This is what a Macros key release does, so that keys pressed by its
+  /// sequence stay held until both the key has been released and the sequence
+  /// is done. If no macro is playing, the keys are cleared right away.
+  void clearWhenDone();
+
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onNameQuery();
+  EventHandlerResult beforeEachCycle();
   EventHandlerResult beforeReportingState(const KeyEvent &event);
 
  private:
   // An array of key values that are active while a macro sequence is playing
   Key active_macro_keys_[MAX_CONCURRENT_MACRO_KEYS];
+
+  // A macro sequence waiting to be played, and the position of its next step.
+  // The position is a PROGMEM address, or an index into `Runtime.storage()`.
+  struct Sequence {
+    uintptr_t pos;
+    uintptr_t end;
+    bool in_storage;
+  };
+
+  // The queue of macro sequences, the first of which is the one playing
+  Sequence queue_[MAX_QUEUED_MACROS];
+  uint8_t queue_head_   = 0;
+  uint8_t queue_length_ = 0;
+
+  // Playback state of the sequence at the head of the queue
+  uint8_t interval_ = 0;
+  // The type of tap sequence step being played, or `MACRO_ACTION_END` (zero)
+  uint8_t tap_sequence_ = 0;
+  uint16_t wait_start_time_ = 0;
+  uint16_t wait_ = 0;
+  // The key of a tap step that is waiting to be released, and the time to wait
+  // after that release
+  Key pending_release_         = Key_NoKey;
+  uint16_t wait_after_release_ = 0;
+
+  // The number of steps played so far in the current cycle
+  uint8_t cycle_steps_ = 0;
+
+  // Expires when the next step of the playing macro is due
+  Deadline step_deadline_{onStepDeadline};
+
+  bool clear_when_done_ = false;
+  bool running_         = false;
+
+  bool enqueue(uintptr_t pos, uintptr_t end, bool in_storage);
+  void dequeue();
+  void run();
+  static void onStepDeadline();
+  bool playStep(Sequence &sequence);
+  void startTap(Key key);
+  uint8_t readByte(Sequence &sequence);
 };
 
 }  // namespace plugin
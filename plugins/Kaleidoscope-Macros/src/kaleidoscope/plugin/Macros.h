@@ -29,6 +29,7 @@
 #include "kaleidoscope/KeyEvent.h"                  // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"      // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"                  // for Key
+#include "kaleidoscope/key_interest.h"              // for KALEIDOSCOPE_KEY_INTEREST
 #include "kaleidoscope/plugin.h"                    // for Plugin
 #include "kaleidoscope/plugin/Macros/MacroSteps.h"  // for macro_t, MACRO_NONE
 
@@ -77,7 +78,17 @@ class Macros : public kaleidoscope::Plugin {
   }
 
   /// Play a macro sequence of key events
-  void play(const macro_t *macro_ptr);
+  ///
+  /// The sequence is played by MacroSupport, which plays the start of it right
+  /// away, and the rest (if it's long, or has to wait) in subsequent cycles.
+  inline void play(const macro_t *macro_ptr) {
+    ::MacroSupport.play(macro_ptr);
+  }
+
+  /// Stop playing macro sequences, and release all virtual keys held by Macros
+  inline void abort() {
+    ::MacroSupport.abort();
+  }
 
   // Templates provide a `type()` function that takes a variable number of
   // `char*` (string) arguments, in the form of a list of strings stored in
@@ -95,7 +106,11 @@ class Macros : public kaleidoscope::Plugin {
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onNameQuery();
+  KALEIDOSCOPE_KEY_INTEREST(keyRange(ranges::MACRO_FIRST, ranges::MACRO_LAST))
   EventHandlerResult onKeyEvent(KeyEvent &event);
+  EventHandlerResult beforeEachCycle() {
+    return ::MacroSupport.beforeEachCycle();
+  }
   EventHandlerResult beforeReportingState(const KeyEvent &event) {
     return ::MacroSupport.beforeReportingState(event);
   }
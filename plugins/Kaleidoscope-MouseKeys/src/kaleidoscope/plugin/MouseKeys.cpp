@@ -134,6 +134,11 @@ EventHandlerResult MouseKeys::onKeyEvent(KeyEvent &event) {
   if (!isMouseKey(event.key))
     return EventHandlerResult::OK;
 
+  // Our `onAddToReport()` handler needs to see every held mouse key in order to
+  // gather the current buttons & directions, so we can't let the report be
+  // built incrementally.
+  Runtime.requestFullReportRebuild();
+
   pending_directions_ = 0;
 
   if (isMouseButtonKey(event.key)) {
@@ -26,9 +26,11 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/key_defs.h"              // for Key
+#include "kaleidoscope/key_defs.h"              // for Key, SYNTHETIC
+#include "kaleidoscope/key_interest.h"          // for KALEIDOSCOPE_KEY_INTEREST
 #include "kaleidoscope/plugin.h"                // for Plugin
 
+#include "kaleidoscope/plugin/mousekeys/MouseKeyDefs.h"    // for IS_MOUSE_KEY
 #include "kaleidoscope/plugin/mousekeys/MouseWarpModes.h"  // for warp modes
 // =============================================================================
 // Deprecated MousKeys code
@@ -144,6 +146,7 @@ class MouseKeys : public kaleidoscope::Plugin {
   EventHandlerResult onSetup();
   EventHandlerResult onNameQuery();
   EventHandlerResult afterEachCycle();
+  KALEIDOSCOPE_KEY_INTEREST(keyFlags(SYNTHETIC | IS_MOUSE_KEY))
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult onAddToReport(Key key);
   EventHandlerResult afterReportingState(const KeyEvent &event);
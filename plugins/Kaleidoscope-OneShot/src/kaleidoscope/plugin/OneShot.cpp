@@ -144,25 +144,29 @@ bool OneShot::isActive(KeyAddr key_addr) const {
 // Public state-setting functions
 
 void OneShot::setPending(KeyAddr key_addr) {
+  startTimer();
   temp_addrs_.set(key_addr);
   glue_addrs_.clear(key_addr);
-  start_time_ = Runtime.millisAtCycleStart();
+  armTimeoutDeadline();
 }
 
 void OneShot::setOneShot(KeyAddr key_addr) {
+  startTimer();
   temp_addrs_.set(key_addr);
   glue_addrs_.set(key_addr);
-  start_time_ = Runtime.millisAtCycleStart();
+  armTimeoutDeadline();
 }
 
 void OneShot::setSticky(KeyAddr key_addr) {
   temp_addrs_.clear(key_addr);
   glue_addrs_.set(key_addr);
+  armTimeoutDeadline();
 }
 
 void OneShot::clear(KeyAddr key_addr) {
   temp_addrs_.clear(key_addr);
   glue_addrs_.clear(key_addr);
+  armTimeoutDeadline();
 }
 
 // ----------------------------------------------------------------------------
@@ -184,6 +188,7 @@ void OneShot::cancel(bool cancel_stickies) {
       temp_addrs_.clear(key_addr);
     }
   }
+  armTimeoutDeadline();
 }
 
 // ----------------------------------------------------------------------------
@@ -195,6 +200,21 @@ EventHandlerResult OneShot::onNameQuery() {
 
 EventHandlerResult OneShot::onKeyEvent(KeyEvent &event) {
 
+  // Keys pressed by injected events without a key address (e.g. the taps of a
+  // macro that takes several cycles to play) are part of the event that
+  // triggered them, so one-shot keys must stay active until they're released.
+  if (!event.addr.isValid() && event.key.isKeyboardKey()) {
+    if (keyToggledOn(event.state)) {
+      if (injected_keys_held_ < 0xff)
+        ++injected_keys_held_;
+    } else if (keyToggledOff(event.state) && injected_keys_held_ > 0) {
+      --injected_keys_held_;
+      // One-shot keys that timed out while it was held can be released now.
+      if (injected_keys_held_ == 0)
+        armTimeoutDeadline();
+    }
+  }
+
   // Ignore injected key events. This prevents re-processing events that the
   // hook functions generate (by calling `injectNormalKey()` via one of the
   // `*OneShot()` functions). There are more robust ways to do this, but since
@@ -221,15 +241,18 @@ EventHandlerResult OneShot::onKeyEvent(KeyEvent &event) {
       if (is_oneshot ||
           (settings_.auto_modifiers && event.key.isKeyboardModifier()) ||
           (settings_.auto_layers && event.key.isLayerShift())) {
+        startTimer();
         temp_addrs_.set(event.addr);
-        start_time_ = Runtime.millisAtCycleStart();
+        armTimeoutDeadline();
       } else if (!event.key.isMomentary()) {
         // Only trigger release of temporary one-shot keys if the pressed key is
         // neither a modifier nor a layer shift. We need the actual release of
         // those keys to happen after the current event is finished, however, so
         // we trigger it by back-dating the start time, so that the timeout
-        // check will trigger in the afterEachCycle() hook.
+        // check will trigger in the afterReportingState() hook (or when the
+        // deadline expires, if the event doesn't get that far).
         start_time_ -= settings_.timeout;
+        armTimeoutDeadline();
       }
 
     } else if (temp && glue) {
@@ -286,13 +309,33 @@ EventHandlerResult OneShot::onKeyEvent(KeyEvent &event) {
 EventHandlerResult OneShot::afterReportingState(const KeyEvent &event) {
   if (!event.addr.isValid() || keyIsInjected(event.state))
     return EventHandlerResult::OK;
-  return afterEachCycle();
+  releaseTimedOutKeys();
+  return EventHandlerResult::OK;
 }
 
+// ============================================================================
+// Private functions, not exposed to other plugins
+
 // ----------------------------------------------------------------------------
-EventHandlerResult OneShot::afterEachCycle() {
+// Timeouts
+
+// Restarts the timer shared by all temporary keys, when a key becomes one.
+void OneShot::startTimer() {
+  // If there were no temporary keys, forget about held injected keys, so that
+  // a press without a matching release can't keep this one from expiring.
+  bool any_temp_keys = false;
+  for (KeyAddr key_addr __attribute__((unused)) : temp_addrs_) {
+    any_temp_keys = true;
+    break;
+  }
+  if (!any_temp_keys)
+    injected_keys_held_ = 0;
+  start_time_ = Runtime.millisAtCycleStart();
+}
 
-  bool oneshot_expired = hasTimedOut(settings_.timeout);
+void OneShot::releaseTimedOutKeys() {
+  bool oneshot_expired = hasTimedOut(settings_.timeout) &&
+                         injected_keys_held_ == 0;
   bool hold_expired    = hasTimedOut(settings_.hold_timeout);
   bool any_temp_keys   = false;
 
@@ -313,15 +356,40 @@ EventHandlerResult OneShot::afterEachCycle() {
 
   // Keep the start time from getting stale; if there are no keys waiting for a
   // timeout, it's safe to advance the timer to the current time.
-  if (!any_temp_keys) {
+  if (!any_temp_keys)
     start_time_ = Runtime.millisAtCycleStart();
+
+  armTimeoutDeadline();
+}
+
+// Keys in the "one-shot" state expire after the timeout (but not while an
+// injected key is held), and "pending" ones after the hold timeout, all counted
+// from `start_time_`.
+void OneShot::armTimeoutDeadline() {
+  uint16_t ttl       = 0xffff;
+  bool any_temp_keys = false;
+  for (KeyAddr key_addr : temp_addrs_) {
+    if (glue_addrs_.read(key_addr)) {
+      if (injected_keys_held_ != 0)
+        continue;
+      if (settings_.timeout < ttl)
+        ttl = settings_.timeout;
+    } else if (settings_.hold_timeout < ttl) {
+      ttl = settings_.hold_timeout;
+    }
+    any_temp_keys = true;
   }
 
-  return EventHandlerResult::OK;
+  if (!any_temp_keys) {
+    Runtime.cancelDeadline(timeout_deadline_);
+    return;
+  }
+  Runtime.armDeadline(timeout_deadline_, Runtime.millisUntilTimeExpires(start_time_, ttl));
 }
 
-// ============================================================================
-// Private functions, not exposed to other plugins
+void OneShot::onTimeoutDeadline() {
+  ::OneShot.releaseTimedOutKeys();
+}
 
 // ----------------------------------------------------------------------------
 // Helper functions for acting on OneShot key events
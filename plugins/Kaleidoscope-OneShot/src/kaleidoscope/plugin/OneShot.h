@@ -25,6 +25,7 @@
 #include <Kaleidoscope-Ranges.h>  // for OSL_FIRST, OSM_FIRST, OS_FIRST, OS_LAST
 #include <stdint.h>               // for uint16_t, uint8_t, int16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyAddrBitfield.h"       // for KeyAddrBitfield
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
@@ -178,12 +179,14 @@ class OneShot : public kaleidoscope::Plugin {
   // Timeout onfiguration functions
   void setTimeout(uint16_t ttl) {
     settings_.timeout = ttl;
+    armTimeoutDeadline();
   }
   uint16_t getTimeout() {
     return settings_.timeout;
   }
   void setHoldTimeout(uint16_t ttl) {
     settings_.hold_timeout = ttl;
+    armTimeoutDeadline();
   }
   uint16_t getHoldTimeout() {
     return settings_.hold_timeout;
@@ -201,7 +204,6 @@ class OneShot : public kaleidoscope::Plugin {
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult afterReportingState(const KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
   friend class OneShotConfig;
 
@@ -236,6 +238,14 @@ class OneShot : public kaleidoscope::Plugin {
   uint16_t start_time_   = 0;
   KeyAddr prev_key_addr_ = invalid_key_addr;
 
+  // The number of keys held by injected events without a key address, such as
+  // the taps of a playing macro. While any are held, temporary one-shot keys
+  // are not released.
+  uint8_t injected_keys_held_ = 0;
+
+  // Expires when the first temporary key times out
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
   // --------------------------------------------------------------------------
   // Internal utility functions
   bool hasTimedOut(uint16_t ttl) const {
@@ -248,6 +258,11 @@ class OneShot : public kaleidoscope::Plugin {
                       : settings_.double_tap_timeout;
     return hasTimedOut(dtto);
   }
+  void startTimer();
+  void releaseTimedOutKeys();
+  void armTimeoutDeadline();
+  static void onTimeoutDeadline();
+
   uint8_t getOneShotKeyIndex(Key oneshot_key) const;
   uint8_t getKeyIndex(Key key) const;
   Key decodeOneShotKey(Key oneshot_key) const;
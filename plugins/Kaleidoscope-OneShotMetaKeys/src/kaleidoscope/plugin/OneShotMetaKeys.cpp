@@ -27,9 +27,8 @@
 #include <Kaleidoscope-OneShot.h>      // for OneShot
 
 #include "kaleidoscope/KeyAddr.h"               // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"            // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddrBitfield.h"       // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
-#include "kaleidoscope/KeyMap.h"                // for KeyMap
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/key_defs.h"              // for Key, Key_Inactive, Key_Masked
@@ -58,11 +57,9 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
     // Note: we don't need to explicitly skip the key the active sticky key
     // itself (i.e. `event.addr`), because its entry in `live_keys[]` has not
     // yet been inserted at this point.
-    for (KeyAddr addr : KeyAddr::all()) {
-      // Get the entry from the keyboard state array.
-      Key key = live_keys[addr];
-      // Skip idle and masked entries.
-      if (key == Key_Inactive || key == Key_Masked) {
+    for (KeyAddr addr : live_keys.active()) {
+      // Skip masked entries (idle ones aren't visited at all).
+      if (live_keys[addr] == Key_Masked) {
         continue;
       }
       // Make everything else sticky.
@@ -90,8 +87,8 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
 }
 
 bool OneShotMetaKeys::isMetaStickyActive() {
-  for (Key key : live_keys.all()) {
-    if (key == OneShot_MetaStickyKey)
+  for (KeyAddr key_addr : live_keys.active()) {
+    if (live_keys[key_addr] == OneShot_MetaStickyKey)
       return true;
   }
   return false;
@@ -50,7 +50,11 @@ EventHandlerResult PrefixLayer::onKeyEvent(KeyEvent &event) {
   for (uint8_t i = 0; i < prefix_layers_length_; i++) {
     if (Layer.isActive(pgm_read_byte(&prefix_layers_[i].layer))) {
       current_prefix_ = prefix_layers_[i].prefix.readFromProgmem();
+      // Our `onAddToReport()` handler needs to see the held modifiers in order
+      // to keep them out of the prefix reports.
+      Runtime.requestFullReportRebuild();
       Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), IS_PRESSED | INJECTED, current_prefix_});
+      Runtime.requestFullReportRebuild();
       Runtime.handleKeyEvent(KeyEvent{KeyAddr::none(), WAS_PRESSED | INJECTED, current_prefix_});
       current_prefix_ = Key_NoKey;
     }
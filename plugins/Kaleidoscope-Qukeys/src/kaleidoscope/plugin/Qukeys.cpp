@@ -70,33 +70,54 @@ EventHandlerResult Qukeys::onKeyswitchEvent(KeyEvent &event) {
   event_queue_.append(event);
   // In order to prevent overflowing the queue, process it now.
   while (processQueue());
+  armQueueDeadline();
   // Any event that gets added to the queue gets re-processed later, so we
   // need to abort processing now.
   return EventHandlerResult::ABORT;
 }
 
 
-// This hook runs once each cycle, and checks to see if the first event in the
-// queue is ready to be flushed. It only allows one event to be flushed per
-// cycle, because the keyboard HID report can't store all of the information
-// necessary to correctly handle all of the rollover corner cases.
-EventHandlerResult Qukeys::afterEachCycle() {
-  // If there hasn't been a keypress in a while, update the prior keypress
-  // timestamp to avoid integer overflow issues:
-  if (Runtime.hasTimeExpired(prior_keypress_timestamp_,
-                             minimum_prior_interval_)) {
-    prior_keypress_timestamp_ =
-      Runtime.millisAtCycleStart() - (minimum_prior_interval_ + 1);
+// The queue head is resolved when it has been held for the hold timeout, or when
+// the tap-repeat timeout of a tapped qukey runs out (see
+// `shouldWaitForTapRepeat()`). Once other events have been queued behind it,
+// the rollover checks in `processQueue()` depend on time as well, so the queue
+// is checked on every cycle until it's down to one event again.
+void Qukeys::armQueueDeadline() {
+  if (event_queue_.isEmpty()) {
+    Runtime.cancelDeadline(queue_deadline_);
+    return;
+  }
+
+  uint32_t remaining = 0;
+  if (event_queue_.length() == 1 && active_) {
+    remaining = Runtime.millisUntilTimeExpires(event_queue_.timestamp(0), hold_timeout_);
+    if (event_queue_.isRelease(0)) {
+      uint32_t tap_repeat_remaining =
+        Runtime.millisUntilTimeExpires(tap_repeat_.start_time, tap_repeat_.timeout);
+      if (tap_repeat_remaining < remaining)
+        remaining = tap_repeat_remaining;
+    }
   }
+  Runtime.armDeadline(queue_deadline_, remaining);
+}
+
+// This checks to see if the first event in the queue is ready to be flushed. It
+// only allows one event to be flushed per cycle, because the keyboard HID report
+// can't store all of the information necessary to correctly handle all of the
+// rollover corner cases.
+void Qukeys::onQueueDeadline() {
+  ::Qukeys.processQueueTimeouts();
+}
 
+void Qukeys::processQueueTimeouts() {
   // If there's nothing in the queue, there's nothing more to do.
   if (event_queue_.isEmpty()) {
-    return EventHandlerResult::OK;
+    return;
   }
 
   // If we get here, that means that the first event in the queue is a qukey
-  // press. All that's left to do is to check if it's been held long enough that
-  // it has timed out.
+  // press (or the release of one that might be tapped again). All that's left
+  // to do is to check if it's been held long enough that it has timed out.
   if (Runtime.hasTimeExpired(event_queue_.timestamp(0), hold_timeout_)) {
     // If it's a SpaceCadet-type key, it takes on its primary value, otherwise
     // it takes on its secondary value.
@@ -107,7 +128,7 @@ EventHandlerResult Qukeys::afterEachCycle() {
   // Process as many events as we can from the queue.
   while (processQueue());
 
-  return EventHandlerResult::OK;
+  armQueueDeadline();
 }
 
 
@@ -290,7 +311,10 @@ void Qukeys::flushEvent(Key event_key) {
   if (!event_queue_.isRelease(0) &&
       ((event_key >= Key_A && event_key <= Key_0) ||
        (event_key >= Key_Minus && event_key <= Key_Slash))) {
-    prior_keypress_timestamp_ = event_queue_.timestamp(0);
+    // The queue only keeps the low 16 bits of the time, and the event can't
+    // have been in it for long enough for them to wrap around.
+    uint16_t age              = uint16_t(Runtime.millisAtCycleStart()) - event_queue_.timestamp(0);
+    prior_keypress_timestamp_ = Runtime.millisAtCycleStart() - age;
   }
 
   // Remove the head event from the queue, then call `handleKeyswitchEvent()` to
@@ -23,8 +23,9 @@
 
 #include <Arduino.h>              // for PROGMEM
 #include <Kaleidoscope-Ranges.h>  // for DUL_FIRST, DUM_FIRST
-#include <stdint.h>               // for uint8_t, uint16_t, int8_t
+#include <stdint.h>               // for uint8_t, uint16_t, uint32_t, int8_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
@@ -45,6 +46,13 @@
 
 #define LT(layer, key) kaleidoscope::plugin::LayerTapKey(layer, Key_##key)
 
+// The number of key events Qukeys can hold back while a qukey's state is
+// undecided. It has to be set for the whole build (e.g. with
+// `-DKALEIDOSCOPE_QUKEYS_QUEUE_CAPACITY=32`), not just the sketch.
+#ifndef KALEIDOSCOPE_QUKEYS_QUEUE_CAPACITY
+#define KALEIDOSCOPE_QUKEYS_QUEUE_CAPACITY 8
+#endif
+
 namespace kaleidoscope {
 namespace plugin {
 
@@ -87,9 +95,11 @@ class Qukeys : public kaleidoscope::Plugin {
   }
   void deactivate() {
     active_ = false;
+    armQueueDeadline();
   }
   void toggle() {
     active_ = !active_;
+    armQueueDeadline();
   }
 
   // Set the timeout (in milliseconds) for a held qukey. If a qukey is held at
@@ -158,7 +168,6 @@ class Qukeys : public kaleidoscope::Plugin {
   // Kaleidoscope hook functions.
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  private:
   // An array of Qukey objects in PROGMEM.
@@ -166,7 +175,7 @@ class Qukeys : public kaleidoscope::Plugin {
   uint8_t qukeys_count_{0};
 
   // The maximum number of events in the queue at a time.
-  static constexpr uint8_t queue_capacity_{8};
+  static constexpr uint8_t queue_capacity_{KALEIDOSCOPE_QUKEYS_QUEUE_CAPACITY};
 
   // The event queue stores a series of press and release events.
   KeyAddrEventQueue<queue_capacity_> event_queue_;
@@ -195,8 +204,13 @@ class Qukeys : public kaleidoscope::Plugin {
   // Timestamp of the keypress event immediately prior to the queue head event.
   // The initial value is 256 to ensure that it won't trigger an error if a
   // qukey is pressed before `minimum_prior_interval_` milliseconds after the
-  // keyboard powers on, and that value can only be as high as 255.
-  uint16_t prior_keypress_timestamp_{256};
+  // keyboard powers on, and that value can only be as high as 255. Unlike the
+  // queue timestamps, this one is a full 32 bits, so it doesn't wrap around
+  // between keypresses that are far apart.
+  uint32_t prior_keypress_timestamp_{256};
+
+  // Expires when the event at the head of the queue might be ready to flush
+  Deadline queue_deadline_{onQueueDeadline};
 
   // This is a guard against re-processing events when qukeys flushes them from
   // its event queue. We can't just use an "injected" key state flag, because
@@ -211,6 +225,9 @@ class Qukeys : public kaleidoscope::Plugin {
   } queue_head_;
 
   // Internal helper methods.
+  void armQueueDeadline();
+  static void onQueueDeadline();
+  void processQueueTimeouts();
   bool processQueue();
   void flushEvent(Key event_key);
   bool isQukey(KeyAddr k);
@@ -142,8 +142,13 @@ EventHandlerResult SpaceCadet::onKeyswitchEvent(KeyEvent &event) {
       if (settings_.mode == Mode::NO_DELAY)
         Runtime.handleKeyEvent(event);
       // Queue the press event and abort; this press event will be resolved
-      // later.
+      // later, when the key is released, another key is pressed, or its
+      // timeout expires.
       event_queue_.append(event);
+      uint16_t pending_timeout = settings_.timeout;
+      if (map_[pending_map_index_].timeout != 0)
+        pending_timeout = map_[pending_map_index_].timeout;
+      Runtime.armDeadline(timeout_deadline_, pending_timeout);
       return EventHandlerResult::ABORT;
     }
   }
@@ -152,22 +157,9 @@ EventHandlerResult SpaceCadet::onKeyswitchEvent(KeyEvent &event) {
 }
 
 // -----------------------------------------------------------------------------
-EventHandlerResult SpaceCadet::afterEachCycle() {
-  // If there's no pending event, return.
-  if (event_queue_.isEmpty())
-    return EventHandlerResult::OK;
-
-  // Get timeout value for the pending key.
-  uint16_t pending_timeout = settings_.timeout;
-  if (map_[pending_map_index_].timeout != 0)
-    pending_timeout = map_[pending_map_index_].timeout;
-  uint16_t start_time = event_queue_.timestamp(0);
-
-  if (Runtime.hasTimeExpired(start_time, pending_timeout)) {
-    // The timer has expired; release the pending event unchanged.
-    flushQueue();
-  }
-  return EventHandlerResult::OK;
+void SpaceCadet::onTimeoutDeadline() {
+  // The timer has expired; release the pending event unchanged.
+  ::SpaceCadet.flushQueue();
 }
 
 // =============================================================================
@@ -183,6 +175,7 @@ int8_t SpaceCadet::getSpaceCadetKeyIndex(Key key) const {
 }
 
 void SpaceCadet::flushQueue() {
+  Runtime.cancelDeadline(timeout_deadline_);
   while (!event_queue_.isEmpty()) {
     flushEvent(false);
   }
@@ -26,6 +26,7 @@
 #include <Kaleidoscope-Ranges.h>  // for SC_FIRST, SC_LAST
 #include <stdint.h>               // for uint16_t, uint8_t, int8_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
@@ -107,7 +108,6 @@ class SpaceCadet : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  protected:
   enum Mode : uint8_t {
@@ -140,10 +140,14 @@ class SpaceCadet : public kaleidoscope::Plugin {
   // index of that key in the array.
   int8_t pending_map_index_ = -1;
 
+  // Expires when the pending SpaceCadet key has been held for its timeout
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
   int8_t getSpaceCadetKeyIndex(Key key) const;
 
   void flushEvent(bool is_tap = false);
   void flushQueue();
+  static void onTimeoutDeadline();
 };
 
 class SpaceCadetConfig : public kaleidoscope::Plugin {
@@ -17,12 +17,13 @@
 
 #pragma once
 
-#include <Kaleidoscope-Ranges.h>  // for STENO_FIRST
+#include <Kaleidoscope-Ranges.h>  // for STENO_FIRST, STENO_LAST
 #include <stdint.h>               // for uint8_t
 
 #define S(n) Key(kaleidoscope::plugin::steno::geminipr::n)
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/key_interest.h"          // for KALEIDOSCOPE_KEY_INTEREST
 #include "kaleidoscope/plugin.h"                // for Plugin
 
 
@@ -32,6 +33,7 @@ namespace steno {
 class GeminiPR : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onNameQuery();
+  KALEIDOSCOPE_KEY_INTEREST(keyRange(ranges::STENO_FIRST, ranges::STENO_LAST))
   EventHandlerResult onKeyEvent(KeyEvent &event);
 
  private:
@@ -125,8 +125,10 @@ EventHandlerResult TapDance::onKeyswitchEvent(KeyEvent &event) {
     tap_count_ = 0;
     // If the event isn't another TapDance key, let it proceed. If it is, fall
     // through to the next block, which handles "Tap" actions.
-    if (!isTapDanceKey(event.key))
+    if (!isTapDanceKey(event.key)) {
+      armTimeoutDeadline();
       return EventHandlerResult::OK;
+    }
   }
 
   // Tap: First flush the queue, ignoring the previous press and release events
@@ -135,35 +137,51 @@ EventHandlerResult TapDance::onKeyswitchEvent(KeyEvent &event) {
   flushQueue(event.addr);
   event_queue_.append(event);
   tapDanceAction(td_id, td_addr, ++tap_count_, Tap);
+  armTimeoutDeadline();
   return EventHandlerResult::ABORT;
 }
 
-EventHandlerResult TapDance::afterEachCycle() {
+// --- timeout ---
+
+uint16_t TapDance::currentTimeout() const {
+#ifndef NDEPRECATED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+  return time_out;
+#pragma GCC diagnostic pop
+#else
+  return timeout_;
+#endif
+}
+
+// The sequence times out when no other key has been pressed for the timeout
+// since the last tap of the TapDance key.
+void TapDance::armTimeoutDeadline() {
+  if (event_queue_.isEmpty()) {
+    Runtime.cancelDeadline(timeout_deadline_);
+    return;
+  }
+  Runtime.armDeadline(timeout_deadline_,
+                      Runtime.millisUntilTimeExpires(event_queue_.timestamp(0), currentTimeout()));
+}
+
+void TapDance::onTimeoutDeadline() {
+  ::TapDance.resolveTimedOutSequence();
+}
+
+void TapDance::resolveTimedOutSequence() {
   // If there's no active TapDance sequence, there's nothing to do.
   if (event_queue_.isEmpty())
-    return EventHandlerResult::OK;
+    return;
 
   // The first event in the queue is now guaranteed to be a TapDance key.
   KeyAddr td_addr = event_queue_.addr(0);
   Key td_key      = Layer.lookupOnActiveLayer(td_addr);
   uint8_t td_id   = td_key.getRaw() - ranges::TD_FIRST;
 
-  // Check for timeout
+  // Check for timeout, in case it was changed since the deadline was armed
   uint16_t start_time = event_queue_.timestamp(0);
-  // To avoid confusing editors with unmatched braces, we use a temporary
-  // boolean, until the deprecated code can be removed.
-  bool timed_out = false;
-#ifndef NDEPRECATED
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time, time_out))
-    timed_out = true;
-#pragma GCC diagnostic pop
-#else
-  if (Runtime.hasTimeExpired(start_time, timeout_))
-    timed_out = true;
-#endif
-  if (timed_out) {
+  if (Runtime.hasTimeExpired(start_time, currentTimeout())) {
     // We start with the assumption that the TapDance key is still being held.
     ActionType action = Hold;
     // Now we search for a release event for the TapDance key, starting from the
@@ -181,7 +199,7 @@ EventHandlerResult TapDance::afterEachCycle() {
     flushQueue();
     tap_count_ = 0;
   }
-  return EventHandlerResult::OK;
+  armTimeoutDeadline();
 }
 
 }  // namespace plugin
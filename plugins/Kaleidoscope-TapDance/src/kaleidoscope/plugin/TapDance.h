@@ -26,6 +26,7 @@
 #include <Kaleidoscope-Ranges.h>  // for TD_FIRST, TD_LAST
 #include <stdint.h>               // for uint8_t, uint16_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
@@ -86,7 +87,6 @@ class TapDance : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
   static constexpr bool isTapDanceKey(Key key) {
     return (key.getRaw() >= ranges::TD_FIRST &&
@@ -108,7 +108,14 @@ class TapDance : public kaleidoscope::Plugin {
   // Time to wait for another input event before resolving a TapDance sequence.
   uint16_t timeout_ = 200;
 
+  // Expires when the current TapDance sequence times out
+  Deadline timeout_deadline_{onTimeoutDeadline};
+
   void flushQueue(KeyAddr ignored_addr = KeyAddr::none());
+  uint16_t currentTimeout() const;
+  void armTimeoutDeadline();
+  static void onTimeoutDeadline();
+  void resolveTimedOutSequence();
 };
 
 }  // namespace plugin
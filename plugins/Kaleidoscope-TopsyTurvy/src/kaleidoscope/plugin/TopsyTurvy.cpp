@@ -61,13 +61,11 @@ EventHandlerResult TopsyTurvy::onKeyEvent(KeyEvent &event) {
   }
 
   if (tt_addr_.isValid()) {
-    for (KeyAddr key_addr : KeyAddr::all()) {
+    for (KeyAddr key_addr : live_keys.active()) {
       if (key_addr == event.addr)
         continue;
 
       Key active_key = live_keys[key_addr];
-      if (active_key == Key_Transparent)
-        continue;
 
       if (active_key.isKeyboardKey() && !active_key.isKeyboardModifier()) {
         live_keys.activate(key_addr, Key_NoKey);
@@ -88,7 +86,7 @@ EventHandlerResult TopsyTurvy::beforeReportingState(const KeyEvent &event) {
   // guaranteed to be safe, anyway. Therefore, we assume that if `tt_addr` is
   // valid, it is also the last key pressed.
   bool shift_detected = false;
-  for (KeyAddr key_addr : KeyAddr::all()) {
+  for (KeyAddr key_addr : live_keys.active()) {
     if (live_keys[key_addr].isKeyboardShift()) {
       shift_detected = true;
       break;
@@ -23,9 +23,8 @@
 #include <stdint.h>                    // for uint16_t, uint32_t
 
 #include "kaleidoscope/KeyAddr.h"                         // for MatrixAddr, MatrixAddr<>::Range
-#include "kaleidoscope/KeyAddrMap.h"                      // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddrBitfield.h"                 // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"                        // for KeyEvent
-#include "kaleidoscope/KeyMap.h"                          // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                        // for LiveKeys, live_keys
 #include "kaleidoscope/Runtime.h"                         // for Runtime, Runtime_
 #include "kaleidoscope/driver/hid/keyboardio/Keyboard.h"  // for Keyboard
@@ -94,44 +93,46 @@ EventHandlerResult Turbo::onKeyEvent(KeyEvent &event) {
     // If not in "sticky" mode and a Turbo key toggles off, or if in "sticky"
     // mode and a Turbo key toggles on, we deactivate Turbo.
     active_ = false;
+    Runtime.cancelDeadline(interval_deadline_);
     if (flash_)
       LEDControl::refreshAll();
 
   } else if (keyToggledOn(event.state)) {
-    // If Turbo is inactive, turn it on when a Turbo key is pressed.
-    active_     = true;
-    start_time_ = Runtime.millisAtCycleStart() - interval_;
+    // If Turbo is inactive, turn it on when a Turbo key is pressed, and tap the
+    // held keys right away.
+    active_ = true;
+    Runtime.armDeadline(interval_deadline_, 0);
   }
 
   // We assume that other plugins don't need to know about Turbo key events.
   return EventHandlerResult::EVENT_CONSUMED;
 }
 
-EventHandlerResult Turbo::afterEachCycle() {
-  if (active_) {
-    if (Runtime.hasTimeExpired(start_time_, interval_)) {
-      // Reset the timer.
-      start_time_ = Runtime.millisAtCycleStart();
-
-      // Clear the existing Keyboard HID report. It might be nice to keep the
-      // modifiers active, but I'll save that for another time.
-      Runtime.hid().keyboard().releaseAllKeys();
-      // Send the empty report to register the release of all the held keys.
-      Runtime.hid().keyboard().sendReport();
-
-      // Go through the `live_keys[]` array and add any Keyboard HID keys to the
-      // new report.
-      for (Key key : live_keys.all()) {
-        if (key.isKeyboardKey()) {
-          Runtime.addToReport(key);
-        }
-      }
+void Turbo::onIntervalDeadline() {
+  ::Turbo.retapKeys();
+}
 
-      // Send the re-populated keyboard report.
-      Runtime.hid().keyboard().sendReport();
+void Turbo::retapKeys() {
+  // Restart the timer.
+  Runtime.armDeadline(interval_deadline_, interval_);
+
+  // Clear the existing Keyboard HID report. It might be nice to keep the
+  // modifiers active, but I'll save that for another time.
+  Runtime.hid().keyboard().releaseAllKeys();
+  // Send the empty report to register the release of all the held keys.
+  Runtime.hid().keyboard().sendReport();
+
+  // Go through the `live_keys[]` array and add any Keyboard HID keys to the
+  // new report.
+  for (KeyAddr key_addr : live_keys.active()) {
+    Key key = live_keys[key_addr];
+    if (key.isKeyboardKey()) {
+      Runtime.addToReport(key);
     }
   }
-  return EventHandlerResult::OK;
+
+  // Send the re-populated keyboard report.
+  Runtime.hid().keyboard().sendReport();
 }
 
 EventHandlerResult Turbo::beforeSyncingLeds() {
@@ -145,7 +146,7 @@ EventHandlerResult Turbo::beforeSyncingLeds() {
       flash_start_time_ = Runtime.millisAtCycleStart();
       leds_on           = !leds_on;
     }
-    for (KeyAddr key_addr : KeyAddr::all()) {
+    for (KeyAddr key_addr : live_keys.active()) {
       Key key = live_keys[key_addr];
       if (key.isKeyboardKey()) {
         LEDControl::setCrgbAt(key_addr, color);
@@ -24,6 +24,7 @@
 #include <Kaleidoscope-Ranges.h>  // for TURBO
 #include <stdint.h>               // for uint16_t, uint32_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/device/device.h"         // for cRGB, CRGB
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
@@ -53,7 +54,6 @@ class Turbo : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
   EventHandlerResult beforeSyncingLeds();
 
  private:
@@ -64,8 +64,13 @@ class Turbo : public kaleidoscope::Plugin {
   cRGB active_color_       = CRGB(160, 0, 0);
 
   bool active_               = false;
-  uint32_t start_time_       = 0;
   uint32_t flash_start_time_ = 0;
+
+  // Expires when the held keys should be tapped again
+  Deadline interval_deadline_{onIntervalDeadline};
+
+  static void onIntervalDeadline();
+  void retapKeys();
 };
 
 }  // namespace plugin
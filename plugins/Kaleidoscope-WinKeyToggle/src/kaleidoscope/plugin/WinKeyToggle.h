@@ -24,12 +24,15 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/key_defs.h"              // for Key_LeftGui, Key_RightGui
+#include "kaleidoscope/key_interest.h"          // for KALEIDOSCOPE_KEY_INTEREST
 #include "kaleidoscope/plugin.h"                // for Plugin
 
 namespace kaleidoscope {
 namespace plugin {
 class WinKeyToggle : public kaleidoscope::Plugin {
  public:
+  KALEIDOSCOPE_KEY_INTEREST(singleKey(Key_LeftGui), singleKey(Key_RightGui))
   EventHandlerResult onKeyEvent(KeyEvent &event);
   void toggle() {
     enabled_ = !enabled_;
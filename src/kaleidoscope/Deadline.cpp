@@ -0,0 +1,82 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/Deadline.h"
+
+namespace kaleidoscope {
+
+bool DeadlineScheduler::unlink(Deadline *&list, Deadline &deadline) {
+  for (Deadline **link = &list; *link != nullptr; link = &(*link)->next_) {
+    if (*link == &deadline) {
+      *link          = deadline.next_;
+      deadline.next_ = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DeadlineScheduler::cancel(Deadline &deadline) {
+  if (!deadline.armed_)
+    return;
+  if (!unlink(head_, deadline))
+    unlink(expired_, deadline);
+  deadline.armed_ = false;
+}
+
+void DeadlineScheduler::arm(Deadline &deadline, uint32_t expiry) {
+  cancel(deadline);
+
+  deadline.expiry_ = expiry;
+  deadline.armed_  = true;
+
+  // Deadlines with the same expiry time expire in the order they were armed.
+  Deadline **link = &head_;
+  while (*link != nullptr && !expiresBefore(expiry, (*link)->expiry_))
+    link = &(*link)->next_;
+  deadline.next_ = *link;
+  *link          = &deadline;
+}
+
+void DeadlineScheduler::dispatch(uint32_t now) {
+  if (head_ == nullptr || expiresBefore(now, head_->expiry_))
+    return;
+
+  // Move the expired deadlines to a list of their own before calling any of
+  // them, so that ones re-armed by their callbacks wait for the next call.
+  Deadline **link = &head_;
+  while (*link != nullptr && !expiresBefore(now, (*link)->expiry_))
+    link = &(*link)->next_;
+  expired_ = head_;
+  head_    = *link;
+  *link    = nullptr;
+
+  while (expired_ != nullptr) {
+    Deadline &deadline = *expired_;
+    expired_           = deadline.next_;
+    deadline.next_     = nullptr;
+    deadline.armed_    = false;
+    deadline.callback_();
+  }
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,103 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t
+
+namespace kaleidoscope {
+
+// A `Deadline` is a timer that calls a function when it expires, so that
+// plugins waiting for a timeout don't need to check for it on every cycle. Each
+// plugin owns its deadlines (typically as static members), and arms, re-arms
+// and cancels them through `Runtime`:
+//
+//   Deadline MyPlugin::timeout_{MyPlugin::onTimeout};
+//   ...
+//   Runtime.armDeadline(timeout_, 200);
+//
+// Armed deadlines are kept in a list sorted by expiry time, which is linked
+// through the deadlines themselves. There's no separate storage to run out of,
+// and the cost of each cycle is one comparison, plus the callbacks of the
+// deadlines that expired in it.
+class Deadline {
+ public:
+  typedef void (*Callback)();
+
+  explicit constexpr Deadline(Callback callback)
+    : callback_(callback) {}
+
+  Deadline(const Deadline &)            = delete;
+  Deadline &operator=(const Deadline &) = delete;
+
+  bool isArmed() const {
+    return armed_;
+  }
+  // The time (in milliseconds) when the deadline expires, or last expired.
+  uint32_t expiry() const {
+    return expiry_;
+  }
+
+ private:
+  friend class DeadlineScheduler;
+
+  Callback callback_;
+  Deadline *next_{nullptr};
+  uint32_t expiry_{0};
+  bool armed_{false};
+};
+
+class DeadlineScheduler {
+ public:
+  // Arms `deadline` to expire at time `expiry`, replacing its previous expiry
+  // time if it was already armed.
+  void arm(Deadline &deadline, uint32_t expiry);
+  void cancel(Deadline &deadline);
+
+  // Calls the callbacks of all deadlines that have expired at time `now`, in
+  // order of expiry, and disarms them. Callbacks may re-arm or cancel any
+  // deadline, including ones that have expired but not been called yet; one
+  // that is re-armed to a time that has already passed expires again on the
+  // next call, not this one.
+  void dispatch(uint32_t now);
+
+  // The armed deadline that expires first, or `nullptr` if none are armed.
+  const Deadline *next() const {
+    return head_;
+  }
+
+ private:
+  Deadline *head_{nullptr};
+  // Deadlines that have expired, and are waiting for `dispatch()` to call them
+  Deadline *expired_{nullptr};
+
+  static bool unlink(Deadline *&list, Deadline &deadline);
+
+  // Expiry times may wrap around, so they are compared by their difference,
+  // which is valid as long as all armed deadlines are within 2^31 ms (about 24
+  // days) of each other.
+  static bool expiresBefore(uint32_t a, uint32_t b) {
+    return int32_t(a - b) < 0;
+  }
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,144 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/HIDReportKeySet.h"
+
+#include <string.h>  // for memset
+
+#include "kaleidoscope/key_defs.h"  // for Key, Key_Masked, CONSUMER, ...
+
+namespace kaleidoscope {
+
+// -----------------------------------------------------------------------------
+void HIDReportKeySet::clear() {
+  keycode_count_ = 0;
+  memset(modifier_counts_, 0, sizeof(modifier_counts_));
+  consumer_key_   = Key_NoKey;
+  consumer_count_ = 0;
+  valid_          = true;
+}
+
+// -----------------------------------------------------------------------------
+// This mirrors what `Runtime_::addToReport()` does with a `Key` value (minus the
+// `onAddToReport()` handlers), so the set always holds exactly the keycodes that
+// a full scan of `live_keys` would add to the reports.
+void HIDReportKeySet::adjust(Key key, int8_t delta) {
+  // Masked entries (and `Key_NoKey`, which has the same value) are skipped by
+  // the full scan, too.
+  if (key == Key_Masked)
+    return;
+
+  if (key.isModLayerKey()) {
+    adjustModifier(key.getKeyCode() % 8, delta);
+    return;
+  }
+
+  if (key.isKeyboardKey()) {
+    uint8_t keycode = key.getKeyCode();
+    if (key.isKeyboardModifier()) {
+      // Intentional modifiers keep their flags, and their keycode byte is a
+      // modifier, too.
+      adjustModifiers(key.getFlags(), delta);
+      adjustModifier(keycode - HID_KEYBOARD_FIRST_MODIFIER, delta);
+    } else {
+      // Incidental modifier flags are stripped from non-modifier keys.
+      adjustKeycode(keycode, delta);
+    }
+    return;
+  }
+
+  if (key.isConsumerControlKey()) {
+    adjustConsumer(key, delta);
+  }
+
+  // System Control keys and layer keys don't get added to reports when held.
+}
+
+// -----------------------------------------------------------------------------
+void HIDReportKeySet::adjustModifiers(uint8_t flags, int8_t delta) {
+  // These must match the keycodes used by the Keyboard HID driver's
+  // `pressModifiers()`.
+  if (flags & CTRL_HELD)
+    adjustModifier(Key_LeftControl.getKeyCode() - HID_KEYBOARD_FIRST_MODIFIER, delta);
+  if (flags & SHIFT_HELD)
+    adjustModifier(Key_LeftShift.getKeyCode() - HID_KEYBOARD_FIRST_MODIFIER, delta);
+  if (flags & LALT_HELD)
+    adjustModifier(Key_LeftAlt.getKeyCode() - HID_KEYBOARD_FIRST_MODIFIER, delta);
+  if (flags & GUI_HELD)
+    adjustModifier(Key_LeftGui.getKeyCode() - HID_KEYBOARD_FIRST_MODIFIER, delta);
+  if (flags & RALT_HELD)
+    adjustModifier(Key_RightAlt.getKeyCode() - HID_KEYBOARD_FIRST_MODIFIER, delta);
+}
+
+// -----------------------------------------------------------------------------
+void HIDReportKeySet::adjustModifier(uint8_t index, int8_t delta) {
+  if (delta < 0 && modifier_counts_[index] == 0) {
+    // This can only happen if `live_keys` was changed without us being told.
+    valid_ = false;
+    return;
+  }
+  modifier_counts_[index] += delta;
+}
+
+// -----------------------------------------------------------------------------
+void HIDReportKeySet::adjustKeycode(uint8_t keycode, int8_t delta) {
+  for (uint8_t i{0}; i < keycode_count_; ++i) {
+    if (keycodes_[i] != keycode)
+      continue;
+    keycode_counts_[i] += delta;
+    if (keycode_counts_[i] == 0) {
+      // Keep the table packed by moving the last entry into the empty slot.
+      --keycode_count_;
+      keycodes_[i]       = keycodes_[keycode_count_];
+      keycode_counts_[i] = keycode_counts_[keycode_count_];
+    }
+    return;
+  }
+
+  if (delta < 0 || keycode_count_ == kMaxKeycodes) {
+    valid_ = false;
+    return;
+  }
+  keycodes_[keycode_count_]       = keycode;
+  keycode_counts_[keycode_count_] = 1;
+  ++keycode_count_;
+}
+
+// -----------------------------------------------------------------------------
+void HIDReportKeySet::adjustConsumer(Key key, int8_t delta) {
+  if (consumer_count_ == 0) {
+    if (delta < 0) {
+      valid_ = false;
+      return;
+    }
+    consumer_key_ = key;
+  } else if (CONSUMER(key) != CONSUMER(consumer_key_)) {
+    // The Consumer Control report holds keycodes in the order they were added,
+    // which we can't reproduce without scanning `live_keys`, so we only track
+    // one distinct Consumer Control keycode.
+    valid_ = false;
+    return;
+  }
+  consumer_count_ += delta;
+}
+
+}  // namespace kaleidoscope
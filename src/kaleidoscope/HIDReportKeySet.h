@@ -0,0 +1,119 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/key_defs.h"  // for Key, Key_LeftControl, Key_NoKey
+
+namespace kaleidoscope {
+
+/// A reference-counted set of the keycodes contributed to the HID reports by
+/// the entries in the `live_keys` array
+///
+/// When incremental report building is enabled (see
+/// `Runtime.enableIncrementalReports()`), `LiveKeys` calls `add()` and
+/// `remove()` every time one of its entries changes value, so this object
+/// always holds the set of Keyboard keycodes, Keyboard modifiers, and Consumer
+/// Control keycodes that a full scan of `live_keys` would add to the reports.
+/// Each distinct value carries a count of the number of `live_keys` entries
+/// that contribute it, so that two keys sending the same keycode don't release
+/// it when only one of them is released.
+///
+/// The storage for non-modifier keycodes is a small fixed-size table, to keep
+/// the RAM cost low on AVR. If more distinct values are active than it can
+/// hold (or more than one Consumer Control key is active, in which case report
+/// order matters), the set marks itself as invalid, and `Runtime` falls back to
+/// a full rebuild, which also reseeds the set from `live_keys`.
+class HIDReportKeySet {
+ public:
+  static constexpr uint8_t kMaxKeycodes = 16;
+
+  /// Add the HID keycode(s) contributed by `key` to the set.
+  void add(Key key) {
+    if (enabled_)
+      adjust(key, +1);
+  }
+  /// Remove the HID keycode(s) contributed by `key` from the set.
+  void remove(Key key) {
+    if (enabled_)
+      adjust(key, -1);
+  }
+
+  /// Empty the set. The set is valid afterwards.
+  void clear();
+
+  void enable() {
+    clear();
+    enabled_ = true;
+    valid_   = false;
+  }
+  void disable() {
+    enabled_ = false;
+  }
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  /// Returns `true` if the set reflects the contents of `live_keys`.
+  bool isValid() const {
+    return enabled_ && valid_;
+  }
+  void invalidate() {
+    valid_ = false;
+  }
+
+  /// Add every keycode in the set to the HID reports of `keyboard`, which is
+  /// expected to be the device's `hid().keyboard()` object. Keycodes are
+  /// added directly, without calling any `onAddToReport()` handlers.
+  template<typename _Keyboard>
+  void addToReport(_Keyboard &keyboard) const {
+    for (uint8_t i{0}; i < 8; ++i) {
+      if (modifier_counts_[i] != 0)
+        keyboard.pressRawKey(Key(Key_LeftControl.getKeyCode() + i, KEY_FLAGS));
+    }
+    for (uint8_t i{0}; i < keycode_count_; ++i) {
+      keyboard.pressRawKey(Key(keycodes_[i], KEY_FLAGS));
+    }
+    if (consumer_count_ != 0)
+      keyboard.pressConsumerControl(consumer_key_);
+  }
+
+ private:
+  uint8_t keycodes_[kMaxKeycodes];
+  uint8_t keycode_counts_[kMaxKeycodes];
+  uint8_t keycode_count_ = 0;
+  uint8_t modifier_counts_[8];
+  Key consumer_key_ = Key_NoKey;
+  uint8_t consumer_count_ = 0;
+  bool enabled_ = false;
+  bool valid_   = false;
+
+  void adjust(Key key, int8_t delta);
+  void adjustModifiers(uint8_t flags, int8_t delta);
+  void adjustModifier(uint8_t index, int8_t delta);
+  void adjustKeycode(uint8_t keycode, int8_t delta);
+  void adjustConsumer(Key key, int8_t delta);
+};
+
+}  // namespace kaleidoscope
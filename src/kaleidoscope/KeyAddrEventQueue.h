@@ -39,22 +39,52 @@ namespace kaleidoscope {
 // (press or release). It is optimized for random access to the queue entries,
 // so that each property of each entry can be retrieved without fetching any
 // other data, in order to best serve the specific needs of the Qukeys
-// plugin. Its performance is better for a queue that needs to be searched much
-// more frequently than entries are added or removed.
+// plugin.
+//
+// The entries are stored in a ring buffer, so removing events from the head of
+// the queue (which is what plugins do while draining it, one event per cycle)
+// doesn't move any of the remaining ones.
+//
+// `_Timestamp` can be any unsigned integer type wide enough for the timestamps
+// stored; `append()` records the time of the current cycle by default, but
+// takes other timestamps (e.g. from `micros()`) as well. The `_Bitfield`
+// parameter is no longer used, and only kept so that existing declarations
+// still compile.
 template<uint8_t _capacity,
          typename _Bitfield  = uint8_t,
          typename _Timestamp = uint16_t>
 class KeyAddrEventQueue {
 
-  static_assert(_capacity <= (sizeof(_Bitfield) * 8),
-                "EventQueue error: _Bitfield type too small for _capacity!");
+ public:
+  typedef _Timestamp Timestamp;
 
  private:
+  uint8_t head_{0};
   uint8_t length_{0};
-  KeyEventId event_ids_[_capacity];   // NOLINT(runtime/arrays)
-  KeyAddr addrs_[_capacity];          // NOLINT(runtime/arrays)
-  _Timestamp timestamps_[_capacity];  // NOLINT(runtime/arrays)
-  _Bitfield release_event_bits_;
+  KeyEventId event_ids_[_capacity];                 // NOLINT(runtime/arrays)
+  KeyAddr addrs_[_capacity];                        // NOLINT(runtime/arrays)
+  _Timestamp timestamps_[_capacity];                // NOLINT(runtime/arrays)
+  uint8_t release_event_bits_[(_capacity + 7) / 8];  // NOLINT(runtime/arrays)
+
+  // The position in the buffer of the entry at `index` in the queue
+  uint8_t slot(uint8_t index) const {
+    uint16_t position = head_ + index;
+    return position < _capacity ? position : position - _capacity;
+  }
+
+  bool releaseBit(uint8_t slot) const {
+    return bitRead(release_event_bits_[slot / 8], slot % 8);
+  }
+  void setReleaseBit(uint8_t slot, bool value) {
+    bitWrite(release_event_bits_[slot / 8], slot % 8, value);
+  }
+
+  void copyEntry(uint8_t from, uint8_t to) {
+    event_ids_[to]  = event_ids_[from];
+    addrs_[to]      = addrs_[from];
+    timestamps_[to] = timestamps_[from];
+    setReleaseBit(to, releaseBit(from));
+  }
 
  public:
   uint8_t length() const {
@@ -72,22 +102,22 @@ class KeyAddrEventQueue {
   // the queue, which will terminate when `index >= queue.length()`.
   KeyEventId id(uint8_t index) const {
     // assert(index < length_);
-    return event_ids_[index];
+    return event_ids_[slot(index)];
   }
 
   KeyAddr addr(uint8_t index) const {
     // assert(index < length_);
-    return addrs_[index];
+    return addrs_[slot(index)];
   }
 
   _Timestamp timestamp(uint8_t index) const {
     // assert(index < length_);
-    return timestamps_[index];
+    return timestamps_[slot(index)];
   }
 
   bool isRelease(uint8_t index) const {
     // assert(index < length_);
-    return bitRead(release_event_bits_, index);
+    return releaseBit(slot(index));
   }
   bool isPress(uint8_t index) const {
     // assert(index < length_);
@@ -97,61 +127,54 @@ class KeyAddrEventQueue {
   // Append a new event on the end of the queue. Note: the caller is responsible
   // for bounds checking; we don't guard against it here.
   void append(const KeyEvent &event) {
+    append(event, Runtime.millisAtCycleStart());
+  }
+
+  void append(const KeyEvent &event, _Timestamp timestamp) {
     // assert(length_ < _capacity);
-    event_ids_[length_]  = event.id();
-    addrs_[length_]      = event.addr;
-    timestamps_[length_] = Runtime.millisAtCycleStart();
-    bitWrite(release_event_bits_, length_, keyToggledOff(event.state));
+    uint8_t i      = slot(length_);
+    event_ids_[i]  = event.id();
+    addrs_[i]      = event.addr;
+    timestamps_[i] = timestamp;
+    setReleaseBit(i, keyToggledOff(event.state));
     ++length_;
   }
 
-  // Remove an event from the head of the queue, shifting the subsequent
-  // ones. This function actually shifts the queue by copying element values,
-  // rather than using a ring buffer because we expect it will be called much
-  // less often than the queue is searched via a for loop.
+  // Remove the event at index `n` from the queue. Removing the head of the
+  // queue doesn't move any entries; otherwise, the ones on the shorter side of
+  // `n` are moved over by one.
   void remove(uint8_t n = 0) {
-    if (n >= length_ || length_ == 0)
+    if (n >= length_)
       return;
-    // assert(length > n);
-    --length_;
-    for (uint8_t i{n}; i < length_; ++i) {
-      event_ids_[i]  = event_ids_[i + 1];
-      addrs_[i]      = addrs_[i + 1];
-      timestamps_[i] = timestamps_[i + 1];
+    if (n < length_ / 2) {
+      for (uint8_t i{n}; i > 0; --i)
+        copyEntry(slot(i - 1), slot(i));
+      head_ = slot(1);
+    } else {
+      for (uint8_t i{n}; i + 1 < length_; ++i)
+        copyEntry(slot(i + 1), slot(i));
     }
-    // mask = all ones for bits >= n, zeros otherwise
-    _Bitfield mask = _Bitfield(~0) << n;
-    // use the inverse mask to get just the low bits (that won't be shifted)
-    _Bitfield low_bits = release_event_bits_ & ~mask;
-    // shift the event bits
-    release_event_bits_ >>= 1;
-    // use the mask to zero the low bits, leaving only the shifted high bits
-    release_event_bits_ &= mask;
-    // add the low bits back in
-    release_event_bits_ |= low_bits;
+    --length_;
   }
 
   void shift() {
     remove(0);
   }
 
+  // Remove the first `n` events from the queue.
   void shift(uint8_t n) {
     if (n >= length_) {
       clear();
       return;
     }
+    head_ = slot(n);
     length_ -= n;
-    for (uint8_t i{0}; i < length_; ++i) {
-      addrs_[i]      = addrs_[i + n];
-      timestamps_[i] = timestamps_[i + n];
-    }
-    release_event_bits_ >>= n;
   }
 
   // Empty the queue entirely.
   void clear() {
-    length_             = 0;
-    release_event_bits_ = 0;
+    head_   = 0;
+    length_ = 0;
   }
 
   KeyEvent event(uint8_t i) const {
@@ -167,7 +190,7 @@ class KeyAddrEventQueue {
     // The compiler doesn't let us preserve the type of our integers here, so we
     // need to convert the difference back to int8_t to avoid a bug when it
     // overflows and the new event id is negative, but the old id is positive.
-    KeyEventId offset = event.id() - event_ids_[0];
+    KeyEventId offset = event.id() - id(0);
     // If the offset is negative, the event being processed is older than the
     // first event in the queue.  This shouldn't happen because the caller
     // should first check `KeyEventTracker::shouldIgnore()`, and only call this
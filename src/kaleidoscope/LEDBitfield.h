@@ -0,0 +1,91 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for bitClear, bitRead, bitSet, bitWrite
+#include <stdint.h>   // for uint8_t
+#include <string.h>   // for memset
+
+#include "kaleidoscope/KeyAddrBitfield.h"  // for bitfieldSize
+#include "kaleidoscope/device/device.h"    // for Device
+
+namespace kaleidoscope {
+
+// ================================================================================
+// A bitfield with one bit per LED of the device, indexed by LED index (not by
+// `KeyAddr`, as LEDs that aren't under a key have an index, too). Used by
+// `LEDControl` to keep track of the LEDs that changed since the last sync.
+class LEDBitfield {
+
+ public:
+  static constexpr uint8_t size         = Device::led_count;
+  static constexpr uint8_t block_size   = 8 * sizeof(uint8_t);
+  // A device without LEDs still gets one (unused) block, so that the array
+  // below isn't empty.
+  static constexpr uint8_t total_blocks = size == 0 ? 1 : bitfieldSize<uint8_t>(size);
+
+  static constexpr uint8_t blockIndex(uint8_t led_index) {
+    return led_index / block_size;
+  }
+  static constexpr uint8_t bitIndex(uint8_t led_index) {
+    return led_index % block_size;
+  }
+
+  bool read(uint8_t led_index) const {
+    // assert(led_index < size);
+    return bitRead(data_[blockIndex(led_index)], bitIndex(led_index));
+  }
+  void set(uint8_t led_index) {
+    // assert(led_index < size);
+    bitSet(data_[blockIndex(led_index)], bitIndex(led_index));
+  }
+  void clear(uint8_t led_index) {
+    // assert(led_index < size);
+    bitClear(data_[blockIndex(led_index)], bitIndex(led_index));
+  }
+  void write(uint8_t led_index, bool value) {
+    // assert(led_index < size);
+    bitWrite(data_[blockIndex(led_index)], bitIndex(led_index), value);
+  }
+  void clear() {
+    memset(data_, 0, sizeof(data_));
+  }
+  void setAll() {
+    memset(data_, 0xff, sizeof(data_));
+  }
+
+  // Returns `true` if no bits are set.
+  bool isEmpty() const {
+    for (uint8_t b{0}; b < total_blocks; ++b) {
+      if (data_[b] != 0)
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  uint8_t data_[total_blocks] = {};
+
+} __attribute__((packed));  // class LEDBitfield {
+
+}  // namespace kaleidoscope
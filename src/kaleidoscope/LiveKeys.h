@@ -22,10 +22,12 @@
 
 #pragma once
 
-#include "kaleidoscope/KeyAddr.h"     // for KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"  // for KeyAddrMap<>::Iterator, KeyAddrMap
-#include "kaleidoscope/KeyMap.h"      // for KeyMap
-#include "kaleidoscope/key_defs.h"    // for Key, Key_Masked, Key_Inactive
+#include "kaleidoscope/HIDReportKeySet.h"  // for HIDReportKeySet
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"  // for KeyAddrBitfield
+#include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyMap.h"           // for KeyMap
+#include "kaleidoscope/key_defs.h"         // for Key, Key_Masked, Key_Inactive
 
 namespace kaleidoscope {
 
@@ -47,6 +49,14 @@ namespace kaleidoscope {
 /// engaged), and the `Key` value is what the that key is "sending" at the
 /// time. At the end of its processing of a `KeyEvent`, Kaleidoscope will use
 /// the contents of this array to populate the Keyboard HID reports.
+///
+/// The `activate()`, `clear()`, and `mask()` methods also keep an index of the
+/// entries that are not inactive up to date, so that code which only cares
+/// about held keys can use `active()` instead of scanning every entry. When
+/// incremental report building is enabled, they also maintain a
+/// reference-counted set of the HID keycodes contributed by the active entries.
+/// Entries should therefore only be changed through those methods, not by
+/// assigning to a reference returned by the subscript operator.
 
 class LiveKeys {
  public:
@@ -72,20 +82,20 @@ class LiveKeys {
   /// Set an entry to "active" with a specified `Key` value.
   void activate(KeyAddr key_addr, Key key) {
     if (key_addr.isValid())
-      key_map_[key_addr] = key;
+      set(key_addr, key);
   }
 
   /// Deactivate an entry by setting its value to `Key_Inactive`.
   void clear(KeyAddr key_addr) {
     if (key_addr.isValid())
-      key_map_[key_addr] = Key_Inactive;
+      set(key_addr, Key_Inactive);
   }
 
   /// Mask a key by setting its entry to `Key_Masked`. The key will become
   /// unmasked by Kaleidoscope on release (but not on a key press event).
   void mask(KeyAddr key_addr) {
     if (key_addr.isValid())
-      key_map_[key_addr] = Key_Masked;
+      set(key_addr, Key_Masked);
   }
 
   /// Clear the entire array by setting all values to `Key_Inactive`.
@@ -93,6 +103,8 @@ class LiveKeys {
     for (Key &key : key_map_) {
       key = Key_Inactive;
     }
+    active_keys_.clear();
+    report_keys_.clear();
   }
 
   /// Returns an iterator for use in range-based for loops:
@@ -102,9 +114,40 @@ class LiveKeys {
     return key_map_;
   }
 
+  /// Returns an iterator over the addresses of all entries that are not
+  /// inactive (including masked ones), for use in range-based for loops:
+  ///
+  ///   for (KeyAddr key_addr : live_keys.active()) {...}
+  ///
+  /// This only visits the keys that are actually held, rather than every
+  /// entry in the array.
+  const KeyAddrBitfield &active() const {
+    return active_keys_;
+  }
+
+  /// Returns `true` if the entry for `key_addr` is not inactive.
+  bool isActive(KeyAddr key_addr) const {
+    return key_addr.isValid() && active_keys_.read(key_addr);
+  }
+
+  /// Returns the set of HID keycodes contributed by the active entries. It is
+  /// only maintained while incremental report building is enabled.
+  HIDReportKeySet &reportKeys() {
+    return report_keys_;
+  }
+
  private:
   KeyMap key_map_;
+  KeyAddrBitfield active_keys_;
+  HIDReportKeySet report_keys_;
   mutable Key dummy_{0, 0};
+
+  void set(KeyAddr key_addr, Key key) {
+    report_keys_.remove(key_map_[key_addr]);
+    key_map_[key_addr] = key;
+    active_keys_.write(key_addr, key != Key_Inactive);
+    report_keys_.add(key);
+  }
 };
 
 extern LiveKeys live_keys;
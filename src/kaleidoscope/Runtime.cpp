@@ -25,18 +25,25 @@
 #include <Arduino.h>         // for millis
 #include <HardwareSerial.h>  // for HardwareSerial
 
+#include "kaleidoscope/Deadline.h"                  // for DeadlineScheduler
+#include "kaleidoscope/HIDReportKeySet.h"           // for HIDReportKeySet
 #include "kaleidoscope/KeyAddr.h"                   // for KeyAddr, MatrixAddr, MatrixAddr...
+#include "kaleidoscope/KeyAddrBitfield.h"           // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"                  // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"                  // for LiveKeys, live_keys
 #include "kaleidoscope/device/device.h"             // for Base<>::HID, VirtualProps::HID
 #include "kaleidoscope/driver/hid/base/Keyboard.h"  // for Keyboard
 #include "kaleidoscope/keyswitch_state.h"           // for keyToggledOff, keyToggledOn
 #include "kaleidoscope/layers.h"                    // for Layer, Layer_
+#include "kaleidoscope_internal/latency_trace.h"    // for reportSent
 
 namespace kaleidoscope {
 
 uint32_t Runtime_::millis_at_cycle_start_;
 KeyAddr Runtime_::last_addr_toggled_on_ = KeyAddr::none();
+bool Runtime_::full_report_requested_   = false;
+DeadlineScheduler Runtime_::deadlines_;
+constexpr uint32_t Runtime_::no_deadline;
 
 static void onUSBReset();
 
@@ -89,6 +96,10 @@ void Runtime_::loop(void) {
   // event is being handled at a time.
   device().scanMatrix();
 
+  // Call the plugins whose deadlines have expired, before the
+  // `afterEachCycle()` handlers, which is where most plugins used to check for
+  // their timeouts.
+  deadlines_.dispatch(millis_at_cycle_start_);
 
   kaleidoscope::Hooks::afterEachCycle();
 
@@ -215,23 +226,46 @@ void Runtime_::prepareKeyboardReport(const KeyEvent &event) {
   // before building the new report, start clean
   device().hid().keyboard().releaseAllKeys();
 
-  // Build report from composite keymap cache. This can be much more efficient
-  // with a bitfield. What we should be doing here is going through the array
-  // and checking for HID values (Keyboard, Consumer, System) and directly
-  // adding them to their respective reports. This comes before the old plugin
-  // hooks are called for the new event so that the report will be full complete
-  // except for that new event.
-  for (KeyAddr key_addr : KeyAddr::all()) {
+  HIDReportKeySet &report_keys = live_keys.reportKeys();
+
+  // If incremental report building is enabled, and the set of keycodes it
+  // maintains is intact, we can build the report straight from that set. As
+  // with the full scan below, this event's key gets left out, to be dealt with
+  // later.
+  if (report_keys.isValid() && !full_report_requested_) {
+    Key event_key = live_keys[event.addr];
+    report_keys.remove(event_key);
+    report_keys.addToReport(hid().keyboard());
+    report_keys.add(event_key);
+    return;
+  }
+  full_report_requested_ = false;
+
+  // If incremental report building is enabled, but we got here anyway, we
+  // reseed its set of keycodes while we scan the `live_keys` array.
+  bool reseed_report_keys = report_keys.isEnabled();
+  if (reseed_report_keys)
+    report_keys.clear();
+
+  // Build report from composite keymap cache. Only the entries that aren't
+  // inactive need to be checked, so we use the `live_keys` index of active
+  // entries instead of going through the whole array. This comes before the
+  // old plugin hooks are called for the new event so that the report will be
+  // full complete except for that new event.
+  for (KeyAddr key_addr : live_keys.active()) {
+    Key key = live_keys[key_addr];
+
+    if (reseed_report_keys)
+      report_keys.add(key);
+
     // Skip this event's key addr; we will deal with that later. This is most
     // important in the case of a key release, because we can't safely remove
     // any keycode(s) added to the report later.
     if (key_addr == event.addr)
       continue;
 
-    Key key = live_keys[key_addr];
-
-    // If the key is idle or masked, we can ignore it.
-    if (key == Key_Inactive || key == Key_Masked)
+    // If the key is masked, we can ignore it.
+    if (key == Key_Masked)
       continue;
 
     addToReport(key);
@@ -312,6 +346,9 @@ void Runtime_::sendKeyboardReport(const KeyEvent &event) {
 
   // Finally, send the report:
   device().hid().keyboard().sendReport();
+
+  // If latency tracing is enabled, this is the report that reflects the event.
+  kaleidoscope_internal::latency_trace::reportSent(event);
 }
 
 Runtime_ Runtime;
@@ -22,8 +22,9 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint32_t
+#include <stdint.h>  // for uint32_t, int32_t
 
+#include "kaleidoscope/Deadline.h"              // for Deadline, DeadlineScheduler
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
@@ -139,7 +140,84 @@ class Runtime_ {
     return (elapsed_time >= ttl);
   }
 
+  /** Returns the time (in milliseconds) from the start of the current cycle
+   * until `hasTimeExpired(start_time, ttl)` returns true, or zero if it already
+   * does. Plugins use this to arm a deadline for a timer that started before
+   * the current cycle.
+   */
+  template<typename _Timestamp, typename _Timeout>
+  static uint32_t millisUntilTimeExpires(_Timestamp start_time, _Timeout ttl) {
+    _Timestamp current_time = millis_at_cycle_start_;
+    _Timestamp elapsed_time = current_time - start_time;
+    return elapsed_time >= ttl ? 0 : ttl - elapsed_time;
+  }
+
+  /** Deadlines
+   *
+   * Instead of checking `hasTimeExpired()` on every cycle, plugins can arm a
+   * `Deadline` (see `kaleidoscope/Deadline.h`), and have its callback called
+   * once it expires. Expired deadlines are dispatched once per cycle, after
+   * the key scan, and before the `afterEachCycle()` handlers.
+   *
+   * - `armDeadline(deadline, ttl)` arms the deadline to expire `ttl` ms after
+   *      the start of the current cycle. This is equivalent to calling
+   *      `hasTimeExpired(Runtime.millisAtCycleStart(), ttl)` on every
+   *      following cycle, until it returns true.
+   *
+   * - `rearmDeadline(deadline, interval)` arms the deadline to expire
+   *      `interval` ms after it last expired, for timers that need to fire at
+   *      regular intervals without drifting.
+   *
+   * - `cancelDeadline(deadline)` disarms the deadline without calling it.
+   *
+   * Arming an already armed deadline replaces its expiry time.
+   */
+  static void armDeadline(Deadline &deadline, uint32_t ttl) {
+    deadlines_.arm(deadline, millis_at_cycle_start_ + ttl);
+  }
+  static void rearmDeadline(Deadline &deadline, uint32_t interval) {
+    deadlines_.arm(deadline, deadline.expiry() + interval);
+  }
+  static void cancelDeadline(Deadline &deadline) {
+    deadlines_.cancel(deadline);
+  }
+
+  /** Returns the time (in milliseconds) until the next armed deadline expires,
+   * counted from the start of the current cycle. Returns zero if it has
+   * already expired, and `no_deadline` if there are no deadlines armed.
+   *
+   * This only covers deadlines; devices that sleep between cycles should use
+   * `millisUntilNextWake()` instead.
+   */
+  static constexpr uint32_t no_deadline = 0xffffffff;
+  static uint32_t millisUntilNextDeadline() {
+    const Deadline *next = deadlines_.next();
+    if (next == nullptr)
+      return no_deadline;
+    int32_t remaining = next->expiry() - millis_at_cycle_start_;
+    return remaining > 0 ? remaining : 0;
+  }
+
+  /** Returns the time (in milliseconds) until the next cycle is needed,
+   * counted from the start of the current cycle: the time until the next
+   * deadline, or zero while there's work to do right away, such as background
+   * storage maintenance. Returns `no_deadline` if nothing is waiting at all.
+   *
+   * Devices use this to decide how long they may sleep between cycles.
+   */
+  static uint32_t millisUntilNextWake() {
+    if (device().storage().hasPendingWork())
+      return 0;
+    return millisUntilNextDeadline();
+  }
+
+  // Commands registered with `KALEIDOSCOPE_FOCUS_COMMANDS()` go straight to
+  // the plugins that own them; the rest (and any that the owner doesn't
+  // consume) are broadcast to all plugins.
   EventHandlerResult onFocusEvent(const char *input) {
+    EventHandlerResult result = kaleidoscope::Hooks::routeFocusCommand(input);
+    if (result != EventHandlerResult::OK)
+      return result;
     return kaleidoscope::Hooks::onFocusEvent(input);
   }
 
@@ -182,6 +260,30 @@ class Runtime_ {
    */
   void prepareKeyboardReport(const KeyEvent &event);
 
+  /** Incremental report building
+   *
+   * By default, `prepareKeyboardReport()` rebuilds the HID reports for each
+   * event by scanning the whole `live_keys` array, calling the `onAddToReport()`
+   * handlers for every active key. When incremental report building is
+   * enabled, `live_keys` maintains a reference-counted set of the keycodes its
+   * active entries contribute, and the reports are built directly from that
+   * set, without scanning `live_keys` or calling `onAddToReport()` for keys
+   * other than the one that triggered the report.
+   *
+   * Plugins that depend on `onAddToReport()` being called for all active keys
+   * must call `requestFullReportRebuild()` (typically from `onKeyEvent()`) for
+   * any event that needs it. The next report is then built by a full scan.
+   */
+  void enableIncrementalReports() {
+    live_keys.reportKeys().enable();
+  }
+  void disableIncrementalReports() {
+    live_keys.reportKeys().disable();
+  }
+  void requestFullReportRebuild() {
+    full_report_requested_ = true;
+  }
+
   /** Add keycode(s) to a USB HID report
    *
    * This method gets called from `prepareKeyboardReport()` to add keycodes
@@ -231,6 +333,8 @@ class Runtime_ {
  private:
   static uint32_t millis_at_cycle_start_;
   static KeyAddr last_addr_toggled_on_;
+  static bool full_report_requested_;
+  static DeadlineScheduler deadlines_;
 };
 
 extern kaleidoscope::Runtime_ Runtime;
@@ -32,16 +32,18 @@
 #include <stdint.h>  // for uint8_t, int8_t, uint32_t
 #include <string.h>  // for size_t, strlen, memcpy
 
-#include "kaleidoscope/driver/bootloader/None.h"  // for None
-#include "kaleidoscope/driver/hid/Base.h"         // for Base, BaseProps
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for BaseProps
-#include "kaleidoscope/driver/keyscanner/None.h"  // for None
-#include "kaleidoscope/driver/led/None.h"         // for cRGB, BaseProps, CRGB, None
-#include "kaleidoscope/driver/mcu/Base.h"         // for BaseProps
-#include "kaleidoscope/driver/mcu/None.h"         // for None
-#include "kaleidoscope/driver/storage/Base.h"     // for BaseProps
-#include "kaleidoscope/driver/storage/None.h"     // for None
-#include "kaleidoscope/driver/ble/None.h"         // for None
+#include "kaleidoscope/driver/bootloader/None.h"        // for None
+#include "kaleidoscope/driver/hid/Base.h"               // for Base, BaseProps
+#include "kaleidoscope/driver/i2c/Telemetry.h"          // for Telemetry
+#include "kaleidoscope/driver/keyscanner/Base.h"        // for BaseProps
+#include "kaleidoscope/driver/keyscanner/None.h"        // for None
+#include "kaleidoscope/driver/keyscanner/ScanTiming.h"  // for ScanTiming
+#include "kaleidoscope/driver/led/None.h"               // for cRGB, BaseProps, CRGB, None
+#include "kaleidoscope/driver/mcu/Base.h"               // for BaseProps
+#include "kaleidoscope/driver/mcu/None.h"               // for None
+#include "kaleidoscope/driver/storage/Base.h"           // for BaseProps
+#include "kaleidoscope/driver/storage/None.h"           // for None
+#include "kaleidoscope/driver/ble/None.h"               // for None
 
 #include "kaleidoscope/driver/battery_charger/None.h"  // for None
 #include "kaleidoscope/driver/battery_gauge/None.h"    // for None
@@ -261,6 +263,28 @@ class Base {
     return mcu_;
   }
 
+  /**
+   * Returns the bus usage statistics of the `n`th device the keyboard talks to
+   * over I2C, or `nullptr` if there is no such device.
+   */
+  driver::i2c::Telemetry *i2cTelemetry(uint8_t n) {
+    return nullptr;
+  }
+
+  /**
+   * Copies the timing of the matrix scans into `timing`. Returns `false` if
+   * the key scanner doesn't keep track of it.
+   */
+  bool scanTiming(driver::keyscanner::ScanTiming &timing) {
+    return false;
+  }
+
+  /**
+   * Restarts the timing of the matrix scans, if the key scanner keeps track of
+   * it.
+   */
+  void resetScanTiming() {}
+
   /**
    * Returns the short name of the device.
    */
@@ -280,6 +304,13 @@ class Base {
   void syncLeds(void) {
     led_driver_.syncLeds();
   }
+  /**
+   * Returns true if the last @ref syncLeds didn't get all of the changes to
+   * the device, and needs to be called again, even if nothing else changed.
+   */
+  bool isLEDSyncPending() {
+    return led_driver_.isSyncPending();
+  }
   /**
    * Set the color of a per-key LED at a given row and column.
    *
@@ -615,9 +646,12 @@ class Base {
   void initSerial() {}
 
   /**
-   * Called between processing cycles, can be used for power management
+   * Called between processing cycles, can be used for power management. Device
+   * drivers that override it should call `storage().betweenCycles()`, too.
    */
-  void betweenCycles() {}
+  void betweenCycles() {
+    storage_.betweenCycles();
+  }
 
   /** @} */
 
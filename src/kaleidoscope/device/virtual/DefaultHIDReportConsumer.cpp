@@ -33,7 +33,10 @@
 #include <virtual_io.h>  // for logUSBEvent_keyboard
 
 // From Kaleidoscope:
+#include "kaleidoscope/Runtime.h"                 // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"           // for VirtualProps::KeyScanner
 #include "kaleidoscope/device/virtual/Logging.h"  // for log_info, logging
+#include "kaleidoscope/device/virtual/Trace.h"    // for TraceWriter, HIDReportRecord
 
 #undef min
 #undef max
@@ -56,8 +59,26 @@ using namespace logging;  // NOLINT(build/namespaces)
   if ((bitfield) & 1 << 6) stream << str6;                                           \
   if ((bitfield) & 1 << 7) stream << str7;
 
+static device::virt::TraceWriter recording;
+static uint32_t recording_start;
+
+bool DefaultHIDReportConsumer::startRecording(const char *path) {
+  recording_start = Runtime.device().keyScanner().scanCount();
+  return recording.open(path, device::virt::TraceKind::HIDReports);
+}
+
+void DefaultHIDReportConsumer::stopRecording() {
+  recording.close();
+}
+
 void DefaultHIDReportConsumer::processHIDReport(
   uint8_t id, const void *data, int len, int result) {
+  if (recording.isOpen() && len <= UINT8_MAX) {
+    recording.write(device::virt::HIDReportRecord{
+      Runtime.device().keyScanner().scanCount() - recording_start,
+      id, static_cast<uint8_t>(len), static_cast<const uint8_t *>(data)});
+  }
+
   if (id != HID_REPORTID_KEYBOARD) {
     log_info("***Ignoring hid report with id = %d\n", id);
     return;
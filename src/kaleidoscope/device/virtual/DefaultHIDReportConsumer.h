@@ -31,6 +31,11 @@ namespace kaleidoscope {
 class DefaultHIDReportConsumer {
  public:
   static void processHIDReport(uint8_t id, const void *data, int len, int result);
+
+  // Records every HID report processed from now on to a trace at `path` (see
+  // Trace.h), stamped with the key scanner's cycle.
+  static bool startRecording(const char *path);
+  static void stopRecording();
 };
 
 }  // namespace kaleidoscope
@@ -0,0 +1,193 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+
+#include "kaleidoscope/device/virtual/Trace.h"
+
+// From system:
+#include <fcntl.h>     // for open, O_RDONLY
+#include <stdio.h>     // for fopen, fwrite, fclose
+#include <string.h>    // for memcmp
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+
+// From Kaleidoscope:
+#include "kaleidoscope/device/virtual/Logging.h"  // for log_error
+
+namespace kaleidoscope {
+namespace device {
+namespace virt {
+
+using namespace kaleidoscope::logging;  // NOLINT(build/namespaces)
+
+static constexpr uint8_t trace_magic[]         = {'K', 'T', 'R', 'C'};
+static constexpr uint8_t trace_version         = 1;
+static constexpr size_t trace_header_size      = 8;
+static constexpr size_t key_event_record_size  = 8;
+static constexpr size_t hid_report_header_size = 6;
+
+static void putCycle(uint8_t *buffer, uint32_t cycle) {
+  buffer[0] = cycle;
+  buffer[1] = cycle >> 8;
+  buffer[2] = cycle >> 16;
+  buffer[3] = cycle >> 24;
+}
+
+static uint32_t getCycle(const uint8_t *buffer) {
+  return uint32_t(buffer[0]) | uint32_t(buffer[1]) << 8 |
+         uint32_t(buffer[2]) << 16 | uint32_t(buffer[3]) << 24;
+}
+
+//##############################################################################
+// TraceWriter
+//##############################################################################
+
+bool TraceWriter::open(const char *path, TraceKind kind) {
+  close();
+  file_ = fopen(path, "wb");
+  if (file_ == nullptr) {
+    log_error("Can't create trace file %s\n", path);
+    return false;
+  }
+
+  uint8_t header[trace_header_size] = {trace_magic[0], trace_magic[1], trace_magic[2], trace_magic[3],
+                                       trace_version, static_cast<uint8_t>(kind), 0, 0};
+  fwrite(header, sizeof(header), 1, file_);
+  return true;
+}
+
+void TraceWriter::close() {
+  if (file_ == nullptr)
+    return;
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void TraceWriter::write(const KeyEventRecord &record) {
+  if (file_ == nullptr)
+    return;
+
+  uint8_t buffer[key_event_record_size];  // NOLINT(runtime/arrays)
+  putCycle(buffer, record.cycle);
+  buffer[4] = record.row;
+  buffer[5] = record.col;
+  buffer[6] = record.pressed ? KeyEventRecord::pressed_flag : 0;
+  buffer[7] = 0;
+  fwrite(buffer, sizeof(buffer), 1, file_);
+}
+
+void TraceWriter::write(const HIDReportRecord &record) {
+  if (file_ == nullptr)
+    return;
+
+  uint8_t buffer[hid_report_header_size];  // NOLINT(runtime/arrays)
+  putCycle(buffer, record.cycle);
+  buffer[4] = record.id;
+  buffer[5] = record.length;
+  fwrite(buffer, sizeof(buffer), 1, file_);
+  fwrite(record.data, 1, record.length, file_);
+}
+
+//##############################################################################
+// TraceReader
+//##############################################################################
+
+bool TraceReader::open(const char *path, TraceKind kind) {
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    log_error("Can't open trace file %s\n", path);
+    return false;
+  }
+
+  struct stat st;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && size_t(st.st_size) >= trace_header_size)
+    mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (mapping == MAP_FAILED) {
+    log_error("Can't read trace file %s\n", path);
+    return false;
+  }
+
+  data_     = static_cast<const uint8_t *>(mapping);
+  size_     = st.st_size;
+  position_ = trace_header_size;
+
+  if (memcmp(data_, trace_magic, sizeof(trace_magic)) != 0 ||
+      data_[4] != trace_version ||
+      data_[5] != static_cast<uint8_t>(kind)) {
+    log_error("%s is not a trace of the expected kind\n", path);
+    close();
+    return false;
+  }
+  return true;
+}
+
+void TraceReader::close() {
+  if (data_ == nullptr)
+    return;
+  munmap(const_cast<uint8_t *>(data_), size_);
+  data_     = nullptr;
+  size_     = 0;
+  position_ = 0;
+}
+
+bool TraceReader::next(KeyEventRecord &record) {
+  if (data_ == nullptr || size_ - position_ < key_event_record_size)
+    return false;
+
+  const uint8_t *buffer = data_ + position_;
+  record.cycle          = getCycle(buffer);
+  record.row            = buffer[4];
+  record.col            = buffer[5];
+  record.pressed        = buffer[6] & KeyEventRecord::pressed_flag;
+  position_ += key_event_record_size;
+  return true;
+}
+
+bool TraceReader::next(HIDReportRecord &record) {
+  if (data_ == nullptr || size_ - position_ < hid_report_header_size)
+    return false;
+
+  const uint8_t *buffer = data_ + position_;
+  uint8_t length        = buffer[5];
+  if (size_ - position_ - hid_report_header_size < length)
+    return false;
+
+  record.cycle  = getCycle(buffer);
+  record.id     = buffer[4];
+  record.length = length;
+  record.data   = buffer + hid_report_header_size;
+  position_ += hid_report_header_size + length;
+  return true;
+}
+
+}  // namespace virt
+}  // namespace device
+}  // namespace kaleidoscope
+
+#endif  // ifdef KALEIDOSCOPE_VIRTUAL_BUILD
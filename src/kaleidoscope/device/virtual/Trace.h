@@ -0,0 +1,127 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+
+// From system:
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint8_t, uint32_t
+#include <stdio.h>   // for FILE
+
+namespace kaleidoscope {
+namespace device {
+namespace virt {
+
+// Binary traces of key events and HID reports, for recording a run of the
+// virtual device, and replaying it deterministically against another build.
+//
+// A trace file starts with an 8-byte header: the magic bytes "KTRC", the
+// format version, the kind of records in it (see `TraceKind`), and two zero
+// bytes. The records follow, with no padding between them; multi-byte values
+// are little-endian. Every record starts with the cycle it belongs to: cycle 1
+// is the first scan of the key matrix after recording (or replaying) started,
+// and cycle 0 is anything before that.
+//
+// Key event records (8 bytes):   cycle (4), row, col, flags, 0
+// HID report records (6 + n):    cycle (4), report id, n, the n report bytes
+
+enum class TraceKind : uint8_t {
+  KeyEvents  = 1,
+  HIDReports = 2,
+};
+
+struct KeyEventRecord {
+  static constexpr uint8_t pressed_flag = 0x01;
+
+  uint32_t cycle;
+  uint8_t row;
+  uint8_t col;
+  bool pressed;
+};
+
+struct HIDReportRecord {
+  uint32_t cycle;
+  uint8_t id;
+  uint8_t length;
+  // When read from a trace, this points into the reader's mapping of the file,
+  // and is only valid until the reader is closed.
+  const uint8_t *data;
+};
+
+class TraceWriter {
+ public:
+  TraceWriter() = default;
+  TraceWriter(const TraceWriter &)            = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+  ~TraceWriter() {
+    close();
+  }
+
+  // Creates (or truncates) the trace file at `path`, and writes its header.
+  bool open(const char *path, TraceKind kind);
+  void close();
+  bool isOpen() const {
+    return file_ != nullptr;
+  }
+
+  void write(const KeyEventRecord &record);
+  void write(const HIDReportRecord &record);
+
+ private:
+  FILE *file_ = nullptr;
+};
+
+class TraceReader {
+ public:
+  TraceReader() = default;
+  TraceReader(const TraceReader &)            = delete;
+  TraceReader &operator=(const TraceReader &) = delete;
+  ~TraceReader() {
+    close();
+  }
+
+  // Maps the trace file at `path` into memory. Fails if it can't be read, or
+  // isn't a trace of the given kind.
+  bool open(const char *path, TraceKind kind);
+  void close();
+  bool isOpen() const {
+    return data_ != nullptr;
+  }
+
+  // Read the next record into `record`. Both return false at the end of the
+  // trace, or if the last record is truncated.
+  bool next(KeyEventRecord &record);
+  bool next(HIDReportRecord &record);
+
+ private:
+  const uint8_t *data_ = nullptr;
+  size_t size_         = 0;
+  size_t position_     = 0;
+};
+
+}  // namespace virt
+}  // namespace device
+}  // namespace kaleidoscope
+
+#endif  // ifdef KALEIDOSCOPE_VIRTUAL_BUILD
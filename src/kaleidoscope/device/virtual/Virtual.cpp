@@ -31,17 +31,19 @@
 #include <HIDReportObserver.h>  // for HIDReportObserver
 // From system:
 #include <stdint.h>      // for uint8_t, uint16_t
-#include <stdlib.h>      // for exit, size_t
+#include <stdlib.h>      // for exit, getenv, size_t
 #include <virtual_io.h>  // for getLineOfInput, isInte...
+#include <chrono>        // for steady_clock, duration  NOLINT(build/c++11): host only
 #include <sstream>       // for operator<<, string
 #include <string>        // for operator==, char_traits
 
 // From Kaleidoscope:
 #include "kaleidoscope/KeyAddr.h"                                  // for MatrixAddr, MatrixAddr...
 #include "kaleidoscope/device/virtual/DefaultHIDReportConsumer.h"  // for DefaultHIDReportConsumer
+#include "kaleidoscope/device/virtual/Trace.h"                     // for KeyEventRecord, TraceKind
 #include "kaleidoscope/device/virtual/Logging.h"                   // for log_error, logging
 #include "kaleidoscope/key_defs.h"                                 // for Key_NoKey
-#include "kaleidoscope/keyswitch_state.h"                          // for IS_PRESSED, WAS_PRESSED
+#include "kaleidoscope/keyswitch_state.h"                          // for IS_PRESSED, WAS_PRESSED, keyTog...
 
 // FIXME: This relates to virtual/cores/arduino/EEPROM.h.
 //        EEPROM static data must be defined here as only
@@ -82,6 +84,64 @@ void VirtualKeyScanner::setup() {
     keystates_[key_addr.toInt()]      = KeyState::NotPressed;
     keystates_prev_[key_addr.toInt()] = KeyState::NotPressed;
   }
+
+  // Traces can also be given in the environment, so that any virtual build can
+  // be run against a recorded trace without changes to the sketch.
+  if (const char *path = getenv("KALEIDOSCOPE_REPLAY_TRACE"))
+    replayTrace(path);
+  if (const char *path = getenv("KALEIDOSCOPE_RECORD_KEYS"))
+    recordTrace(path);
+  if (const char *path = getenv("KALEIDOSCOPE_RECORD_HID"))
+    DefaultHIDReportConsumer::startRecording(path);
+}
+
+bool VirtualKeyScanner::replayTrace(const char *path) {
+  if (!replay_.open(path, TraceKind::KeyEvents))
+    return false;
+
+  replay_has_next_   = replay_.next(replay_next_);
+  replay_start_      = scan_count_;
+  replay_events_     = 0;
+  replay_started_at_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool VirtualKeyScanner::recordTrace(const char *path) {
+  recording_start_ = scan_count_;
+  return recording_.open(path, TraceKind::KeyEvents);
+}
+
+// Applies the key events of the current cycle of the trace being replayed.
+void VirtualKeyScanner::replayCycle() {
+  uint32_t cycle = scan_count_ - replay_start_;
+
+  while (replay_has_next_ && replay_next_.cycle <= cycle) {
+    KeyAddr key_addr(replay_next_.row, replay_next_.col);
+    if (key_addr.isValid()) {
+      KeyState &state = keystates_[key_addr.toInt()];
+      if (replay_next_.pressed) {
+        state = KeyState::Pressed;
+      } else if (state == KeyState::Pressed &&
+                 keystates_prev_[key_addr.toInt()] == KeyState::NotPressed) {
+        // Pressed and released in the same cycle
+        state = KeyState::Tap;
+      } else {
+        state = KeyState::NotPressed;
+      }
+      ++replay_events_;
+    } else {
+      log_error("Bad coordinates in trace: (%d,%d)\n", replay_next_.row, replay_next_.col);
+    }
+    replay_has_next_ = replay_.next(replay_next_);
+  }
+
+  if (!replay_has_next_) {
+    std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - replay_started_at_;
+    log_info("Replayed %u key events over %u cycles in %.3f ms\n",
+             replay_events_, cycle, time.count());
+    replay_.close();
+  }
 }
 
 enum Mode {
@@ -165,6 +225,13 @@ enum Mode {
 
 void VirtualKeyScanner::readMatrix() {
 
+  ++scan_count_;
+
+  if (isReplaying()) {
+    replayCycle();
+    return;
+  }
+
   if (!read_matrix_enabled_) return;
 
   std::stringstream sline;
@@ -266,12 +333,19 @@ void VirtualKeyScanner::actOnMatrixScan() {
       break;
     }
 
+    if (keyToggledOn(key_state) || keyToggledOff(key_state))
+      recording_.write(KeyEventRecord{scan_count_ - recording_start_,
+                                      key_addr.row(), key_addr.col(),
+                                      keyToggledOn(key_state)});
+
     if (key_state != 0)
       handleKeyswitchEvent(Key_NoKey, key_addr, key_state);
     keystates_prev_[key_addr.toInt()] = keystates_[key_addr.toInt()];
 
     if (keystates_[key_addr.toInt()] == KeyState::Tap) {
       key_state = WAS_PRESSED & ~IS_PRESSED;
+      recording_.write(KeyEventRecord{scan_count_ - recording_start_,
+                                      key_addr.row(), key_addr.col(), false});
       handleKeyswitchEvent(Key_NoKey, key_addr, key_state);
       keystates_[key_addr.toInt()]      = KeyState::NotPressed;
       keystates_prev_[key_addr.toInt()] = KeyState::NotPressed;
@@ -31,11 +31,13 @@
 #include KALEIDOSCOPE_HARDWARE_H
 
 // From system:
-#include <stdint.h>  // for uint8_t
+#include <stdint.h>  // for uint8_t, uint32_t
+#include <chrono>    // for steady_clock  NOLINT(build/c++11): host only
 // From Arduino libraries:
 #include <HardwareSerial.h>  // for Serial
 // From Kaleidoscope:
 #include "kaleidoscope/device/Base.h"             // for Base
+#include "kaleidoscope/device/virtual/Trace.h"    // for TraceReader, TraceWriter, KeyEventRecord
 #include "kaleidoscope/driver/bootloader/None.h"  // for None
 #include "kaleidoscope/driver/hid/Keyboardio.h"   // for Keyboardio
 #include "kaleidoscope/driver/keyscanner/Base.h"  // for Base
@@ -86,8 +88,29 @@ class VirtualKeyScanner
   void setKeystate(KeyAddr keyAddr, KeyState ks);
   KeyState getKeystate(KeyAddr keyAddr) const;
 
+  // Replays the key events in the trace at `path` (see Trace.h), starting with
+  // the next scan, in place of reading the matrix state from input. Returns
+  // false if the trace can't be read.
+  bool replayTrace(const char *path);
+  bool isReplaying() const {
+    return replay_.isOpen();
+  }
+
+  // Records every key switch change, starting with the next scan, to a trace
+  // at `path`.
+  bool recordTrace(const char *path);
+  void stopRecording() {
+    recording_.close();
+  }
+
+  // The number of times the matrix has been scanned
+  uint32_t scanCount() const {
+    return scan_count_;
+  }
+
  private:
   bool anythingHeld();
+  void replayCycle();
 
  private:
   uint8_t n_pressed_switches_,
@@ -95,6 +118,18 @@ class VirtualKeyScanner
 
   bool read_matrix_enabled_;
 
+  uint32_t scan_count_ = 0;
+
+  TraceReader replay_;
+  KeyEventRecord replay_next_;
+  bool replay_has_next_  = false;
+  uint32_t replay_start_ = 0;
+  uint32_t replay_events_ = 0;
+  std::chrono::steady_clock::time_point replay_started_at_;
+
+  TraceWriter recording_;
+  uint32_t recording_start_ = 0;
+
   KeyState keystates_[matrix_rows * matrix_columns];       // NOLINT(runtime/arrays)
   KeyState keystates_prev_[matrix_rows * matrix_columns];  // NOLINT(runtime/arrays)
 };
@@ -151,6 +186,20 @@ class VirtualDevice
   auto serialPort() -> decltype(Serial) & {
     return Serial;
   }
+
+  // The virtual clock. Every call to `millis()` moves it forward by one, and
+  // `delay()` moves it forward by the time given, without waiting. These move it
+  // by any amount in a single step, so that simulations can skip ahead.
+  static void advanceClock(uint32_t millis) {
+    delay(millis);
+  }
+  // Moves the clock forward, until it reads `time`. A time in the past leaves
+  // it alone.
+  static void setClock(uint32_t time) {
+    uint32_t now = millis();
+    if (int32_t(time - now) > 0)
+      delay(time - now);
+  }
 };
 
 }  // namespace virt
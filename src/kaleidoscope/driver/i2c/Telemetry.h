@@ -0,0 +1,77 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t, UINT16_MAX
+
+namespace kaleidoscope {
+namespace driver {
+namespace i2c {
+
+// Bus usage statistics for one device on an I2C bus, such as one half of a
+// split keyboard. The driver talking to the device records every transaction
+// with it, and calls `startCycle()` once per scan cycle; times are in
+// microseconds.
+struct Telemetry {
+  uint32_t transactions = 0;
+  // Bytes written to and read from the device
+  uint32_t bytes = 0;
+  // Transactions that failed, because the device didn't acknowledge its
+  // address or the data, or returned less data than requested
+  uint32_t nacks = 0;
+  uint32_t bus_time = 0;
+  uint32_t cycles   = 0;
+  // Time spent on the bus during the current cycle, and the most spent during
+  // any cycle since the last reset. These stop at 65535 rather than wrapping
+  // around, so a stalled bus still shows up as the worst cycle.
+  uint16_t cycle_bus_time     = 0;
+  uint16_t max_cycle_bus_time = 0;
+
+  void record(uint8_t length, uint32_t time, bool ok) {
+    ++transactions;
+    bytes += length;
+    bus_time += time;
+    if (time > UINT16_MAX - cycle_bus_time) {
+      cycle_bus_time = UINT16_MAX;
+    } else {
+      cycle_bus_time += time;
+    }
+    if (!ok)
+      ++nacks;
+  }
+
+  void startCycle() {
+    if (cycle_bus_time > max_cycle_bus_time)
+      max_cycle_bus_time = cycle_bus_time;
+    cycle_bus_time = 0;
+    ++cycles;
+  }
+
+  void reset() {
+    *this = Telemetry();
+  }
+};
+
+}  // namespace i2c
+}  // namespace driver
+}  // namespace kaleidoscope
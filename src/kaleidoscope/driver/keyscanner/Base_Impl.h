@@ -31,6 +31,7 @@
 #include "kaleidoscope/driver/keyscanner/Base.h"  // for Base
 #include "kaleidoscope/key_defs.h"                // for Key
 #include "kaleidoscope/keyswitch_state.h"         // for keyToggledOff, keyToggledOn
+#include "kaleidoscope_internal/latency_trace.h"  // for stamp
 
 namespace kaleidoscope {
 namespace driver {
@@ -48,6 +49,7 @@ void Base<kaleidoscope::Device::Props::KeyScannerProps>::handleKeyswitchEvent(
   // it's critical that we do the test for keyswitches toggling on or off first.
   if (keyToggledOn(key_state) || keyToggledOff(key_state)) {
     auto event = KeyEvent::next(key_addr, key_state);
+    kaleidoscope_internal::latency_trace::stamp(event);
     kaleidoscope::Runtime.handleKeyswitchEvent(event);
   }
 }
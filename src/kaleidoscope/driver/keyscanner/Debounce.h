@@ -0,0 +1,137 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+namespace debounce {
+
+// Debouncing policies for matrix key scanners. A scanner's props select one
+// with a typedef, for example:
+//
+//   typedef kaleidoscope::driver::keyscanner::debounce::EagerPress<4> Debouncer;
+//
+// and the scanner keeps a `Debouncer::Row<RowState>` for each row of its
+// matrix, and feeds it every scan of the row.
+//
+// All of them are the same vertical counter: each key has a counter of how
+// many scans in a row its raw state differed from its debounced one, kept as
+// one `RowState` per counter bit, so a whole row is debounced with a handful of
+// bitwise operations, and no branches. A key toggles when its counter reaches
+// the threshold for the direction it changes in, and a scan in which it reads
+// as its debounced state again resets its counter.
+//
+// `Asymmetric<press_samples, release_samples>` is the general case, with
+// separate thresholds (in scans) for presses and releases.
+template<uint8_t _press_samples, uint8_t _release_samples>
+struct Asymmetric {
+  static constexpr uint8_t press_samples   = _press_samples;
+  static constexpr uint8_t release_samples = _release_samples;
+
+  static_assert(press_samples >= 1 && press_samples <= 16 &&
+                  release_samples >= 1 && release_samples <= 16,
+                "Debounce thresholds must be between 1 and 16 scans");
+
+  template<typename RowState>
+  class Row {
+   public:
+    // Takes a scan of the row (a set bit for each key that reads as pressed),
+    // and returns the keys whose debounced state toggled.
+    RowState debounce(RowState sample) {
+      RowState delta = sample ^ state_;
+
+      // The keys whose counter reached the threshold for their direction
+      RowState pressing  = delta & sample;
+      RowState releasing = delta & ~sample;
+      RowState changes   = (pressing & counterEquals(press_samples - 1)) |
+                         (releasing & counterEquals(release_samples - 1));
+
+      // Increment the counters of changed keys, and clear the others, and the
+      // ones that toggled.
+      RowState carry = delta;
+      RowState keep  = delta & ~changes;
+      for (uint8_t i = 0; i < counter_bits; i++) {
+        RowState bit = counter_[i];
+        counter_[i]  = (bit ^ carry) & keep;
+        carry &= bit;
+      }
+
+      state_ ^= changes;
+      return changes;
+    }
+
+    // The debounced state of the row
+    RowState state() const {
+      return state_;
+    }
+
+    // Reverts the toggle of `keys`, for a scanner that couldn't deliver their
+    // events. They toggle again after another full threshold.
+    void revert(RowState keys) {
+      state_ ^= keys;
+    }
+
+   private:
+    static constexpr uint8_t max_samples = press_samples > release_samples
+                                             ? press_samples
+                                             : release_samples;
+
+    static constexpr uint8_t bitsFor(uint8_t value) {
+      return value <= 1 ? 1 : 1 + bitsFor(value >> 1);
+    }
+    static constexpr uint8_t counter_bits = bitsFor(max_samples - 1);
+
+    // The keys whose counter is `value`. The comparison of each bit is
+    // resolved at compile time.
+    RowState counterEquals(uint8_t value) const {
+      RowState result = ~RowState(0);
+      for (uint8_t i = 0; i < counter_bits; i++)
+        result &= ((value >> i) & 1) ? counter_[i] : RowState(~counter_[i]);
+      return result;
+    }
+
+    RowState counter_[counter_bits] = {};
+    RowState state_                 = 0;
+  };
+};
+
+// Waits for the same number of stable scans on presses and releases. This is
+// the classic debouncer, which adds `samples` scans of latency to every event.
+template<uint8_t _samples>
+struct Defer : Asymmetric<_samples, _samples> {};
+
+// Reports a press on the first scan that sees it, and waits for
+// `release_samples` stable scans before reporting a release, which covers the
+// bouncing after both. Presses have no latency, but a glitch on the line (as
+// opposed to a bounce) reads as a tap.
+template<uint8_t _release_samples>
+struct EagerPress : Asymmetric<1, _release_samples> {};
+
+}  // namespace debounce
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -24,11 +24,16 @@
 
 #ifdef ARDUINO_ARCH_NRF52
 #include "kaleidoscope/driver/keyscanner/Base.h"
+#include "kaleidoscope/driver/keyscanner/Debounce.h"
+#include "kaleidoscope/driver/keyscanner/ScanTiming.h"
 #include "kaleidoscope/keyswitch_state.h"
+#include "kaleidoscope_internal/latency_trace.h"
 #include "FreeRTOS.h"
 #include "queue.h"
+#include "task.h"
 #include "Arduino.h"
 #include "nrf_timer.h"
+#include "nrf_gpio.h"
 
 namespace kaleidoscope {
 namespace driver {
@@ -42,6 +47,21 @@ struct NRF52KeyScannerProps : kaleidoscope::driver::keyscanner::BaseProps {
   /// @brief Type used to store the state of a matrix row
   typedef uint16_t RowState;
 
+  /// @brief Debouncing policy, see `Debounce.h` for the available ones
+  typedef kaleidoscope::driver::keyscanner::debounce::Defer<3> Debouncer;
+
+  /// @brief Time for the columns to settle after a row is driven low, in
+  /// microseconds
+  static constexpr uint8_t row_settle_micros = 10;
+
+  /// @brief Read all of the columns with one read of each GPIO port's input
+  /// register, instead of a `digitalRead()` per column
+  static constexpr bool port_wide_reads = true;
+
+  /// @brief Count the CPU cycles each scan takes (see `scanTiming()`). This
+  /// keeps the debug unit's cycle counter running.
+  static constexpr bool time_scans = false;
+
   /*
    * The following two arrays must be shadowed by the descendant keyscanner
    * description class to define the actual matrix pins.
@@ -73,15 +93,20 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
  private:
   typedef NRF52KeyScanner<_Props> ThisType;
 
-  // Packed event structure to minimize queue memory usage
+  // The keys of a row that toggled in one scan
   struct Event {
-    uint8_t row : 4;
-    uint8_t col : 4;
-    bool pressed : 1;
+    uint8_t row;
+    typename _Props::RowState changes;
+    // The new state of the keys in `changes`
+    typename _Props::RowState state;
+    // When debouncing completed, if latency tracing is enabled
+    uint32_t timestamp;
   };
 
   // Static queue storage and control structures
-  static constexpr size_t EVENT_QUEUE_SIZE = 64;
+  // Each event holds all of the changes to a row in one scan, so this is
+  // plenty, even for someone mashing the keyboard.
+  static constexpr size_t EVENT_QUEUE_SIZE = 32;
   static StaticQueue_t event_queue_buffer_;
   static uint8_t event_queue_storage_[EVENT_QUEUE_SIZE * sizeof(Event)];
   static QueueHandle_t event_queue_handle_;
@@ -109,7 +134,8 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
 
   /// @brief Update the matrix state from a queued event (internal use only)
   void applyQueuedEvent(const Event &event) {
-    setMatrixState(event.row, event.col, event.pressed);
+    matrix_state_[event.row].current =
+      (matrix_state_[event.row].current & ~event.changes) | (event.state & event.changes);
   }
 
   bool getMatrixState(uint8_t row, uint8_t col) const {
@@ -130,7 +156,19 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
   /// This is used by both matrix scanning and external code (like encoders)
   /// @return true if event was queued, false if queue was full
   bool queueKeyEvent(uint8_t row, uint8_t col, bool state) {
-    Event event                           = {row, col, state};
+    typename _Props::RowState key = 1UL << col;
+    return queueRowEvent(row, key, state ? key : 0);
+  }
+
+  /// @brief Queue the toggling of the keys in `changes` of a row, to the
+  /// states in `state`, as one event
+  /// @return true if event was queued, false if queue was full
+  bool queueRowEvent(uint8_t row, typename _Props::RowState changes, typename _Props::RowState state) {
+    // Reading the clock isn't free in the timer interrupt, so only do it when
+    // the sketch was built with latency tracing.
+    uint32_t timestamp = kaleidoscope_internal::latency_trace::enabled() ? micros() : 0;
+
+    Event event                           = {row, changes, state, timestamp};
     BaseType_t higher_priority_task_woken = pdFALSE;
 
     // Use ISR version since this might be called from interrupt context
@@ -139,12 +177,48 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
       &event,
       &higher_priority_task_woken);
 
+    // Wake the main task, if it's waiting for input
+    TaskHandle_t task = waiting_task_;
+    if (task != nullptr)
+      vTaskNotifyGiveFromISR(task, &higher_priority_task_woken);
+
     // Handle potential task switch if needed
     portYIELD_FROM_ISR(higher_priority_task_woken);
 
     return success == pdTRUE;
   }
 
+  /// @brief Start waiting for input
+  /// Must be called before setting up whatever else should end the wait (such
+  /// as GPIO sensing), so that a wake-up between the two isn't lost.
+  void prepareToWait() {
+    waiting_task_ = xTaskGetCurrentTaskHandle();
+  }
+
+  /// @brief Block the calling task until a key event is queued, `wakeFromISR()`
+  /// is called, or `timeout_ms` milliseconds have passed
+  /// While blocked, the FreeRTOS idle task can put the MCU to sleep.
+  /// @return true if woken before the timeout
+  bool waitForActivity(uint32_t timeout_ms) {
+    bool woken = hasQueuedEvents() ||
+                 ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0;
+    waiting_task_ = nullptr;
+    // Drop a notification that raced with the timeout, so it won't end the
+    // next wait early.
+    ulTaskNotifyTake(pdTRUE, 0);
+    return woken;
+  }
+
+  /// @brief End a wait started with `prepareToWait()` from an interrupt handler
+  static void wakeFromISR() {
+    TaskHandle_t task = waiting_task_;
+    if (task == nullptr)
+      return;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+  }
+
 
   /// @brief Suspend the timer interrupt used for matrix scanning
   void suspendTimer() {
@@ -166,10 +240,51 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     NRF_TIMER1->TASKS_START = 1;
   }
 
+  /// @brief A copy of the timing of the scans in the timer interrupt handler,
+  /// if `time_scans` is enabled
+  ///
+  /// The copy is taken with interrupts disabled, so a scan can't update the
+  /// 64-bit cycle count, or the other counters, halfway through it.
+  static ScanTiming scanTiming() {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ScanTiming timing = scan_timing_;
+    __set_PRIMASK(primask);
+    return timing;
+  }
+
+  /// @brief Restart the timing of the scans
+  static void resetScanTiming() {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    scan_timing_.reset();
+    __set_PRIMASK(primask);
+  }
+
   void setup() {
     // Store this instance as the active scanner
     active_scanner_ = this;
 
+    // Look up the GPIOs of the pins once, instead of in every scan, and see
+    // if the columns are a run of consecutive bits of one port, which can be
+    // read with a shift and a mask.
+    for (uint8_t i = 0; i < _Props::matrix_rows; i++) {
+      row_gpios_[i] = g_ADigitalPinMap[_Props::matrix_row_pins[i]];
+    }
+    for (uint8_t i = 0; i < _Props::matrix_columns; i++) {
+      col_gpios_[i] = g_ADigitalPinMap[_Props::matrix_col_pins[i]];
+    }
+    cols_are_consecutive_ = true;
+    for (uint8_t i = 1; i < _Props::matrix_columns; i++) {
+      if (col_gpios_[i] != col_gpios_[0] + i || (col_gpios_[i] >> 5) != (col_gpios_[0] >> 5))
+        cols_are_consecutive_ = false;
+    }
+
+    if (_Props::time_scans) {
+      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
     // Create the event queue
     event_queue_handle_ = xQueueCreateStatic(
       EVENT_QUEUE_SIZE,
@@ -220,11 +335,18 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
       // Update matrix state with latest event
       applyQueuedEvent(event);
 
+      // The event was detected in the timer interrupt, possibly well before
+      // this scan, so that's the time latency tracing should start from for
+      // every key that toggled in it.
+      kaleidoscope_internal::latency_trace::detectedAt(event.timestamp);
+
       // It's possible to have multiple events for the same key in the queue.
       // so we need to act on the matrix scan for each and every event.
       // Process any state changes
       actOnMatrixScan();
 
+      kaleidoscope_internal::latency_trace::clearDetectionTime();
+
       // Update previous state for next scan
       updateMatrixScanKeyState();
     }
@@ -280,29 +402,72 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
 
   // Timer handler interface implementation
   void handleTimer() override {
+    uint32_t start = _Props::time_scans ? DWT->CYCCNT : 0;
+
     for (uint8_t row = 0; row < _Props::matrix_rows; row++) {
-      digitalWrite(_Props::matrix_row_pins[row], LOW);
-      delayMicroseconds(10);
-      for (uint8_t col = 0; col < _Props::matrix_columns; col++) {
-        bool current_state = !digitalRead(_Props::matrix_col_pins[col]);
-
-        if (current_state != getMatrixState(row, col)) {
-          if (++debounce_counters_[row][col] >= DEBOUNCE_THRESHOLD) {
-            if (!queueKeyEvent(row, col, current_state)) {
-              // Queue is full, we'll try again next scan
-              continue;
-            }
-            debounce_counters_[row][col] = 0;
-          }
-        }
+      typename _Props::RowState hot_pins = _Props::port_wide_reads ? readRow(row) : readRowPinByPin(row);
+
+      typename _Props::RowState changes = debouncers_[row].debounce(hot_pins);
+      if (changes && !queueRowEvent(row, changes, hot_pins)) {
+        // Queue is full, we'll try again after another debounce period
+        debouncers_[row].revert(changes);
       }
-      digitalWrite(_Props::matrix_row_pins[row], HIGH);
     }
+
+    if (_Props::time_scans)
+      scan_timing_.record(DWT->CYCCNT - start);
   }
 
  private:
-  static constexpr uint8_t DEBOUNCE_THRESHOLD = 3;
-  static uint8_t debounce_counters_[_Props::matrix_rows][_Props::matrix_columns];
+  typedef typename _Props::Debouncer::template Row<typename _Props::RowState> Debouncer;
+
+  static uint8_t row_gpios_[_Props::matrix_rows];
+  static uint8_t col_gpios_[_Props::matrix_columns];
+  static bool cols_are_consecutive_;
+  static ScanTiming scan_timing_;
+
+  // Reads the input registers of all GPIO ports at once, and picks the column
+  // bits out of them.
+  static typename _Props::RowState readRow(uint8_t row) {
+    nrf_gpio_pin_clear(row_gpios_[row]);
+    delayMicroseconds(_Props::row_settle_micros);
+    // The columns read low when their key is pressed.
+    uint32_t ports[] = {
+      ~NRF_P0->IN,
+#ifdef NRF_P1
+      ~NRF_P1->IN,
+#endif
+    };
+    nrf_gpio_pin_set(row_gpios_[row]);
+
+    if (cols_are_consecutive_) {
+      return (ports[col_gpios_[0] >> 5] >> (col_gpios_[0] & 31)) &
+             ((1UL << _Props::matrix_columns) - 1);
+    }
+    typename _Props::RowState hot_pins = 0;
+    for (uint8_t col = 0; col < _Props::matrix_columns; col++) {
+      hot_pins |= ((ports[col_gpios_[col] >> 5] >> (col_gpios_[col] & 31)) & 1) << col;
+    }
+    return hot_pins;
+  }
+
+  // Reads the columns one `digitalRead()` at a time, as this scanner used
+  // to, for comparison.
+  static typename _Props::RowState readRowPinByPin(uint8_t row) {
+    digitalWrite(_Props::matrix_row_pins[row], LOW);
+    delayMicroseconds(_Props::row_settle_micros);
+    typename _Props::RowState hot_pins = 0;
+    for (uint8_t col = 0; col < _Props::matrix_columns; col++) {
+      if (!digitalRead(_Props::matrix_col_pins[col]))
+        hot_pins |= (1UL << col);
+    }
+    digitalWrite(_Props::matrix_row_pins[row], HIGH);
+    return hot_pins;
+  }
+
+  // The task blocked in `waitForActivity()`, if any
+  static volatile TaskHandle_t waiting_task_;
+  static Debouncer debouncers_[_Props::matrix_rows];
 
   static void gpio_handler(uint32_t pin) {
     // Wake-on-key handler
@@ -311,7 +476,19 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
 
 // Static member initialization
 template<typename _Props>
-uint8_t NRF52KeyScanner<_Props>::debounce_counters_[_Props::matrix_rows][_Props::matrix_columns] = {0};
+typename NRF52KeyScanner<_Props>::Debouncer NRF52KeyScanner<_Props>::debouncers_[_Props::matrix_rows];
+
+template<typename _Props>
+uint8_t NRF52KeyScanner<_Props>::row_gpios_[_Props::matrix_rows];
+
+template<typename _Props>
+uint8_t NRF52KeyScanner<_Props>::col_gpios_[_Props::matrix_columns];
+
+template<typename _Props>
+bool NRF52KeyScanner<_Props>::cols_are_consecutive_ = false;
+
+template<typename _Props>
+ScanTiming NRF52KeyScanner<_Props>::scan_timing_;
 
 template<typename _Props>
 StaticQueue_t NRF52KeyScanner<_Props>::event_queue_buffer_;
@@ -328,6 +505,9 @@ typename NRF52KeyScanner<_Props>::row_state_t NRF52KeyScanner<_Props>::matrix_st
 template<typename _Props>
 uint32_t NRF52KeyScanner<_Props>::next_scan_at_ = 0;
 
+template<typename _Props>
+volatile TaskHandle_t NRF52KeyScanner<_Props>::waiting_task_ = nullptr;
+
 }  // namespace keyscanner
 }  // namespace driver
 }  // namespace kaleidoscope
@@ -0,0 +1,59 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t, uint64_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+// Timing of the matrix scans of a key scanner that scans in an interrupt
+// handler, in CPU cycles. The scanner records the duration of every scan. The
+// interrupt handler can update it at any time, so the main loop only reads or
+// resets it through the scanner, which does so with interrupts disabled.
+struct ScanTiming {
+  uint32_t scans      = 0;
+  uint64_t cycles     = 0;
+  uint32_t max_cycles = 0;
+
+  void record(uint32_t scan_cycles) {
+    ++scans;
+    cycles += scan_cycles;
+    if (scan_cycles > max_cycles)
+      max_cycles = scan_cycles;
+  }
+
+  uint32_t meanCycles() const {
+    return scans == 0 ? 0 : cycles / scans;
+  }
+
+  void reset() {
+    *this = ScanTiming();
+  }
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
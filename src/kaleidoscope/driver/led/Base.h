@@ -52,6 +52,13 @@ class Base {
 
   void setup() {}
   void syncLeds(void) {}
+  /**
+   * @returns true if the last `syncLeds()` didn't deliver everything (say,
+   * because a write to the LEDs failed), and it needs to be called again
+   */
+  bool isSyncPending() const {
+    return false;
+  }
   void setCrgbAt(uint8_t i, cRGB color) {}
   cRGB getCrgbAt(uint8_t i) {
     cRGB c = {
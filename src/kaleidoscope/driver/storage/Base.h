@@ -72,6 +72,14 @@ class Base {
     }
     commit();
   }
+
+  // Called between processing cycles, for drivers that do their flash
+  // maintenance in the background.
+  void betweenCycles() {}
+  // Returns true while `betweenCycles()` has background work left to do.
+  bool hasPendingWork() const {
+    return false;
+  }
 };
 
 }  // namespace storage
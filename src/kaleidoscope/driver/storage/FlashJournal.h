@@ -0,0 +1,482 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t, int32_t
+#include <string.h>  // for memcpy, memcmp, memset
+
+#include "kaleidoscope/driver/storage/Base.h"  // for Base, BaseProps
+#include "kaleidoscope/util/crc16.h"           // for _crc16_update
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+// A log-structured storage driver for flash.
+//
+// Like `NRF52Flash`, it keeps an image of the whole storage in RAM, which
+// `get()`, `read()` and `isSliceUninitialized()` use. Instead of rewriting the
+// flash pages that changed on `commit()`, it appends a record (offset, length,
+// bytes, CRC) of each changed chunk to a journal, so a small settings update
+// costs a few dozen bytes of programming, and no erase at all.
+//
+// The flash is split into two banks. The active one holds a header, a snapshot
+// of the image, and the journal after it. When the journal is more than
+// `compaction_threshold` percent full, the image is compacted into the other
+// bank in the background, one flash page at a time, from `betweenCycles()`:
+// its pages are erased (unless they already are), the image is copied into it,
+// the chunks that changed in the meantime are journaled there, and finally its
+// header makes it the active bank. Only if the journal fills up before that is
+// the rest of the compaction done by `commit()`. Until the new header is
+// written, the old bank stays valid, and a torn record only loses itself.
+//
+// `_StorageProps::Flash` is the flash it writes to, which must provide:
+//
+//   static constexpr uint16_t page_size;    // bytes per erasable page
+//   static constexpr uint16_t page_count;   // at least 2 * bank_pages
+//   static constexpr uint8_t program_unit;  // alignment of programming
+//   void setup();
+//   void read(uint32_t address, void *data, uint16_t size);
+//   void program(uint32_t address, const void *data, uint16_t size);
+//   void erasePage(uint16_t page);
+//   bool isPageErased(uint16_t page);
+//
+// `program()` is only ever called on erased bytes, with an address and size
+// aligned to `program_unit`.
+struct FlashJournalProps : kaleidoscope::driver::storage::BaseProps {
+  static constexpr uint16_t length = 16384;
+  // The number of flash pages in each of the two banks
+  static constexpr uint16_t bank_pages = 0;
+  // Changes are tracked in chunks of this many bytes
+  static constexpr uint8_t chunk_size = 16;
+  // Compaction starts when the journal is this full (in percent)
+  static constexpr uint8_t compaction_threshold = 50;
+};
+
+template<typename _StorageProps>
+class FlashJournal : public kaleidoscope::driver::storage::Base<_StorageProps> {
+ public:
+  typedef typename _StorageProps::Flash Flash;
+
+  template<typename T>
+  T &get(uint16_t offset, T &t) {
+    if (!checkBounds(offset, sizeof(T)))
+      return t;
+    memcpy(&t, image_ + offset, sizeof(T));
+    return t;
+  }
+
+  template<typename T>
+  const T &put(uint16_t offset, T &t) {
+    if (!checkBounds(offset, sizeof(T)))
+      return t;
+    if (memcmp(image_ + offset, &t, sizeof(T)) != 0) {
+      memcpy(image_ + offset, &t, sizeof(T));
+      markDirty(offset, sizeof(T));
+    }
+    return t;
+  }
+
+  uint8_t read(int idx) {
+    if (!checkBounds(idx, 1))
+      return 0;
+    return image_[idx];
+  }
+
+  void write(int idx, uint8_t val) {
+    if (!checkBounds(idx, 1))
+      return;
+    if (image_[idx] != val) {
+      image_[idx] = val;
+      markDirty(idx, 1);
+    }
+  }
+
+  void update(int idx, uint8_t val) {
+    write(idx, val);
+  }
+
+  bool isSliceUninitialized(uint16_t offset, uint16_t size) {
+    if (!checkBounds(offset, size))
+      return true;
+    for (uint16_t i = 0; i < size; i++) {
+      if (image_[offset + i] != _StorageProps::uninitialized_byte)
+        return false;
+    }
+    return true;
+  }
+
+  const uint16_t length() {
+    return _StorageProps::length;
+  }
+
+  void setup() {
+    flash_.setup();
+    load();
+  }
+
+  void commit() {
+    if (!isDirty())
+      return;
+
+    if (active_bank_ == no_bank || needs_compaction_)
+      return compactNow();
+
+    for (uint16_t chunk = 0; chunk < chunk_count; chunk++) {
+      if (!bitRead(dirty_, chunk))
+        continue;
+      // Journal the run of dirty chunks starting here, in records of up to
+      // `record_data_size` bytes.
+      uint16_t end = chunk;
+      while (end < chunk_count && bitRead(dirty_, end))
+        end++;
+      for (uint16_t offset = chunk * _StorageProps::chunk_size;
+           offset < end * _StorageProps::chunk_size;
+           offset += record_data_size) {
+        uint16_t size = smaller(uint16_t(record_data_size),
+                                uint16_t(end * _StorageProps::chunk_size - offset));
+        if (!appendRecord(active_bank_, journal_end_, offset, size))
+          return compactNow();
+      }
+      chunk = end;
+    }
+    memset(dirty_, 0, sizeof(dirty_));
+
+    if (compaction_ == Compaction::Idle &&
+        journal_end_ - journal_start > journal_size * _StorageProps::compaction_threshold / 100)
+      startCompaction();
+  }
+
+  void erase() {
+    memset(image_, _StorageProps::uninitialized_byte, sizeof(image_));
+    memset(dirty_, 0xff, sizeof(dirty_));
+    // The snapshot skips erased chunks, so this costs little more than erasing
+    // the other bank.
+    startCompaction();
+    compactNow();
+  }
+
+  // Does one step of a compaction in progress: erasing or copying one page.
+  void betweenCycles() {
+    if (compaction_ != Compaction::Idle)
+      compactionStep();
+  }
+
+  // Returns the number of bytes of the journal used, and its size.
+  uint32_t journalUsed() const {
+    return active_bank_ == no_bank ? 0 : journal_end_ - journal_start;
+  }
+  static constexpr uint32_t journalSize() {
+    return journal_size;
+  }
+  bool isCompacting() const {
+    return compaction_ != Compaction::Idle;
+  }
+  bool hasPendingWork() const {
+    return isCompacting();
+  }
+
+  Flash &flash() {
+    return flash_;
+  }
+
+ private:
+  static constexpr uint32_t bank_size = uint32_t(_StorageProps::bank_pages) * Flash::page_size;
+
+  static constexpr uint32_t align(uint32_t size) {
+    return (size + Flash::program_unit - 1) / Flash::program_unit * Flash::program_unit;
+  }
+
+  struct Header {
+    uint32_t magic;
+    uint32_t generation;
+    uint16_t length;
+    uint16_t crc;
+    uint32_t reserved;
+  };
+  struct RecordHeader {
+    uint16_t offset;
+    uint16_t size;
+  };
+
+  static constexpr uint32_t magic           = 0x4c4e524a;  // "JRNL"
+  static constexpr uint8_t header_size      = sizeof(Header);
+  static constexpr uint8_t record_data_size = 64;
+  static constexpr uint32_t journal_start   = align(header_size + _StorageProps::length);
+  static constexpr uint32_t journal_size    = bank_size - journal_start;
+  static constexpr uint16_t chunk_count     = _StorageProps::length / _StorageProps::chunk_size;
+  static constexpr uint8_t no_bank          = 0xff;
+
+  static_assert(Flash::page_count >= 2 * _StorageProps::bank_pages,
+                "The flash is too small for two banks");
+  static_assert(bank_size >= journal_start + 4 * align(sizeof(RecordHeader) + record_data_size + 2),
+                "The banks have no room for a journal");
+  static_assert(_StorageProps::length % _StorageProps::chunk_size == 0 &&
+                  _StorageProps::chunk_size % Flash::program_unit == 0 &&
+                  header_size % Flash::program_unit == 0,
+                "The chunk size must divide the length, and be aligned for programming");
+
+  enum class Compaction : uint8_t {
+    Idle,
+    Erasing,
+    Copying,
+    Finishing,
+  };
+
+  Flash flash_;
+  uint8_t image_[_StorageProps::length];  // NOLINT(runtime/arrays)
+  // Chunks changed since the last commit, and since compaction started
+  uint8_t dirty_[(chunk_count + 7) / 8]   = {};
+  uint8_t pending_[(chunk_count + 7) / 8] = {};
+
+  uint8_t active_bank_     = no_bank;
+  bool needs_compaction_   = false;
+  uint32_t generation_     = 0;
+  uint32_t journal_end_    = journal_start;
+  Compaction compaction_   = Compaction::Idle;
+  uint16_t compaction_step_ = 0;
+
+  static bool bitRead(const uint8_t *bits, uint16_t index) {
+    return bits[index / 8] & (1 << (index % 8));
+  }
+  static void bitSet(uint8_t *bits, uint16_t index) {
+    bits[index / 8] |= (1 << (index % 8));
+  }
+
+  static bool checkBounds(uint16_t offset, uint16_t size) {
+    return (offset + size <= _StorageProps::length);
+  }
+
+  static uint16_t smaller(uint16_t a, uint16_t b) {
+    return a < b ? a : b;
+  }
+
+  static uint16_t crc(uint16_t crc, const void *data, uint16_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (uint16_t i = 0; i < size; i++)
+      crc = _crc16_update(crc, bytes[i]);
+    return crc;
+  }
+
+  static uint32_t bankAddress(uint8_t bank) {
+    return bank * bank_size;
+  }
+  uint8_t spareBank() const {
+    return active_bank_ == 0 ? 1 : 0;
+  }
+
+  bool isDirty() const {
+    for (uint8_t b : dirty_) {
+      if (b != 0)
+        return true;
+    }
+    return false;
+  }
+
+  void markDirty(uint16_t offset, uint16_t size) {
+    for (uint16_t chunk = offset / _StorageProps::chunk_size;
+         chunk <= (offset + size - 1) / _StorageProps::chunk_size;
+         chunk++) {
+      bitSet(dirty_, chunk);
+      bitSet(pending_, chunk);
+    }
+  }
+
+  bool readHeader(uint8_t bank, Header &header) {
+    flash_.read(bankAddress(bank), &header, sizeof(header));
+    return header.magic == magic &&
+           header.length == _StorageProps::length &&
+           header.crc == crc(0xffff, &header, 10);
+  }
+
+  void load() {
+    memset(image_, _StorageProps::uninitialized_byte, sizeof(image_));
+    memset(dirty_, 0, sizeof(dirty_));
+    active_bank_ = no_bank;
+
+    Header headers[2];
+    bool valid[2] = {readHeader(0, headers[0]), readHeader(1, headers[1])};
+    if (valid[0] && valid[1]) {
+      // Generations wrap around, eventually.
+      active_bank_ = int32_t(headers[1].generation - headers[0].generation) > 0 ? 1 : 0;
+    } else if (valid[0] || valid[1]) {
+      active_bank_ = valid[0] ? 0 : 1;
+    } else {
+      // Nothing was ever committed: the first commit will set up a bank.
+      return;
+    }
+    generation_ = headers[active_bank_].generation;
+
+    flash_.read(bankAddress(active_bank_) + header_size, image_, _StorageProps::length);
+    replayJournal();
+  }
+
+  void replayJournal() {
+    uint32_t base = bankAddress(active_bank_);
+    journal_end_  = journal_start;
+
+    while (journal_end_ + sizeof(RecordHeader) <= bank_size) {
+      RecordHeader record;
+      flash_.read(base + journal_end_, &record, sizeof(record));
+      if (record.offset == 0xffff && record.size == 0xffff)
+        return;
+
+      uint8_t data[record_data_size];  // NOLINT(runtime/arrays)
+      uint16_t record_crc;
+      uint32_t record_end = journal_end_ + align(sizeof(record) + record.size + sizeof(record_crc));
+      if (record.size > record_data_size ||
+          !checkBounds(record.offset, record.size) ||
+          record_end > bank_size) {
+        break;
+      }
+      flash_.read(base + journal_end_ + sizeof(record), data, record.size);
+      flash_.read(base + journal_end_ + sizeof(record) + record.size, &record_crc, sizeof(record_crc));
+      if (record_crc != crc(crc(0xffff, &record, sizeof(record)), data, record.size))
+        break;
+
+      memcpy(image_ + record.offset, data, record.size);
+      journal_end_ = record_end;
+    }
+
+    // A torn or corrupted record: nothing can be appended after it, so the
+    // next commit compacts the image into the other bank.
+    needs_compaction_ = true;
+  }
+
+  bool appendRecord(uint8_t bank, uint32_t &journal_end, uint16_t offset, uint16_t size) {
+    uint8_t buffer[align(sizeof(RecordHeader) + record_data_size + 2)];  // NOLINT(runtime/arrays)
+    uint16_t record_size = align(sizeof(RecordHeader) + size + 2);
+    if (journal_end + record_size > bank_size)
+      return false;
+
+    memset(buffer, 0xff, sizeof(buffer));
+    RecordHeader record = {offset, size};
+    memcpy(buffer, &record, sizeof(record));
+    memcpy(buffer + sizeof(record), image_ + offset, size);
+    uint16_t record_crc = crc(0xffff, buffer, sizeof(record) + size);
+    memcpy(buffer + sizeof(record) + size, &record_crc, sizeof(record_crc));
+
+    flash_.program(bankAddress(bank) + journal_end, buffer, record_size);
+    journal_end += record_size;
+    return true;
+  }
+
+  void startCompaction() {
+    compaction_      = Compaction::Erasing;
+    compaction_step_ = 0;
+    memset(pending_, 0, sizeof(pending_));
+  }
+
+  // Finishes the compaction in progress (or does a whole one), and clears the
+  // dirty chunks, which are all in the new bank then.
+  void compactNow() {
+    if (compaction_ == Compaction::Idle)
+      startCompaction();
+    while (compaction_ != Compaction::Idle)
+      compactionStep();
+    memset(dirty_, 0, sizeof(dirty_));
+  }
+
+  void compactionStep() {
+    uint8_t bank = spareBank();
+
+    switch (compaction_) {
+    case Compaction::Erasing: {
+      uint16_t page = bank * _StorageProps::bank_pages + compaction_step_;
+      if (!flash_.isPageErased(page))
+        flash_.erasePage(page);
+      if (++compaction_step_ == _StorageProps::bank_pages) {
+        compaction_      = Compaction::Copying;
+        compaction_step_ = 0;
+      }
+      break;
+    }
+    case Compaction::Copying: {
+      // Copy one page worth of the image, skipping erased chunks.
+      uint16_t start = compaction_step_ * Flash::page_size;
+      uint16_t end   = smaller(start + Flash::page_size, _StorageProps::length);
+      for (uint16_t offset = start; offset < end; offset += _StorageProps::chunk_size) {
+        if (isChunkErased(offset))
+          continue;
+        uint16_t run_end = offset + _StorageProps::chunk_size;
+        while (run_end < end && !isChunkErased(run_end))
+          run_end += _StorageProps::chunk_size;
+        flash_.program(bankAddress(bank) + header_size + offset, image_ + offset, run_end - offset);
+        offset = run_end;
+      }
+      if (end == _StorageProps::length) {
+        compaction_ = Compaction::Finishing;
+      } else {
+        compaction_step_++;
+      }
+      break;
+    }
+    case Compaction::Finishing:
+      finishCompaction(bank);
+      break;
+    case Compaction::Idle:
+      break;
+    }
+  }
+
+  bool isChunkErased(uint16_t offset) const {
+    for (uint8_t i = 0; i < _StorageProps::chunk_size; i++) {
+      if (image_[offset + i] != 0xff)
+        return false;
+    }
+    return true;
+  }
+
+  void finishCompaction(uint8_t bank) {
+    // Journal the chunks that changed since they may have been copied.
+    uint32_t journal_end = journal_start;
+    for (uint16_t chunk = 0; chunk < chunk_count; chunk++) {
+      if (bitRead(pending_, chunk) &&
+          !appendRecord(bank, journal_end, chunk * _StorageProps::chunk_size, _StorageProps::chunk_size)) {
+        // So much changed that it doesn't fit: start over, with a fresh copy.
+        startCompaction();
+        return;
+      }
+    }
+
+    // Writing the header makes the new bank the active one.
+    Header header;
+    memset(&header, 0xff, sizeof(header));
+    header.magic      = magic;
+    header.generation = generation_ + 1;
+    header.length     = _StorageProps::length;
+    header.crc        = crc(0xffff, &header, 10);
+    flash_.program(bankAddress(bank), &header, sizeof(header));
+
+    active_bank_      = bank;
+    generation_       = header.generation;
+    journal_end_      = journal_end;
+    needs_compaction_ = false;
+    compaction_       = Compaction::Idle;
+  }
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
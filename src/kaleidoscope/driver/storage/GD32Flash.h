@@ -58,6 +58,10 @@ class GD32Flash : public EEPROMClass<_StorageProps::length> {
     }
     this->commit();
   }
+  void betweenCycles() {}
+  bool hasPendingWork() const {
+    return false;
+  }
 };
 
 }  // namespace storage
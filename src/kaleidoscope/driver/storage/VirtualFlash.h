@@ -0,0 +1,137 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+#include <string.h>  // for memcpy, memset
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+// A simulated NOR flash for `FlashJournal`, for testing it, and comparing
+// storage strategies in the virtual build. Like real flash, programming can
+// only clear bits (attempts to set them are counted in `programViolations()`),
+// and only erasing a whole page sets them again. Each operation adds to
+// `busyMicros()` the time an nRF52840 would spend on it.
+template<uint16_t _page_size, uint16_t _page_count>
+class VirtualFlash {
+ public:
+  static constexpr uint16_t page_size   = _page_size;
+  static constexpr uint16_t page_count  = _page_count;
+  static constexpr uint8_t program_unit = 4;
+
+  static constexpr uint32_t page_erase_micros = 85000;
+  static constexpr uint32_t word_write_micros = 41;
+
+  VirtualFlash() {
+    memset(data_, 0xff, sizeof(data_));
+    memset(erase_counts_, 0, sizeof(erase_counts_));
+  }
+
+  void setup() {}
+
+  void read(uint32_t address, void *data, uint16_t size) {
+    memcpy(data, data_ + address, size);
+  }
+
+  void program(uint32_t address, const void *data, uint16_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    if (address % program_unit != 0 || size % program_unit != 0)
+      program_violations_++;
+    for (uint16_t i = 0; i < size; i++) {
+      if (bytes[i] & ~data_[address + i])
+        program_violations_++;
+      data_[address + i] &= bytes[i];
+    }
+    bytes_programmed_ += size;
+    busy_micros_ += uint32_t(size / program_unit) * word_write_micros;
+  }
+
+  void erasePage(uint16_t page) {
+    memset(data_ + uint32_t(page) * page_size, 0xff, page_size);
+    erase_counts_[page]++;
+    busy_micros_ += page_erase_micros;
+  }
+
+  bool isPageErased(uint16_t page) {
+    for (uint16_t i = 0; i < page_size; i++) {
+      if (data_[uint32_t(page) * page_size + i] != 0xff)
+        return false;
+    }
+    return true;
+  }
+
+  // Statistics
+  uint32_t eraseCount(uint16_t page) const {
+    return erase_counts_[page];
+  }
+  uint32_t totalEraseCount() const {
+    uint32_t total = 0;
+    for (uint32_t count : erase_counts_)
+      total += count;
+    return total;
+  }
+  uint32_t maxEraseCount() const {
+    uint32_t max = 0;
+    for (uint32_t count : erase_counts_)
+      max = count > max ? count : max;
+    return max;
+  }
+  uint32_t bytesProgrammed() const {
+    return bytes_programmed_;
+  }
+  uint64_t busyMicros() const {
+    return busy_micros_;
+  }
+  uint32_t programViolations() const {
+    return program_violations_;
+  }
+  void resetStats() {
+    memset(erase_counts_, 0, sizeof(erase_counts_));
+    bytes_programmed_   = 0;
+    busy_micros_        = 0;
+    program_violations_ = 0;
+  }
+
+  // Direct access to the contents, to simulate corruption
+  uint8_t *data() {
+    return data_;
+  }
+
+ private:
+  uint8_t data_[uint32_t(page_size) * page_count];  // NOLINT(runtime/arrays)
+  uint32_t erase_counts_[page_count];                // NOLINT(runtime/arrays)
+  uint32_t bytes_programmed_   = 0;
+  uint64_t busy_micros_        = 0;
+  uint32_t program_violations_ = 0;
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
+
+#endif  // KALEIDOSCOPE_VIRTUAL_BUILD
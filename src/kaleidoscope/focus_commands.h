@@ -0,0 +1,86 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Registration of the Focus commands a plugin implements.
+//
+// Without it, every Focus command is offered to the `onFocusEvent()` handler of
+// every plugin in turn, and each of them compares it to all of its command
+// names until one of them consumes it. A plugin that lists its commands with
+// `KALEIDOSCOPE_FOCUS_COMMANDS()` gets them routed straight to its
+// `onFocusEvent()` instead:
+//
+//   class MyPlugin : public kaleidoscope::Plugin {
+//    public:
+//     KALEIDOSCOPE_FOCUS_COMMANDS("myplugin.foo", "myplugin.bar")
+//     EventHandlerResult onFocusEvent(const char *input);
+//   };
+//
+// `KALEIDOSCOPE_INIT_PLUGINS()` builds the routing from the plugin list at
+// compile time: the command names are reduced to hashes, and a command is
+// passed to the plugins that registered a name with the same hash, without
+// any string comparisons on the way. Only commands that none of them consume
+// (including `help`) are broadcast to all plugins, as before.
+//
+// The list must match the commands `onFocusEvent()` handles, and the handler
+// must still check the name (hashes can collide), and return
+// `EVENT_CONSUMED` for the commands it handles, otherwise the broadcast offers
+// them to it a second time.
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint32_t
+
+#include "kaleidoscope/macro_map.h"  // for MAP
+
+namespace kaleidoscope {
+
+// The 32-bit FNV-1a hash of a command name. It is `constexpr` so that the hashes
+// of registered names are computed by the compiler.
+constexpr uint32_t focusCommandHash(const char *command, uint32_t hash = 2166136261UL) {
+  return *command == '\0'
+           ? hash
+           : focusCommandHash(command + 1, (hash ^ uint8_t(*command)) * 16777619UL);
+}
+
+// Used to force the evaluation of `focusCommandHash()` at compile time.
+template<uint32_t _hash>
+struct FocusCommandHash {
+  static constexpr uint32_t value = _hash;
+};
+
+template<uint32_t _hash>
+constexpr uint32_t FocusCommandHash<_hash>::value;
+
+}  // namespace kaleidoscope
+
+// clang-format off
+
+#define _FOCUS_COMMAND_HASH_MATCHES(COMMAND)                                   \
+  || hash == kaleidoscope::FocusCommandHash<                                   \
+               kaleidoscope::focusCommandHash(COMMAND)>::value
+
+#define KALEIDOSCOPE_FOCUS_COMMANDS(...)                                       \
+  static bool ownsFocusCommand(uint32_t hash) {                                \
+    return false MAP(_FOCUS_COMMAND_HASH_MATCHES, __VA_ARGS__);                \
+  }
+
+// clang-format on
@@ -67,4 +67,13 @@ Hooks::exploreSketch<sketch_exploration::Sketch>() {
   return EventHandlerResult::OK;
 }
 
+// Without KALEIDOSCOPE_INIT_PLUGINS(...), no plugin has registered any Focus
+// commands, and all of them are broadcast to the plugins.
+//
+__attribute__((weak))
+EventHandlerResult
+Hooks::routeFocusCommand(const char * /*input*/) {
+  return EventHandlerResult::OK;
+}
+
 }  // namespace kaleidoscope
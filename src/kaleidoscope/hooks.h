@@ -94,6 +94,10 @@ class Hooks {
 
 #undef DEFINE_WEAK_HOOK_FUNCTION
   // clang-format on
+
+  // Passes a Focus command to the plugins that registered it with
+  // `KALEIDOSCOPE_FOCUS_COMMANDS()`, until one of them doesn't return `OK`.
+  static EventHandlerResult routeFocusCommand(const char *input);
 };
 
 }  // namespace kaleidoscope
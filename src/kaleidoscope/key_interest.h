@@ -0,0 +1,103 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Declaration of the keys a plugin's key event handlers are interested in.
+//
+// Every key event is passed to the `onKeyswitchEvent()`, `onKeyEvent()` and
+// `onAddToReport()` handlers of every plugin in turn, and most of them return
+// `OK` straight away unless the key is one of their own (a Macros key, a mouse
+// key, ...). A plugin that lists its keys with `KALEIDOSCOPE_KEY_INTEREST()`
+// doesn't get called for any others:
+//
+//   class MyPlugin : public kaleidoscope::Plugin {
+//    public:
+//     KALEIDOSCOPE_KEY_INTEREST(keyRange(ranges::MY_FIRST, ranges::MY_LAST),
+//                               singleKey(Key_MyToggle))
+//     EventHandlerResult onKeyEvent(KeyEvent &event);
+//   };
+//
+// The list is made of constants, so the check that the dispatcher built by
+// `KALEIDOSCOPE_INIT_PLUGINS()` makes before calling these handlers compiles
+// down to a few comparisons, inlined in its loop over the plugins. Plugins
+// without a list are called for every key, as before.
+//
+// The list applies to all three handlers, so it's only for plugins that ignore
+// every other key in all of them. One that watches all keys go by (to cancel a
+// one-shot key, or to remember the last key typed, ...) must not declare it.
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t
+
+#include "kaleidoscope/key_defs.h"   // for Key
+#include "kaleidoscope/macro_map.h"  // for MAP
+
+namespace kaleidoscope {
+
+// A set of `Key` values: those whose raw value, masked with `mask`, is between
+// `first` and `last` (inclusive).
+class KeyInterest {
+ public:
+  constexpr KeyInterest(uint16_t mask, uint16_t first, uint16_t last)
+    : mask_(mask), first_(first), last_(last) {}
+
+  constexpr bool matches(Key key) const {
+    return (key.getRaw() & mask_) >= first_ && (key.getRaw() & mask_) <= last_;
+  }
+
+ private:
+  uint16_t mask_;
+  uint16_t first_;
+  uint16_t last_;
+};
+
+// The keys from `first` to `last`, like the ranges in Kaleidoscope-Ranges
+constexpr KeyInterest keyRange(uint16_t first, uint16_t last) {
+  return KeyInterest(0xffff, first, last);
+}
+constexpr KeyInterest keyRange(Key first, Key last) {
+  return keyRange(first.getRaw(), last.getRaw());
+}
+
+// Only `key` itself
+constexpr KeyInterest singleKey(Key key) {
+  return keyRange(key, key);
+}
+
+// The keys whose flags, masked with `mask`, are `flags`, whatever their keycode
+constexpr KeyInterest keyFlags(uint8_t flags, uint8_t mask = 0xff) {
+  return KeyInterest(uint16_t(mask << 8), uint16_t(flags << 8), uint16_t(flags << 8));
+}
+
+}  // namespace kaleidoscope
+
+// clang-format off
+
+#define _KEY_INTEREST_MATCHES(INTEREST)                                        \
+  || kaleidoscope::KeyInterest(INTEREST).matches(key)
+
+#define KALEIDOSCOPE_KEY_INTEREST(...)                                         \
+  static constexpr bool isInterestedInKey(kaleidoscope::Key key) {             \
+    return false MAP(_KEY_INTEREST_MATCHES, __VA_ARGS__);                      \
+  }
+
+// clang-format on
@@ -21,7 +21,7 @@
  */
 
 #include <stdint.h>  // for uint8_t, int8_t
-#include <string.h>  // for memmove, memset
+#include <string.h>  // for memmove
 
 #include "kaleidoscope/KeyAddr.h"          // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
 #include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
@@ -103,7 +103,7 @@ void Layer_::handleLayerKeyEvent(const KeyEvent &event) {
         activate(target_layer_shifted);
         // We can't just change `event.key` here because `live_keys[]` has
         // already been updated by the time `handleLayerKeyEvent()` gets called.
-        live_keys[event.addr] = ShiftToLayer(target_layer);
+        live_keys.activate(event.addr, ShiftToLayer(target_layer));
       }
       break;
 
@@ -149,21 +149,21 @@ Key Layer_::getKeyFromPROGMEM(uint8_t layer, KeyAddr key_addr) {
 }
 
 void Layer_::updateActiveLayers(void) {
-  // First, set every entry in the active layer keymap to point to the default
-  // layer (layer 0).
-  memset(active_layer_keymap_, 0, kaleidoscope_internal::device.numKeys());
-
-  // For each key address, set its entry in the active layer keymap to the value
-  // of the top active layer that has a non-transparent entry for that address.
   for (auto key_addr : KeyAddr::all()) {
-    for (uint8_t i = active_layer_count_; i > 0; --i) {
-      uint8_t layer = unshifted(active_layers_[i - 1]);
+    updateActiveLayer(key_addr);
+  }
+}
 
-      Key key = (*getKey)(layer, key_addr);
-      if (key != Key_Transparent) {
-        active_layer_keymap_[key_addr.toInt()] = layer;
-        break;
-      }
+void Layer_::updateActiveLayer(KeyAddr key_addr) {
+  // Set the entry in the active layer keymap to the value of the top active
+  // layer that has a non-transparent entry for that address.
+  for (uint8_t i = active_layer_count_; i > 0; --i) {
+    uint8_t layer = unshifted(active_layers_[i - 1]);
+
+    Key key = (*getKey)(layer, key_addr);
+    if (key != Key_Transparent) {
+      active_layer_keymap_[key_addr.toInt()] = layer;
+      return;
     }
   }
   // Even if there are no active layers (a situation that should be prevented by
@@ -171,6 +171,31 @@ void Layer_::updateActiveLayers(void) {
   // 0). Likewise, for any address where all active layers have a transparent
   // entry, that key will be mapped from the base layer, even if the base layer
   // has been deactivated.
+  active_layer_keymap_[key_addr.toInt()] = 0;
+}
+
+// When a layer gets pushed onto the top of the stack, the only entries in the
+// active layer keymap that can change are the ones where that layer has a
+// non-transparent key, and those will all be mapped from it, so there's no need
+// to go through the rest of the stack.
+void Layer_::updateActiveLayersForPush(uint8_t layer) {
+  layer = unshifted(layer);
+  for (auto key_addr : KeyAddr::all()) {
+    if ((*getKey)(layer, key_addr) != Key_Transparent)
+      active_layer_keymap_[key_addr.toInt()] = layer;
+  }
+}
+
+// When a layer gets removed from the stack, the only entries in the active
+// layer keymap that can change are the ones that were mapped from it. Every
+// other entry is either mapped from a layer above it, or the removed layer was
+// transparent for that key.
+void Layer_::updateActiveLayersForRemoval(uint8_t layer) {
+  layer = unshifted(layer);
+  for (auto key_addr : KeyAddr::all()) {
+    if (active_layer_keymap_[key_addr.toInt()] == layer)
+      updateActiveLayer(key_addr);
+  }
 }
 
 void Layer_::move(uint8_t layer) {
@@ -213,14 +238,18 @@ void Layer_::activate(uint8_t layer) {
 
   // Update the keymap cache (but not live_composite_keymap_; that gets
   // updated separately, when keys toggle on or off. See layers.h)
-  updateActiveLayers();
+  updateActiveLayersForPush(layer);
 
   kaleidoscope::Hooks::onLayerChange();
 }
 
 void Layer_::remove(uint8_t i) {
+  uint8_t layer = active_layers_[i];
   memmove(&active_layers_[i], &active_layers_[i + 1], active_layer_count_ - (i + 1));
   --active_layer_count_;
+
+  // Update the keymap cache entries that were mapped from the removed layer.
+  updateActiveLayersForRemoval(layer);
 }
 
 // Deactivate a given layer
@@ -239,12 +268,9 @@ void Layer_::deactivate(uint8_t layer) {
   }
 
   // Remove the target layer from the active layer stack, and shift any layers
-  // above it down to fill in the gap.
+  // above it down to fill in the gap. This also updates the keymap cache.
   remove(current_pos);
 
-  // Update the keymap cache.
-  updateActiveLayers();
-
   kaleidoscope::Hooks::onLayerChange();
 }
 
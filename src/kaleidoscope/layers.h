@@ -135,6 +135,9 @@ class Layer_ {
 
   static Key getKeyFromPROGMEM(uint8_t layer, KeyAddr key_addr);
 
+  // Layer changes only update the entries of the active layer keymap cache
+  // that they affect. This rebuilds the whole cache, and should be called if
+  // the contents of the keymap (or the `getKey` function) change.
   static void updateActiveLayers(void);
 
  private:
@@ -151,6 +154,10 @@ class Layer_ {
   static int8_t stackPosition(uint8_t layer);
   static void remove(uint8_t stack_index);
   static uint8_t unshifted(uint8_t layer);
+
+  static void updateActiveLayer(KeyAddr key_addr);
+  static void updateActiveLayersForPush(uint8_t layer);
+  static void updateActiveLayersForRemoval(uint8_t layer);
 };
 }  // namespace kaleidoscope
 
@@ -23,11 +23,11 @@
 #include "kaleidoscope/plugin/LEDControl.h"
 
 #include <Arduino.h>                   // for PSTR, strncmp_P
+#include <string.h>                    // for memcmp
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 
-#include "kaleidoscope/KeyAddrMap.h"               // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddrBitfield.h"          // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"                 // for KeyEvent
-#include "kaleidoscope/KeyMap.h"                   // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                 // for LiveKeys, live_keys
 #include "kaleidoscope/hooks.h"                    // for Hooks
 #include "kaleidoscope/keyswitch_state.h"          // for keyToggledOn
@@ -45,10 +45,51 @@ uint8_t LEDControl::num_led_modes_ = LEDModeManager::numLEDModes();
 LEDMode *LEDControl::cur_led_mode_ = nullptr;
 bool LEDControl::enabled_          = true;
 
+LEDBitfield LEDControl::changed_leds_;
+uint16_t LEDControl::frame_generation_ = 0;
+uint32_t LEDControl::frames_sent_      = 0;
+uint32_t LEDControl::frames_skipped_   = 0;
+
+LEDLayer *LEDControl::layers_ = nullptr;
+LEDBitfield LEDControl::covered_leds_;
+LEDBitfield LEDControl::stale_leds_;
+
+static bool sameColor(const cRGB &a, const cRGB &b) {
+  return memcmp(&a, &b, sizeof(cRGB)) == 0;
+}
+
+static uint8_t addChannels(uint8_t a, uint8_t b) {
+  uint16_t sum = a + b;
+  return sum > 255 ? 255 : sum;
+}
+
+static uint8_t multiplyChannels(uint8_t a, uint8_t b) {
+  // Exact for 0 and 255, and within one of a * b / 255 in between
+  return (uint16_t(a) * b + 255) >> 8;
+}
+
+static cRGB blend(cRGB below, cRGB above, LEDLayer::Blend mode) {
+  switch (mode) {
+  case LEDLayer::Blend::Add:
+    below.r = addChannels(below.r, above.r);
+    below.g = addChannels(below.g, above.g);
+    below.b = addChannels(below.b, above.b);
+    return below;
+  case LEDLayer::Blend::Multiply:
+    below.r = multiplyChannels(below.r, above.r);
+    below.g = multiplyChannels(below.g, above.g);
+    below.b = multiplyChannels(below.b, above.b);
+    return below;
+  case LEDLayer::Blend::Replace:
+  default:
+    return above;
+  }
+}
+
 LEDControl::LEDControl(void) {
 }
-uint8_t LEDControl::sync_interval_   = 32;
-uint16_t LEDControl::last_sync_time_ = 0;
+uint8_t LEDControl::sync_interval_ = 32;
+Deadline LEDControl::sync_deadline_{LEDControl::onSyncDeadline};
 
 void LEDControl::next_mode() {
   ++mode_id_;
@@ -115,11 +156,24 @@ void LEDControl::set_all_leds_to(cRGB color) {
   if (!Runtime.has_leds)
     return;
 
+  if (layers_ == nullptr)
+    return fillLeds(color);
+
+  for (auto led_index : Runtime.device().LEDs().all()) {
+    setCrgbAt(led_index.offset(), color);
+  }
+}
+
+void LEDControl::fillLeds(cRGB color) {
   bool will_be_on = (color.r != 0 || color.g != 0 || color.b != 0);
   bool was_off    = !Runtime.device().ledDriver().areAnyLEDsOn();
 
   for (auto led_index : Runtime.device().LEDs().all()) {
-    Runtime.device().ledDriver().setCrgbAt(led_index.offset(), color);
+    uint8_t i = led_index.offset();
+    if (sameColor(Runtime.device().ledDriver().getCrgbAt(i), color))
+      continue;
+    Runtime.device().ledDriver().setCrgbAt(i, color);
+    changed_leds_.set(i);
   }
 
   Runtime.device().ledDriver().updateAllLEDState(will_be_on, was_off);
@@ -129,13 +183,105 @@ void LEDControl::setCrgbAt(uint8_t led_index, cRGB crgb) {
   if (!Runtime.has_leds)
     return;
 
+  // Keys without an LED have an out of range index, which the drivers ignore.
+  if (led_index >= LEDBitfield::size)
+    return;
+
+  if (covered_leds_.read(led_index))
+    crgb = composite(led_index, crgb);
+  stale_leds_.clear(led_index);
+
+  writeLed(led_index, crgb);
+}
+
+void LEDControl::writeLed(uint8_t led_index, cRGB crgb) {
+  // Effects often set LEDs to the color they already have; those don't need
+  // another frame.
+  cRGB current = Runtime.device().ledDriver().getCrgbAt(led_index);
+  if (sameColor(current, crgb))
+    return;
+
   // Check LED state change
-  cRGB current    = Runtime.device().ledDriver().getCrgbAt(led_index);
   bool was_off    = (current.r == 0 && current.g == 0 && current.b == 0);
   bool will_be_on = (crgb.r != 0 || crgb.g != 0 || crgb.b != 0);
 
   Runtime.device().ledDriver().setCrgbAt(led_index, crgb);
   Runtime.device().ledDriver().updateLEDState(will_be_on, was_off);
+  changed_leds_.set(led_index);
+}
+
+void LEDControl::addLayer(LEDLayer &layer) {
+  LEDLayer **tail = &layers_;
+  while (*tail != nullptr) {
+    if (*tail == &layer)
+      return;
+    tail = &(*tail)->next_;
+  }
+  *tail = &layer;
+
+  // The layer may have covered LEDs before it was added.
+  for (auto led_index : Runtime.device().LEDs().all()) {
+    if (layer.covers(led_index.offset()))
+      invalidate(led_index.offset());
+  }
+}
+
+void LEDControl::invalidate(uint8_t led_index) {
+  bool covered = false;
+  for (LEDLayer *layer = layers_; layer != nullptr; layer = layer->next_) {
+    if (layer->covers(led_index)) {
+      covered = true;
+      break;
+    }
+  }
+  if (covered)
+    covered_leds_.set(led_index);
+  else
+    covered_leds_.clear(led_index);
+  stale_leds_.set(led_index);
+}
+
+cRGB LEDControl::composite(uint8_t led_index, cRGB color) {
+  for (LEDLayer *layer = layers_; layer != nullptr; layer = layer->next_) {
+    if (layer->covers(led_index))
+      color = blend(color, layer->colorAt(led_index), layer->blend());
+  }
+  return color;
+}
+
+// Returns `true` if one of the layers that cover the LED replaces the colors
+// below it, so that its composite color doesn't depend on the LED mode.
+bool LEDControl::isOpaque(uint8_t led_index) {
+  for (LEDLayer *layer = layers_; layer != nullptr; layer = layer->next_) {
+    if (layer->covers(led_index) && layer->blend() == LEDLayer::Blend::Replace)
+      return true;
+  }
+  return false;
+}
+
+void LEDControl::updateStaleLeds() {
+  if (stale_leds_.isEmpty())
+    return;
+
+  // The LED mode redraws the stale LEDs under keys, and `setCrgbAt()` blends
+  // the layers over its colors.
+  if (cur_led_mode_ != nullptr) {
+    for (auto key_addr : KeyAddr::all()) {
+      uint8_t led_index = Runtime.device().getLedIndex(key_addr);
+      if (led_index < LEDBitfield::size && stale_leds_.read(led_index))
+        cur_led_mode_->refreshAt(key_addr);
+    }
+  }
+
+  // What's left either isn't under a key, or the LED mode only draws in
+  // `update()`. Where a layer replaces the color of the LED mode, the composite
+  // color is known anyway; the others wait for the LED mode's next update.
+  for (auto led_index : Runtime.device().LEDs().all()) {
+    uint8_t i = led_index.offset();
+    if (stale_leds_.read(i) && isOpaque(i))
+      writeLed(i, composite(i, CRGB(0, 0, 0)));
+  }
+  stale_leds_.clear();
 }
 
 void LEDControl::setCrgbAt(KeyAddr key_addr, cRGB color) {
@@ -157,11 +303,34 @@ void LEDControl::syncLeds(void) {
   // that needs to override the color of an LED used by an LED mode can do so
   // efficiently.
   Hooks::beforeSyncingLeds();
+  updateStaleLeds();
+
+  if (changed_leds_.isEmpty()) {
+    // Nothing changed since the last frame, but the device may not have gotten
+    // all of it (if a write to the LEDs failed), in which case it retries.
+    if (Runtime.device().isLEDSyncPending()) {
+      Runtime.device().syncLeds();
+    } else {
+      ++frames_skipped_;
+    }
+    return;
+  }
 
+  sendFrame();
+}
+
+void LEDControl::sendFrame() {
+  // The device drivers keep track of which of their banks changed themselves,
+  // so they are only told that something did.
   Runtime.device().syncLeds();
+  changed_leds_.clear();
+  ++frame_generation_;
+  ++frames_sent_;
 }
 
 EventHandlerResult LEDControl::onSetup() {
+  // We don't know what the LEDs show before the first frame is sent.
+  changed_leds_.setAll();
   set_all_leds_to({0, 0, 0});
 
   LEDModeManager::setupPersistentLEDModes();
@@ -170,19 +339,26 @@ EventHandlerResult LEDControl::onSetup() {
     set_mode(0);
   }
 
+  if (enabled_)
+    Runtime.armDeadline(sync_deadline_, sync_interval_);
+
   return EventHandlerResult::OK;
 }
 
 void LEDControl::disable() {
-  set_all_leds_to(CRGB(0, 0, 0));
-  Runtime.device().syncLeds();
+  // Layers are not blended in here: everything goes dark.
+  fillLeds(CRGB(0, 0, 0));
+  sendFrame();
   enabled_ = false;
+  Runtime.cancelDeadline(sync_deadline_);
 }
 
 void LEDControl::enable() {
   enabled_ = true;
   refreshAll();
-  Runtime.device().syncLeds();
+  sendFrame();
+  if (!sync_deadline_.isArmed())
+    Runtime.armDeadline(sync_deadline_, sync_interval_);
 }
 
 EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
@@ -194,8 +370,8 @@ EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
       // First, check for an active shift key.
       bool shift_active = false;
       // This change should be back-ported to #904
-      for (Key active_key : live_keys.all()) {
-        if (active_key.isKeyboardShift()) {
+      for (KeyAddr key_addr : live_keys.active()) {
+        if (live_keys[key_addr].isKeyboardShift()) {
           shift_active = true;
           break;
         }
@@ -222,17 +398,25 @@ EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
   return EventHandlerResult::EVENT_CONSUMED;
 }
 
-EventHandlerResult LEDControl::afterEachCycle() {
-  if (!enabled_)
+EventHandlerResult LEDControl::onFocusEvent(const char *input) {
+  const char *cmd_frames = PSTR("led.frames");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_frames);
+
+  if (!::Focus.inputMatchesCommand(input, cmd_frames))
     return EventHandlerResult::OK;
 
-  if (Runtime.hasTimeExpired(last_sync_time_, sync_interval_)) {
-    syncLeds();
-    last_sync_time_ += sync_interval_;
-    update();
-  }
+  ::Focus.send(frames_sent_, frames_skipped_);
+  return EventHandlerResult::EVENT_CONSUMED;
+}
 
-  return EventHandlerResult::OK;
+void LEDControl::onSyncDeadline() {
+  syncLeds();
+  // Re-arm relative to the last expiry, rather than the current time, so that
+  // the LEDs are synced at a steady rate even when cycles are slow.
+  Runtime.rearmDeadline(sync_deadline_, sync_interval_);
+  update();
 }
 
 
@@ -22,17 +22,22 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t, uint16_t
-
-#include "kaleidoscope/KeyAddr.h"                  // for KeyAddr
-#include "kaleidoscope/KeyEvent.h"                 // for KeyEvent
-#include "kaleidoscope/Runtime.h"                  // for Runtime, Runtime_
-#include "kaleidoscope/device/device.h"            // for cRGB, Device, Base<>::LEDDriver, Virtu...
-#include "kaleidoscope/event_handler_result.h"     // for EventHandlerResult
-#include "kaleidoscope/key_defs.h"                 // for Key, IS_INTERNAL, KEY_FLAGS, SYNTHETIC
-#include "kaleidoscope/plugin.h"                   // for Plugin
-#include "kaleidoscope/plugin/LEDMode.h"           // for LEDMode
-#include "kaleidoscope/plugin/LEDModeInterface.h"  // for LEDModeInterface
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/Deadline.h"                    // for Deadline
+#include "kaleidoscope/KeyAddr.h"                     // for KeyAddr
+#include "kaleidoscope/KeyEvent.h"                    // for KeyEvent
+#include "kaleidoscope/LEDBitfield.h"                 // for LEDBitfield
+#include "kaleidoscope/Runtime.h"                     // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"               // for cRGB, Device, Base<>::LEDDriver, Virtu...
+#include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult
+#include "kaleidoscope/focus_commands.h"              // for KALEIDOSCOPE_FOCUS_COMMANDS
+#include "kaleidoscope/key_defs.h"                    // for Key, IS_INTERNAL, KEY_FLAGS, SYNTHETIC
+#include "kaleidoscope/key_interest.h"                // for KALEIDOSCOPE_KEY_INTEREST
+#include "kaleidoscope/plugin.h"                      // for Plugin
+#include "kaleidoscope/plugin/LEDControl/LEDLayer.h"  // for LEDLayer
+#include "kaleidoscope/plugin/LEDMode.h"              // for LEDMode
+#include "kaleidoscope/plugin/LEDModeInterface.h"     // for LEDModeInterface
 
 constexpr uint8_t LED_TOGGLE = 0b00000001;  // Synthetic, internal
 
@@ -93,11 +98,40 @@ class LEDControl : public kaleidoscope::Plugin {
   static void setCrgbAt(KeyAddr key_addr, cRGB color);
   static cRGB getCrgbAt(uint8_t led_index);
   static cRGB getCrgbAt(KeyAddr key_addr);
+
+  // Sends the colors to the LEDs, unless none of them changed since the last
+  // time they were sent. Only changes made through `LEDControl` are noticed,
+  // so anything that writes to the LED driver directly has to sync it itself.
   static void syncLeds(void);
 
+  // Returns `true` if the color of the LED at `led_index` changed since the
+  // last frame was sent.
+  static bool hasChanged(uint8_t led_index) {
+    return changed_leds_.read(led_index);
+  }
+  // The number of frames sent to the LEDs so far (wrapping around at 2^16).
+  // Effects can compare it to a value they saved to find out if their last
+  // changes have been sent yet.
+  static uint16_t frameGeneration() {
+    return frame_generation_;
+  }
+  // The number of syncs that sent a frame to the LEDs, and the number of syncs
+  // that were skipped because nothing changed.
+  static uint32_t framesSent() {
+    return frames_sent_;
+  }
+  static uint32_t framesSkipped() {
+    return frames_skipped_;
+  }
+
   static void set_all_leds_to(uint8_t r, uint8_t g, uint8_t b);
   static void set_all_leds_to(cRGB color);
 
+  // Puts `layer` on top of the compositor's stack of layers. The colors set by
+  // the active LED mode are at the bottom; the LEDs a layer covers show the
+  // result of blending its color over everything below it. See `LEDLayer`.
+  static void addLayer(LEDLayer &layer);
+
   // We restict activate to LEDModeInterface to make sure that
   // a compiler error is thrown when activate() is accidentally
   // applied to a non-LED mode plugin.
@@ -109,8 +143,10 @@ class LEDControl : public kaleidoscope::Plugin {
   }
 
   EventHandlerResult onSetup();
+  KALEIDOSCOPE_KEY_INTEREST(keyFlags(SYNTHETIC | IS_INTERNAL | LED_TOGGLE))
   EventHandlerResult onKeyEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
+  KALEIDOSCOPE_FOCUS_COMMANDS("led.frames")
+  EventHandlerResult onFocusEvent(const char *input);
 
   static void disable();
   static void enable();
@@ -120,18 +156,42 @@ class LEDControl : public kaleidoscope::Plugin {
 
   static void setBrightness(uint8_t brightness) {
     Runtime.device().ledDriver().setBrightness(brightness);
+    changed_leds_.setAll();
   }
   static uint8_t getBrightness() {
     return Runtime.device().ledDriver().getBrightness();
   }
 
  private:
-  static uint16_t last_sync_time_;
   static uint8_t sync_interval_;
+  static Deadline sync_deadline_;
   static uint8_t mode_id_;
   static uint8_t num_led_modes_;
   static LEDMode *cur_led_mode_;
   static bool enabled_;
+
+  // The LEDs whose color changed since the last frame was sent
+  static LEDBitfield changed_leds_;
+  static uint16_t frame_generation_;
+  static uint32_t frames_sent_;
+  static uint32_t frames_skipped_;
+
+  // The bottom of the stack of layers, and the LEDs any of them covers
+  static LEDLayer *layers_;
+  static LEDBitfield covered_leds_;
+  // The covered or uncovered LEDs whose composite color needs updating
+  static LEDBitfield stale_leds_;
+
+  friend class LEDLayer;
+  static void invalidate(uint8_t led_index);
+  static cRGB composite(uint8_t led_index, cRGB color);
+  static bool isOpaque(uint8_t led_index);
+  static void updateStaleLeds();
+
+  static void writeLed(uint8_t led_index, cRGB crgb);
+  static void fillLeds(cRGB color);
+  static void sendFrame();
+  static void onSyncDeadline();
 };
 
 
@@ -0,0 +1,67 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/LEDControl/LEDLayer.h"
+
+#include "kaleidoscope/Runtime.h"            // for Runtime, Runtime_
+#include "kaleidoscope/plugin/LEDControl.h"  // for LEDControl
+
+namespace kaleidoscope {
+namespace plugin {
+
+void LEDLayer::cover(uint8_t led_index) {
+  if (led_index >= LEDBitfield::size || coverage_.read(led_index))
+    return;
+
+  coverage_.set(led_index);
+  LEDControl::invalidate(led_index);
+}
+
+void LEDLayer::cover(KeyAddr key_addr) {
+  cover(Runtime.device().getLedIndex(key_addr));
+}
+
+void LEDLayer::uncover(uint8_t led_index) {
+  if (led_index >= LEDBitfield::size || !coverage_.read(led_index))
+    return;
+
+  coverage_.clear(led_index);
+  LEDControl::invalidate(led_index);
+}
+
+void LEDLayer::uncover(KeyAddr key_addr) {
+  uncover(Runtime.device().getLedIndex(key_addr));
+}
+
+void LEDLayer::refresh(uint8_t led_index) {
+  if (led_index >= LEDBitfield::size || !coverage_.read(led_index))
+    return;
+
+  LEDControl::invalidate(led_index);
+}
+
+void LEDLayer::refresh(KeyAddr key_addr) {
+  refresh(Runtime.device().getLedIndex(key_addr));
+}
+
+}  // namespace plugin
+}  // namespace kaleidoscope
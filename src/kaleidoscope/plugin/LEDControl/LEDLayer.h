@@ -0,0 +1,88 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/KeyAddr.h"        // for KeyAddr
+#include "kaleidoscope/LEDBitfield.h"    // for LEDBitfield
+#include "kaleidoscope/device/device.h"  // for cRGB
+
+namespace kaleidoscope {
+namespace plugin {
+
+// A layer of the LED compositor. Plugins that draw over the active LED mode
+// (highlights, overlays, indicators) derive from it, and register themselves
+// with `LEDControl.addLayer()`. Instead of overwriting the colors the LED mode
+// set, a layer only says which LEDs it covers, and what color it has there;
+// `LEDControl` combines that with the color of the LED mode, and the colors of
+// the other layers, whenever one of them changes.
+//
+// Layers are stacked in the order they were added, the first one at the
+// bottom.
+class LEDLayer {
+ public:
+  // How the color of the layer is combined with the color below it
+  enum class Blend : uint8_t {
+    Replace,   // The color of the layer is used as is
+    Add,       // The two colors are added, each channel saturating at 255
+    Multiply,  // The color below is scaled by the color of the layer
+  };
+
+  explicit LEDLayer(Blend blend = Blend::Replace)
+    : blend_(blend) {}
+
+  Blend blend() const {
+    return blend_;
+  }
+  bool covers(uint8_t led_index) const {
+    return coverage_.read(led_index);
+  }
+
+  // Returns the color of the layer at `led_index`. It is only called for the
+  // LEDs the layer covers.
+  virtual cRGB colorAt(uint8_t led_index) = 0;
+
+ protected:
+  // Start or stop covering an LED. LEDs that aren't valid (e.g. those of keys
+  // without an LED) are ignored.
+  void cover(uint8_t led_index);
+  void cover(KeyAddr key_addr);
+  void uncover(uint8_t led_index);
+  void uncover(KeyAddr key_addr);
+
+  // Tells the compositor that `colorAt()` returns something else for an LED
+  // the layer covers.
+  void refresh(uint8_t led_index);
+  void refresh(KeyAddr key_addr);
+
+ private:
+  friend class LEDControl;
+
+  LEDBitfield coverage_;
+  Blend blend_;
+  LEDLayer *next_{nullptr};
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
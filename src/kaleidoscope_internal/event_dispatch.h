@@ -45,6 +45,10 @@
 #include "kaleidoscope/macro_helpers.h"                                   // for __NL__, UNWRAP
 #include "kaleidoscope/plugin.h"  // IWYU pragma: keep
 #include "kaleidoscope_internal/eventhandler_signature_check.h"           // for _PREPARE_EVENT_...
+#include "kaleidoscope_internal/focus_command_router.h"                   // for _INIT_FOCUS_COMM...
+#include "kaleidoscope_internal/hook_profiler.h"                          // for _INIT_HOOK_PROFILER
+#include "kaleidoscope_internal/key_interest_filter.h"                    // for wants
+#include "kaleidoscope_internal/latency_trace.h"                          // for _INIT_LATENCY_TRACE
 #include "kaleidoscope_internal/sketch_exploration/plugin_exploration.h"  // for _INIT_PLUGIN_EX...
 #include "kaleidoscope_internal/sketch_exploration/sketch_exploration.h"  // IWYU pragma: keep
 
@@ -128,6 +132,17 @@
         return SHOULD_EXIT_IF_RESULT_NOT_OK;                              __NL__ \
       }                                                                   __NL__ \
                                                                           __NL__ \
+      /* These are only used for hook profiling */                        __NL__ \
+      static constexpr uint8_t profilerHook() {                           __NL__ \
+        return hook_profiler::HookIds::HOOK_NAME;                         __NL__ \
+      }                                                                   __NL__ \
+                                                                          __NL__ \
+      template<typename Plugin__>                                         __NL__ \
+      static constexpr bool isImplementedBy() {                           __NL__ \
+        return HookVersionImplemented_##HOOK_NAME<                        __NL__ \
+                 Plugin__, HOOK_VERSION>::value;                          __NL__ \
+      }                                                                   __NL__ \
+                                                                          __NL__ \
       template<typename Plugin__,                                         __NL__ \
                typename... Args__>                                        __NL__ \
       static kaleidoscope::EventHandlerResult                             __NL__ \
@@ -135,6 +150,14 @@
                                                                           __NL__ \
          _VALIDATE_EVENT_HANDLER_SIGNATURE(HOOK_NAME, Plugin__)           __NL__ \
                                                                           __NL__ \
+         /* Plugins that declared the keys they are interested in */     __NL__ \
+         /* aren't called for any others (see key_interest.h).     */     __NL__ \
+         if (!key_interest_filter::wants<                                 __NL__ \
+                key_interest_filter::FilteredHooks::HOOK_NAME,            __NL__ \
+                Plugin__>(hook_args...)) {                                __NL__ \
+            return kaleidoscope::EventHandlerResult::OK;                  __NL__ \
+         }                                                                __NL__ \
+                                                                          __NL__ \
          static constexpr bool derived_implements_hook                    __NL__ \
             = HookVersionImplemented_##HOOK_NAME<                         __NL__ \
                  Plugin__, HOOK_VERSION>::value;                          __NL__ \
@@ -162,6 +185,8 @@
      MAKE_TEMPLATE_SIGNATURE(UNWRAP TMPL_PARAM_TYPE_LIST)                 __NL__ \
      EventHandlerResult Hooks::HOOK_NAME SIGNATURE {                      __NL__ \
                                                                           __NL__ \
+        _PROFILE_HOOK(HOOK_NAME)                                          __NL__ \
+                                                                          __NL__ \
         EventHandlerResult device_result = EventHandlerResult::OK;        __NL__ \
                                                                           __NL__ \
           device_result = ::kaleidoscope::Runtime.device().HOOK_NAME      __NL__ \
@@ -184,7 +209,7 @@
 
 #define _INLINE_EVENT_HANDLER_FOR_PLUGIN(PLUGIN)                            \
                                                                      __NL__ \
-   result = EventHandler__::call(PLUGIN, hook_args...);              __NL__ \
+   result = _CALL_EVENT_HANDLER(PLUGIN);                             __NL__ \
                                                                      __NL__ \
    if (EventHandler__::shouldExitIfResultNotOk() &&                  __NL__ \
        result != kaleidoscope::EventHandlerResult::OK) {             __NL__ \
@@ -211,6 +236,7 @@
     static kaleidoscope::EventHandlerResult apply(Args__&&... hook_args) {    __NL__ \
                                                                               __NL__ \
       kaleidoscope::EventHandlerResult result;                                __NL__ \
+      _DECLARE_PROFILED_PLUGIN_INDEX                                          __NL__ \
       MAP(_INLINE_EVENT_HANDLER_FOR_PLUGIN, __VA_ARGS__)                      __NL__ \
                                                                               __NL__ \
       return result;                                                          __NL__ \
@@ -236,4 +262,10 @@
   /* LEDModeFactory entries                                                */ __NL__ \
   _INIT_LED_MODE_MANAGER(__VA_ARGS__)                                         __NL__ \
                                                                               __NL__ \
-  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)
+  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)                                       __NL__ \
+                                                                              __NL__ \
+  _INIT_FOCUS_COMMAND_ROUTER(__VA_ARGS__)                                     __NL__ \
+                                                                              __NL__ \
+  _INIT_HOOK_PROFILER(__VA_ARGS__)                                            __NL__ \
+                                                                              __NL__ \
+  _INIT_LATENCY_TRACE
@@ -0,0 +1,112 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Routing of Focus commands to the plugins that registered them with
+// `KALEIDOSCOPE_FOCUS_COMMANDS()` (see kaleidoscope/focus_commands.h).
+//
+// `KALEIDOSCOPE_INIT_PLUGINS()` defines `Hooks::routeFocusCommand()` as a
+// compile-time loop over the plugins, like the one `EventDispatcher` runs for
+// each hook, except that only the plugins that registered commands are part of
+// it. For each of them, the hash of the command is compared to the hashes of
+// its command names, which are constants, and its `onFocusEvent()` is called
+// only if one of them matches. Without the macro, the weak definition in
+// hooks.cpp routes nothing, and every command takes the broadcast path.
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t
+
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/focus_commands.h"        // for focusCommandHash
+#include "kaleidoscope/macro_helpers.h"         // for __NL__
+#include "kaleidoscope/macro_map.h"             // for MAP
+
+namespace kaleidoscope_internal {
+namespace focus_command_router {
+
+// Whether `_Plugin` registered its Focus commands
+template<typename _Plugin>
+struct RegistersFocusCommands {
+  template<typename _T>
+  static constexpr bool test(decltype(&_T::ownsFocusCommand)) {
+    return true;
+  }
+  template<typename _T>
+  static constexpr bool test(...) {
+    return false;
+  }
+
+  static constexpr bool value = test<_Plugin>(nullptr);
+};
+
+template<bool _registers_commands>
+struct Route {
+  template<typename _Plugin>
+  static kaleidoscope::EventHandlerResult call(_Plugin &plugin, uint32_t hash, const char *input) {
+    if (!_Plugin::ownsFocusCommand(hash))
+      return kaleidoscope::EventHandlerResult::OK;
+    return plugin.onFocusEvent(input);
+  }
+};
+
+template<>
+struct Route<false> {
+  template<typename _Plugin>
+  static kaleidoscope::EventHandlerResult call(_Plugin & /*plugin*/, uint32_t /*hash*/, const char * /*input*/) {
+    return kaleidoscope::EventHandlerResult::OK;
+  }
+};
+
+template<typename _Plugin>
+kaleidoscope::EventHandlerResult route(_Plugin &plugin, uint32_t hash, const char *input) {
+  return Route<RegistersFocusCommands<_Plugin>::value>::call(plugin, hash, input);
+}
+
+}  // namespace focus_command_router
+}  // namespace kaleidoscope_internal
+
+// clang-format off
+
+#define _ROUTE_FOCUS_COMMAND_TO_PLUGIN(PLUGIN)                                 \
+                                                                        __NL__ \
+  result = focus_command_router::route(PLUGIN, hash, input);            __NL__ \
+  if (result != kaleidoscope::EventHandlerResult::OK) {                 __NL__ \
+    return result;                                                      __NL__ \
+  }                                                                     __NL__
+
+#define _INIT_FOCUS_COMMAND_ROUTER(...)                                       __NL__ \
+  namespace kaleidoscope_internal {                                           __NL__ \
+  kaleidoscope::EventHandlerResult routeFocusCommand(const char *input) {     __NL__ \
+    uint32_t hash = kaleidoscope::focusCommandHash(input);                    __NL__ \
+    kaleidoscope::EventHandlerResult result;                                  __NL__ \
+    MAP(_ROUTE_FOCUS_COMMAND_TO_PLUGIN, __VA_ARGS__)                          __NL__ \
+    return kaleidoscope::EventHandlerResult::OK;                              __NL__ \
+  }                                                                           __NL__ \
+  } /* namespace kaleidoscope_internal */                                     __NL__ \
+                                                                              __NL__ \
+  namespace kaleidoscope {                                                    __NL__ \
+  EventHandlerResult Hooks::routeFocusCommand(const char *input) {            __NL__ \
+    return kaleidoscope_internal::routeFocusCommand(input);                   __NL__ \
+  }                                                                           __NL__ \
+  } /* namespace kaleidoscope */
+
+// clang-format on
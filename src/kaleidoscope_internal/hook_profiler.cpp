@@ -0,0 +1,52 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope_internal/hook_profiler.h"
+
+#include <Arduino.h>  // for PROGMEM, pgm_read_byte
+
+namespace kaleidoscope_internal {
+namespace hook_profiler {
+
+const char hook_names[] PROGMEM =
+  "beforeEachCycle\0"
+  "onKeyswitchEvent\0"
+  "onKeyEvent\0"
+  "afterEachCycle\0"
+  "beforeSyncingLeds\0";
+
+// These are replaced by `KALEIDOSCOPE_INIT_PLUGINS()` if the sketch is built
+// with `KALEIDOSCOPE_HOOK_PROFILING`.
+__attribute__((weak)) extern const char plugin_names[] PROGMEM = "";
+__attribute__((weak)) extern const uint8_t plugin_count        = 0;
+
+const __FlashStringHelper *name(const char *names, uint8_t n) {
+  while (n-- > 0) {
+    while (pgm_read_byte(names++) != '\0') {}
+  }
+  return reinterpret_cast<const __FlashStringHelper *>(names);
+}
+
+__attribute__((weak)) void reset() {}
+
+}  // namespace hook_profiler
+}  // namespace kaleidoscope_internal
@@ -0,0 +1,181 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Optional timing of the hooks dispatched by `KALEIDOSCOPE_INIT_PLUGINS()`.
+//
+// When `KALEIDOSCOPE_HOOK_PROFILING` is defined (either as a build flag, or in
+// the sketch before `Kaleidoscope.h` is included), the event dispatcher times
+// every call of the hooks listed in `HookIds` below, both as a whole and for
+// each plugin, and records the results in `hook_stats`. Without it, none of
+// this code is used, and the weak definitions in hook_profiler.cpp leave the
+// tables empty.
+
+// clang-format off
+
+#pragma once
+
+#include <Arduino.h>  // for micros, PROGMEM
+#include <stdint.h>   // for uint8_t, uint32_t
+#include <string.h>   // for memset
+
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/event_handlers.h"        // for _FOR_EACH_EVENT_HANDLER
+#include "kaleidoscope/macro_helpers.h"         // for __NL__
+#include "kaleidoscope/macro_map.h"             // for MAP, MAP_LIST
+
+namespace kaleidoscope_internal {
+namespace hook_profiler {
+
+// Timing statistics for a hook, in microseconds
+struct Stats {
+  uint32_t calls;
+  uint32_t total_time;
+  uint32_t max_time;
+
+  void record(uint32_t time) {
+    ++calls;
+    total_time += time;
+    if (time > max_time)
+      max_time = time;
+  }
+};
+
+constexpr uint8_t unprofiled = 0xff;
+
+// Every hook gets an id, named after it, that is `unprofiled`...
+#define _DEFINE_UNPROFILED_HOOK_ID(HOOK_NAME, ...)                      __NL__ \
+  static constexpr uint8_t HOOK_NAME = unprofiled;
+
+struct UnprofiledHookIds {
+  _FOR_EACH_EVENT_HANDLER(_DEFINE_UNPROFILED_HOOK_ID)
+};
+
+#undef _DEFINE_UNPROFILED_HOOK_ID
+
+// ...except for the ones that get profiled, whose ids hide those. The order of
+// these must match `hook_names` in hook_profiler.cpp.
+struct HookIds : UnprofiledHookIds {
+  static constexpr uint8_t beforeEachCycle   = 0;
+  static constexpr uint8_t onKeyswitchEvent  = 1;
+  static constexpr uint8_t onKeyEvent        = 2;
+  static constexpr uint8_t afterEachCycle    = 3;
+  static constexpr uint8_t beforeSyncingLeds = 4;
+};
+
+constexpr uint8_t hook_count = 5;
+
+// The names of the profiled hooks, and of the plugins in the order they were
+// passed to `KALEIDOSCOPE_INIT_PLUGINS()`, as NUL-separated lists in PROGMEM.
+extern const char hook_names[] PROGMEM;
+extern const char plugin_names[] PROGMEM;
+extern const uint8_t plugin_count;
+
+// Timing statistics for each profiled hook. The first row has the time taken
+// by the whole dispatch of each hook, and the following ones, one per plugin,
+// have the time taken by that plugin's handler. Only sketches built with
+// `KALEIDOSCOPE_HOOK_PROFILING` define it; otherwise it is a weak reference
+// without any storage, and must not be used while `plugin_count` is 0.
+extern Stats hook_stats[][hook_count] __attribute__((weak));
+
+// Returns the `n`th name in one of the lists of names above.
+const __FlashStringHelper *name(const char *names, uint8_t n);
+
+// Clear all timing statistics
+void reset();
+
+// Times one dispatch of the hook `hook`, from construction to destruction.
+template<uint8_t hook>
+class HookTimer {
+ public:
+  HookTimer() : start_(micros()) {}
+  ~HookTimer() {
+    hook_stats[0][hook].record(micros() - start_);
+  }
+
+ private:
+  uint32_t start_;
+};
+
+template<>
+class HookTimer<unprofiled> {
+ public:
+  HookTimer() {}
+};
+
+// Calls a plugin's event handler, and times it if the plugin implements a
+// profiled hook.
+template<typename EventHandler, typename Plugin, typename... Args>
+kaleidoscope::EventHandlerResult call(uint8_t plugin_index, Plugin &plugin, Args &&...hook_args) {
+  if (EventHandler::profilerHook() == unprofiled ||
+      !EventHandler::template isImplementedBy<Plugin>())
+    return EventHandler::call(plugin, hook_args...);
+
+  uint32_t start = micros();
+  kaleidoscope::EventHandlerResult result = EventHandler::call(plugin, hook_args...);
+  hook_stats[plugin_index + 1][EventHandler::profilerHook()].record(micros() - start);
+  return result;
+}
+
+}  // namespace hook_profiler
+}  // namespace kaleidoscope_internal
+
+#ifdef KALEIDOSCOPE_HOOK_PROFILING
+
+#define _HOOK_PROFILER_PLUGIN_NAME(PLUGIN) #PLUGIN "\0"
+#define _HOOK_PROFILER_COUNT_PLUGIN(PLUGIN) 0
+
+// Generates the tables of plugin names & timing statistics for the plugins
+// passed to `KALEIDOSCOPE_INIT_PLUGINS()`.
+#define _INIT_HOOK_PROFILER(...)                                              __NL__ \
+  namespace kaleidoscope_internal {                                           __NL__ \
+  namespace hook_profiler {                                                   __NL__ \
+  extern const char plugin_names[] PROGMEM =                                  __NL__ \
+    MAP(_HOOK_PROFILER_PLUGIN_NAME, __VA_ARGS__);                             __NL__ \
+  extern const uint8_t plugin_count =                                         __NL__ \
+    NUM_ARGS({MAP_LIST(_HOOK_PROFILER_COUNT_PLUGIN, __VA_ARGS__)});           __NL__ \
+  Stats hook_stats[NUM_ARGS({MAP_LIST(_HOOK_PROFILER_COUNT_PLUGIN,            __NL__ \
+                                      __VA_ARGS__)}) + 1][hook_count];        __NL__ \
+  void reset() {                                                              __NL__ \
+    memset(hook_stats, 0, sizeof(hook_stats));                                __NL__ \
+  }                                                                           __NL__ \
+  } /* namespace hook_profiler */                                             __NL__ \
+  } /* namespace kaleidoscope_internal */
+
+#define _PROFILE_HOOK(HOOK_NAME)                                              __NL__ \
+  kaleidoscope_internal::hook_profiler::HookTimer<                            __NL__ \
+    kaleidoscope_internal::hook_profiler::HookIds::HOOK_NAME> hook_timer__;
+
+#define _DECLARE_PROFILED_PLUGIN_INDEX                                        __NL__ \
+  uint8_t plugin_index__ = 0;
+
+#define _CALL_EVENT_HANDLER(PLUGIN)                                           __NL__ \
+  kaleidoscope_internal::hook_profiler::call<EventHandler__>(                 __NL__ \
+    plugin_index__++, PLUGIN, hook_args...)
+
+#else
+
+#define _INIT_HOOK_PROFILER(...)
+#define _PROFILE_HOOK(HOOK_NAME)
+#define _DECLARE_PROFILED_PLUGIN_INDEX
+#define _CALL_EVENT_HANDLER(PLUGIN) EventHandler__::call(PLUGIN, hook_args...)
+
+#endif
@@ -0,0 +1,107 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Filtering of key events by the keys plugins declared an interest in with
+// `KALEIDOSCOPE_KEY_INTEREST()` (see kaleidoscope/key_interest.h).
+//
+// The `call()` of each event handler class that `KALEIDOSCOPE_INIT_PLUGINS()`
+// generates asks `wants()` first. That is a constant `true` for the hooks that
+// aren't filtered, and for plugins without a declaration, so the compiler drops
+// the check for them, and otherwise the plugin's `isInterestedInKey()` of the
+// event's key, inlined.
+
+#pragma once
+
+#include "kaleidoscope/KeyEvent.h"        // for KeyEvent
+#include "kaleidoscope/event_handlers.h"  // for _FOR_EACH_EVENT_HANDLER
+#include "kaleidoscope/key_defs.h"        // for Key
+#include "kaleidoscope/key_interest.h"    // IWYU pragma: keep
+#include "kaleidoscope/macro_helpers.h"   // for __NL__
+
+namespace kaleidoscope_internal {
+namespace key_interest_filter {
+
+// Every hook has a flag, named after it, that is `false`...
+#define _DEFINE_UNFILTERED_HOOK(HOOK_NAME, ...)                         __NL__ \
+  static constexpr bool HOOK_NAME = false;
+
+struct UnfilteredHooks {
+  _FOR_EACH_EVENT_HANDLER(_DEFINE_UNFILTERED_HOOK)
+};
+
+#undef _DEFINE_UNFILTERED_HOOK
+
+// ...except for the ones that are only called for the keys a plugin wants,
+// whose flags hide those.
+struct FilteredHooks : UnfilteredHooks {
+  static constexpr bool onKeyswitchEvent = true;
+  static constexpr bool onKeyEvent       = true;
+  static constexpr bool onAddToReport    = true;
+};
+
+// Whether `_Plugin` declared the keys it's interested in
+template<typename _Plugin>
+struct DeclaresKeyInterest {
+  template<typename _T>
+  static constexpr bool test(decltype(&_T::isInterestedInKey)) {
+    return true;
+  }
+  template<typename _T>
+  static constexpr bool test(...) {
+    return false;
+  }
+
+  static constexpr bool value = test<_Plugin>(nullptr);
+};
+
+// The key the arguments of a filtered hook are about
+inline kaleidoscope::Key eventKey(const kaleidoscope::KeyEvent &event) {
+  return event.key;
+}
+inline kaleidoscope::Key eventKey(kaleidoscope::Key key) {
+  return key;
+}
+
+template<bool _filtered>
+struct Filter {
+  template<typename _Plugin, typename _Arg>
+  static bool wants(const _Arg &hook_arg) {
+    return _Plugin::isInterestedInKey(eventKey(hook_arg));
+  }
+};
+
+template<>
+struct Filter<false> {
+  template<typename _Plugin, typename... _Args>
+  static constexpr bool wants(const _Args &.../*hook_args*/) {
+    return true;
+  }
+};
+
+template<bool _hook_is_filtered, typename _Plugin, typename... _Args>
+inline bool wants(const _Args &...hook_args) {
+  typedef Filter<_hook_is_filtered && DeclaresKeyInterest<_Plugin>::value> PluginFilter;
+  return PluginFilter::template wants<_Plugin>(hook_args...);
+}
+
+}  // namespace key_interest_filter
+}  // namespace kaleidoscope_internal
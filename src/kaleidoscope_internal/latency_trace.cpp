@@ -0,0 +1,104 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope_internal/latency_trace.h"
+
+#include <Arduino.h>  // for micros
+#include <string.h>   // for memset
+
+#include "kaleidoscope/KeyEvent.h"         // for KeyEvent
+#include "kaleidoscope/keyswitch_state.h"  // for keyToggledOn
+
+namespace kaleidoscope_internal {
+namespace latency_trace {
+
+// This is replaced by `KALEIDOSCOPE_INIT_PLUGINS()` if the sketch is built with
+// `KALEIDOSCOPE_LATENCY_TRACING`.
+__attribute__((weak)) Trace *trace = nullptr;
+
+void detectedAt(uint32_t time) {
+  if (!enabled())
+    return;
+  trace->has_detection_time = true;
+  trace->detection_time     = time;
+}
+
+void clearDetectionTime() {
+  if (!enabled())
+    return;
+  trace->has_detection_time = false;
+}
+
+void stamp(const kaleidoscope::KeyEvent &event) {
+  if (!enabled())
+    return;
+
+  uint32_t time = trace->has_detection_time ? trace->detection_time : micros();
+
+  auto &entry          = trace->events[uint8_t(event.id()) % kPendingCapacity];
+  entry.pending        = true;
+  entry.id             = event.id();
+  entry.row            = event.addr.row();
+  entry.col            = event.addr.col();
+  entry.pressed        = keyToggledOn(event.state);
+  entry.detection_time = time;
+}
+
+void reportSent(const kaleidoscope::KeyEvent &event) {
+  if (!enabled())
+    return;
+
+  // Only the first report sent for an event counts. Events generated by plugins
+  // often reuse the id of the most recent physical event, so this also keeps
+  // those from adding bogus samples.
+  auto &entry = trace->events[uint8_t(event.id()) % kPendingCapacity];
+  if (!entry.pending || entry.id != event.id())
+    return;
+  entry.pending = false;
+
+  Sample &sample = trace->samples[trace->next_sample];
+  sample.row     = entry.row;
+  sample.col     = entry.col;
+  sample.pressed = entry.pressed;
+  sample.latency = micros() - entry.detection_time;
+
+  trace->next_sample = (trace->next_sample + 1) % kSampleCapacity;
+  if (trace->sample_count < kSampleCapacity)
+    ++trace->sample_count;
+}
+
+uint8_t sampleCount() {
+  return enabled() ? trace->sample_count : 0;
+}
+
+const Sample &sample(uint8_t n) {
+  uint8_t oldest = (trace->next_sample + kSampleCapacity - trace->sample_count) % kSampleCapacity;
+  return trace->samples[(oldest + n) % kSampleCapacity];
+}
+
+void reset() {
+  if (enabled())
+    memset(trace, 0, sizeof(*trace));
+}
+
+}  // namespace latency_trace
+}  // namespace kaleidoscope_internal
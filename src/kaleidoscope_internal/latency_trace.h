@@ -0,0 +1,136 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025 Keyboard.io, inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Optional tracing of the time from the detection of a keyswitch state change
+// to the sending of the keyboard report that reflects it.
+//
+// When `KALEIDOSCOPE_LATENCY_TRACING` is defined (either as a build flag, or in
+// the sketch before `Kaleidoscope.h` is included), `KALEIDOSCOPE_INIT_PLUGINS()`
+// provides the storage for the trace. Each physical key event gets stamped with
+// the time it was detected, keyed by its event id, so the stamp follows the
+// event through any plugin that delays it (as long as the plugin keeps the id,
+// which it must do for `KeyEventTracker` to work anyway). When the first
+// keyboard report for that event is sent, the elapsed time is recorded in a
+// ring buffer of samples. Without it, the weak definitions in latency_trace.cpp
+// leave the trace disabled, and all of the functions below do nothing.
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, int8_t, uint32_t
+
+#include "kaleidoscope/macro_helpers.h"  // for __NL__
+
+namespace kaleidoscope {
+struct KeyEvent;
+}  // namespace kaleidoscope
+
+namespace kaleidoscope_internal {
+namespace latency_trace {
+
+// The number of events that can be waiting for a report at once. This needs to
+// be larger than the number of events any plugin holds back (e.g. the Qukeys
+// event queue).
+constexpr uint8_t kPendingCapacity = 16;
+
+// The number of samples kept; older ones get overwritten by newer ones.
+constexpr uint8_t kSampleCapacity = 32;
+
+// The latency of one key event, in microseconds
+struct Sample {
+  uint8_t row;
+  uint8_t col;
+  bool pressed;
+  uint32_t latency;
+};
+
+struct Trace {
+  // Set by a keyscanner that detected keyswitch state changes earlier than it
+  // reports them (e.g. in an interrupt handler), and used for all of the events
+  // for those changes.
+  bool has_detection_time;
+  uint32_t detection_time;
+
+  // Physical events that haven't been reported yet, indexed by event id
+  struct {
+    bool pending;
+    int8_t id;  // KeyEventId
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+    uint32_t detection_time;
+  } events[kPendingCapacity];
+
+  Sample samples[kSampleCapacity];
+  uint8_t next_sample;
+  uint8_t sample_count;
+};
+
+// Points to the trace storage, or is `nullptr` if tracing is disabled.
+extern Trace *trace;
+
+inline bool enabled() {
+  return trace != nullptr;
+}
+
+// Tells the trace when the keyswitch state changes that are about to be handled
+// were detected, if that was before the events for them are created. Every
+// event stamped until the next call to `detectedAt()` or `clearDetectionTime()`
+// gets this time.
+void detectedAt(uint32_t time);
+
+// Goes back to stamping events with the time they are created.
+void clearDetectionTime();
+
+// Stamps a newly created physical key event with its detection time.
+void stamp(const kaleidoscope::KeyEvent &event);
+
+// Records the latency of an event once a keyboard report has been sent for it.
+void reportSent(const kaleidoscope::KeyEvent &event);
+
+// Returns the number of samples in the trace.
+uint8_t sampleCount();
+
+// Returns the `n`th sample, oldest first.
+const Sample &sample(uint8_t n);
+
+// Clears all samples, and forgets any pending events.
+void reset();
+
+}  // namespace latency_trace
+}  // namespace kaleidoscope_internal
+
+#ifdef KALEIDOSCOPE_LATENCY_TRACING
+
+// Provides the storage for the trace, replacing the weak `nullptr` default.
+#define _INIT_LATENCY_TRACE                                                   __NL__ \
+  namespace kaleidoscope_internal {                                           __NL__ \
+  namespace latency_trace {                                                   __NL__ \
+  static Trace trace_storage;                                                 __NL__ \
+  Trace *trace = &trace_storage;                                              __NL__ \
+  } /* namespace latency_trace */                                             __NL__ \
+  } /* namespace kaleidoscope_internal */
+
+#else
+
+#define _INIT_LATENCY_TRACE
+
+#endif
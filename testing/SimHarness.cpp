@@ -25,14 +25,11 @@ namespace kaleidoscope {
 namespace testing {
 
 void SimHarness::RunCycle() {
-  if (CycleTime() > 1) {
-    // We incrememnt the time before running the loop so that
-    // millisAtCycleStart ends up where we want it to
-    for (size_t i = 1; i < CycleTime(); i++) {
-      // The current millis implementation gets us 1 milli per call to millis.
-      millis();
-    }
-  }
+  // We increment the time before running the loop so that millisAtCycleStart
+  // ends up where we want it to. The loop's own call to `millis()` adds the
+  // last one.
+  if (CycleTime() > 1)
+    kaleidoscope::Device::advanceClock(CycleTime() - 1);
   kaleidoscope::Runtime.loop();
 }
 
@@ -44,6 +41,17 @@ void SimHarness::RunForMillis(size_t t) {
   auto start_time = kaleidoscope::Runtime.millisAtCycleStart();
   while (kaleidoscope::Runtime.millisAtCycleStart() - start_time < t) {
     RunCycle();
+    if (!FastForward())
+      continue;
+
+    uint32_t elapsed   = kaleidoscope::Runtime.millisAtCycleStart() - start_time;
+    uint32_t remaining = elapsed < t ? t - elapsed : 0;
+    uint32_t skip      = kaleidoscope::Runtime.millisUntilNextWake();
+    if (skip > remaining)
+      skip = remaining;
+    // Only skip ahead if the next cycle wouldn't have started by then anyway.
+    if (skip > CycleTime())
+      AdvanceTo(Now() + skip);
   }
 }
 
@@ -75,6 +83,32 @@ uint8_t SimHarness::CycleTime() const {
   return millis_per_cycle_;
 }
 
+uint32_t SimHarness::Now() const {
+  return kaleidoscope::Runtime.millisAtCycleStart();
+}
+
+void SimHarness::AdvanceTo(uint32_t time) {
+  // `RunCycle()` adds the cycle time on its own, so we stop short of that.
+  uint32_t target = time - CycleTime();
+  if (int32_t(target - Now()) <= 0)
+    return;
+  // Plugins may have read the clock since the cycle started, so we go by the
+  // clock itself rather than by the cycle start time.
+  kaleidoscope::Device::setClock(target);
+}
+
+void SimHarness::AdvanceBy(uint32_t millis) {
+  kaleidoscope::Device::advanceClock(millis);
+}
+
+void SimHarness::SetFastForward(bool enabled) {
+  fast_forward_ = enabled;
+}
+
+bool SimHarness::FastForward() const {
+  return fast_forward_;
+}
+
 // Serial support implementation
 void SimHarness::ProcessSerialInput() {
   // This will be called by RunCycle() to process any pending serial input
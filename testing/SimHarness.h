@@ -17,7 +17,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <cstdint>  // for uint8_t
+#include <cstdint>  // for uint8_t, uint32_t
 #include <vector>
 #include <string>
 
@@ -39,6 +39,21 @@ class SimHarness {
   void SetCycleTime(uint8_t millis);
   uint8_t CycleTime() const;
 
+  // Virtual clock control. `AdvanceTo()` sets the clock so that the next
+  // cycle starts at `time` (which must not be in the past), and `AdvanceBy()`
+  // moves it forward by `millis` on top of the usual cycle time. Neither runs
+  // any cycles.
+  uint32_t Now() const;
+  void AdvanceTo(uint32_t time);
+  void AdvanceBy(uint32_t millis);
+
+  // In fast-forward mode, `RunForMillis()` skips the cycles in which nothing
+  // is due: after each cycle, the clock jumps straight to the next armed
+  // deadline (see `Runtime.millisUntilNextWake()`), or to the end of the run if
+  // nothing is waiting. Pending key state changes are still processed in the first cycle.
+  void SetFastForward(bool enabled);
+  bool FastForward() const;
+
   // Serial support
   void ProcessSerialInput();
   void SendString(const std::string &str) {
@@ -58,6 +73,7 @@ class SimHarness {
 
  private:
   uint8_t millis_per_cycle_ = 1;
+  bool fast_forward_        = false;
 };
 
 }  // namespace testing
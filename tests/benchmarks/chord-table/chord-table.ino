@@ -0,0 +1,188 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-Chord.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_H, Key_I, Key_J, Key_K, Key_L, Key_M, Key_N,
+        Key_O, Key_P, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(Chord);
+
+void setup() {
+  Kaleidoscope.setup();
+
+  // Every pair of the keys A to P, and every run of three consecutive ones,
+  // with results cycling through the 24 keys of `results` in the testcase.
+  CHORDS(
+    CHORD(Key_A, Key_B), Key_1,
+    CHORD(Key_A, Key_C), Key_2,
+    CHORD(Key_A, Key_D), Key_3,
+    CHORD(Key_A, Key_E), Key_4,
+    CHORD(Key_A, Key_F), Key_5,
+    CHORD(Key_A, Key_G), Key_6,
+    CHORD(Key_A, Key_H), Key_7,
+    CHORD(Key_A, Key_I), Key_8,
+    CHORD(Key_A, Key_J), Key_9,
+    CHORD(Key_A, Key_K), Key_0,
+    CHORD(Key_A, Key_L), Key_F1,
+    CHORD(Key_A, Key_M), Key_F2,
+    CHORD(Key_A, Key_N), Key_F3,
+    CHORD(Key_A, Key_O), Key_F4,
+    CHORD(Key_A, Key_P), Key_F5,
+    CHORD(Key_B, Key_C), Key_F6,
+    CHORD(Key_B, Key_D), Key_F7,
+    CHORD(Key_B, Key_E), Key_F8,
+    CHORD(Key_B, Key_F), Key_F9,
+    CHORD(Key_B, Key_G), Key_F10,
+    CHORD(Key_B, Key_H), Key_F11,
+    CHORD(Key_B, Key_I), Key_F12,
+    CHORD(Key_B, Key_J), Key_Q,
+    CHORD(Key_B, Key_K), Key_R,
+    CHORD(Key_B, Key_L), Key_1,
+    CHORD(Key_B, Key_M), Key_2,
+    CHORD(Key_B, Key_N), Key_3,
+    CHORD(Key_B, Key_O), Key_4,
+    CHORD(Key_B, Key_P), Key_5,
+    CHORD(Key_C, Key_D), Key_6,
+    CHORD(Key_C, Key_E), Key_7,
+    CHORD(Key_C, Key_F), Key_8,
+    CHORD(Key_C, Key_G), Key_9,
+    CHORD(Key_C, Key_H), Key_0,
+    CHORD(Key_C, Key_I), Key_F1,
+    CHORD(Key_C, Key_J), Key_F2,
+    CHORD(Key_C, Key_K), Key_F3,
+    CHORD(Key_C, Key_L), Key_F4,
+    CHORD(Key_C, Key_M), Key_F5,
+    CHORD(Key_C, Key_N), Key_F6,
+    CHORD(Key_C, Key_O), Key_F7,
+    CHORD(Key_C, Key_P), Key_F8,
+    CHORD(Key_D, Key_E), Key_F9,
+    CHORD(Key_D, Key_F), Key_F10,
+    CHORD(Key_D, Key_G), Key_F11,
+    CHORD(Key_D, Key_H), Key_F12,
+    CHORD(Key_D, Key_I), Key_Q,
+    CHORD(Key_D, Key_J), Key_R,
+    CHORD(Key_D, Key_K), Key_1,
+    CHORD(Key_D, Key_L), Key_2,
+    CHORD(Key_D, Key_M), Key_3,
+    CHORD(Key_D, Key_N), Key_4,
+    CHORD(Key_D, Key_O), Key_5,
+    CHORD(Key_D, Key_P), Key_6,
+    CHORD(Key_E, Key_F), Key_7,
+    CHORD(Key_E, Key_G), Key_8,
+    CHORD(Key_E, Key_H), Key_9,
+    CHORD(Key_E, Key_I), Key_0,
+    CHORD(Key_E, Key_J), Key_F1,
+    CHORD(Key_E, Key_K), Key_F2,
+    CHORD(Key_E, Key_L), Key_F3,
+    CHORD(Key_E, Key_M), Key_F4,
+    CHORD(Key_E, Key_N), Key_F5,
+    CHORD(Key_E, Key_O), Key_F6,
+    CHORD(Key_E, Key_P), Key_F7,
+    CHORD(Key_F, Key_G), Key_F8,
+    CHORD(Key_F, Key_H), Key_F9,
+    CHORD(Key_F, Key_I), Key_F10,
+    CHORD(Key_F, Key_J), Key_F11,
+    CHORD(Key_F, Key_K), Key_F12,
+    CHORD(Key_F, Key_L), Key_Q,
+    CHORD(Key_F, Key_M), Key_R,
+    CHORD(Key_F, Key_N), Key_1,
+    CHORD(Key_F, Key_O), Key_2,
+    CHORD(Key_F, Key_P), Key_3,
+    CHORD(Key_G, Key_H), Key_4,
+    CHORD(Key_G, Key_I), Key_5,
+    CHORD(Key_G, Key_J), Key_6,
+    CHORD(Key_G, Key_K), Key_7,
+    CHORD(Key_G, Key_L), Key_8,
+    CHORD(Key_G, Key_M), Key_9,
+    CHORD(Key_G, Key_N), Key_0,
+    CHORD(Key_G, Key_O), Key_F1,
+    CHORD(Key_G, Key_P), Key_F2,
+    CHORD(Key_H, Key_I), Key_F3,
+    CHORD(Key_H, Key_J), Key_F4,
+    CHORD(Key_H, Key_K), Key_F5,
+    CHORD(Key_H, Key_L), Key_F6,
+    CHORD(Key_H, Key_M), Key_F7,
+    CHORD(Key_H, Key_N), Key_F8,
+    CHORD(Key_H, Key_O), Key_F9,
+    CHORD(Key_H, Key_P), Key_F10,
+    CHORD(Key_I, Key_J), Key_F11,
+    CHORD(Key_I, Key_K), Key_F12,
+    CHORD(Key_I, Key_L), Key_Q,
+    CHORD(Key_I, Key_M), Key_R,
+    CHORD(Key_I, Key_N), Key_1,
+    CHORD(Key_I, Key_O), Key_2,
+    CHORD(Key_I, Key_P), Key_3,
+    CHORD(Key_J, Key_K), Key_4,
+    CHORD(Key_J, Key_L), Key_5,
+    CHORD(Key_J, Key_M), Key_6,
+    CHORD(Key_J, Key_N), Key_7,
+    CHORD(Key_J, Key_O), Key_8,
+    CHORD(Key_J, Key_P), Key_9,
+    CHORD(Key_K, Key_L), Key_0,
+    CHORD(Key_K, Key_M), Key_F1,
+    CHORD(Key_K, Key_N), Key_F2,
+    CHORD(Key_K, Key_O), Key_F3,
+    CHORD(Key_K, Key_P), Key_F4,
+    CHORD(Key_L, Key_M), Key_F5,
+    CHORD(Key_L, Key_N), Key_F6,
+    CHORD(Key_L, Key_O), Key_F7,
+    CHORD(Key_L, Key_P), Key_F8,
+    CHORD(Key_M, Key_N), Key_F9,
+    CHORD(Key_M, Key_O), Key_F10,
+    CHORD(Key_M, Key_P), Key_F11,
+    CHORD(Key_N, Key_O), Key_F12,
+    CHORD(Key_N, Key_P), Key_Q,
+    CHORD(Key_O, Key_P), Key_R,
+    CHORD(Key_A, Key_B, Key_C), Key_1,
+    CHORD(Key_B, Key_C, Key_D), Key_2,
+    CHORD(Key_C, Key_D, Key_E), Key_3,
+    CHORD(Key_D, Key_E, Key_F), Key_4,
+    CHORD(Key_E, Key_F, Key_G), Key_5,
+    CHORD(Key_F, Key_G, Key_H), Key_6,
+    CHORD(Key_G, Key_H, Key_I), Key_7,
+    CHORD(Key_H, Key_I, Key_J), Key_8,
+    CHORD(Key_I, Key_J, Key_K), Key_9,
+    CHORD(Key_J, Key_K, Key_L), Key_0,
+    CHORD(Key_K, Key_L, Key_M), Key_F1,
+    CHORD(Key_L, Key_M, Key_N), Key_F2,
+    CHORD(Key_M, Key_N, Key_O), Key_F3,
+    CHORD(Key_N, Key_O, Key_P), Key_F4,
+  )
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -0,0 +1,120 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>     // for steady_clock, duration
+#include <set>        // for set
+#include <vector>     // for vector
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr int stroke_rounds = 20;
+
+// The keys A to P, in the order they appear in the keymap
+constexpr uint8_t chord_key_count = 16;
+
+// The results of the chords in the sketch, in order, wrapping around
+const Key results[] = {
+  Key_1, Key_2, Key_3, Key_4, Key_5, Key_6, Key_7, Key_8, Key_9, Key_0,
+  Key_F1, Key_F2, Key_F3, Key_F4, Key_F5, Key_F6, Key_F7, Key_F8, Key_F9,
+  Key_F10, Key_F11, Key_F12, Key_Q, Key_R,
+};
+
+struct Chord {
+  std::vector<KeyAddr> addrs;
+  Key result;
+};
+
+class ChordTable : public VirtualDeviceTest {
+ protected:
+  // The chords of the sketch: every pair of the chord keys, then every run of
+  // three consecutive ones.
+  static std::vector<Chord> chords() {
+    std::vector<Chord> chords;
+    auto add = [&](std::vector<uint8_t> keys) {
+      Chord chord;
+      for (uint8_t key : keys)
+        chord.addrs.push_back(KeyAddr(uint8_t(key / 7), uint8_t(key % 7)));
+      chord.result = results[chords.size() % (sizeof(results) / sizeof(results[0]))];
+      chords.push_back(chord);
+    };
+
+    for (uint8_t i = 0; i < chord_key_count; ++i)
+      for (uint8_t j = i + 1; j < chord_key_count; ++j)
+        add({i, j});
+    for (uint8_t i = 0; i + 2 < chord_key_count; ++i)
+      add({i, uint8_t(i + 1), uint8_t(i + 2)});
+    return chords;
+  }
+
+  // Presses all keys of the chord in one cycle, releases them in the next, and
+  // returns the keycodes of every keyboard report sent meanwhile.
+  std::set<uint8_t> stroke(const Chord &chord) {
+    std::set<uint8_t> keycodes;
+    auto collect = [&](std::unique_ptr<State> state) {
+      for (const auto &report : state->HIDReports()->Keyboard())
+        for (uint8_t keycode : report.ActiveKeycodes())
+          keycodes.insert(keycode);
+    };
+
+    for (KeyAddr addr : chord.addrs)
+      sim_.Press(addr);
+    collect(RunCycle());
+    for (KeyAddr addr : chord.addrs)
+      sim_.Release(addr);
+    collect(RunCycle());
+    return keycodes;
+  }
+};
+
+TEST_F(ChordTable, EveryChordResolves) {
+  std::vector<Chord> all = chords();
+  ASSERT_EQ(all.size(), 134);
+
+  for (const Chord &chord : all) {
+    std::set<uint8_t> keycodes = stroke(chord);
+    EXPECT_EQ(keycodes, std::set<uint8_t>{chord.result.getKeyCode()})
+      << "chord #" << (&chord - &all[0]);
+  }
+}
+
+TEST_F(ChordTable, StrokeTime) {
+  std::vector<Chord> all = chords();
+  stroke(all[0]);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < stroke_rounds; ++round)
+    for (const Chord &chord : all)
+      stroke(chord);
+  std::chrono::duration<double, std::micro> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << "Chord strokes, " << all.size() << " chords of "
+            << int(chord_key_count) << " keys:" << std::endl
+            << "  " << elapsed.count() / (stroke_rounds * all.size())
+            << " us per stroke" << std::endl;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
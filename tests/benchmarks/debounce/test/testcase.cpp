@@ -0,0 +1,295 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>  // for uint16_t, uint8_t
+#include <vector>    // for vector
+
+#include "kaleidoscope/driver/keyscanner/Debounce.h"  // for Asymmetric, Defer, EagerPress
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using namespace driver::keyscanner::debounce;
+
+typedef uint16_t RowState;
+
+constexpr uint8_t row_keys        = 16;
+constexpr int keystrokes_per_key = 200;
+
+// The debouncer the ATmega scanner had before the policies, for comparison
+class LegacyDebouncer {
+ public:
+  RowState debounce(RowState sample) {
+    RowState delta = sample ^ debounced_state_;
+    db1_           = (db1_ ^ db0_) & delta;
+    db0_           = ~db0_ & delta;
+    RowState changes = ~(~delta | db0_ | db1_);
+    debounced_state_ ^= changes;
+    return changes;
+  }
+  RowState state() const {
+    return debounced_state_;
+  }
+
+ private:
+  RowState db0_ = 0, db1_ = 0, debounced_state_ = 0;
+};
+
+class Random {
+ public:
+  explicit Random(uint32_t seed)
+    : state_(seed) {}
+  uint32_t next(uint32_t range) {
+    state_ = state_ * 1103515245 + 12345;
+    return (state_ >> 16) % range;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// A synthetic scan of a row of switches, one sample per key per scan. Every
+// key is pressed and released over and over, independently of the others: a
+// keystroke is some stable released scans, a press that bounces for a few
+// scans, a stable hold, and a release that bounces, too. A bounce never
+// reads the same for more than `max_bounce_run` scans in a row.
+struct Signal {
+  std::vector<RowState> scans;
+  // For each key, the scans at which its contact starts changing (the first
+  // bounce), and at which it changes for good
+  std::vector<std::vector<int>> starts;
+  std::vector<std::vector<int>> edges;
+  // Optional single-scan glitches, on otherwise stable lines
+  int glitches = 0;
+
+  Signal(uint32_t seed, uint8_t max_bounce_run, bool with_glitches = false) {
+    Random random(seed);
+    std::vector<std::vector<bool>> keys(row_keys);
+    starts.resize(row_keys);
+    edges.resize(row_keys);
+    for (uint8_t key = 0; key < row_keys; key++) {
+      std::vector<bool> &samples = keys[key];
+      for (int stroke = 0; stroke < keystrokes_per_key; stroke++) {
+        stable(samples, false, 10 + random.next(40), random, with_glitches);
+        starts[key].push_back(samples.size());
+        bounce(samples, true, random, max_bounce_run);
+        edges[key].push_back(samples.size());
+        stable(samples, true, 20 + random.next(80), random, with_glitches);
+        starts[key].push_back(samples.size());
+        bounce(samples, false, random, max_bounce_run);
+        edges[key].push_back(samples.size());
+      }
+      stable(samples, false, 20, random, false);
+    }
+
+    size_t length = 0;
+    for (const auto &samples : keys)
+      length = std::max(length, samples.size());
+    scans.assign(length, 0);
+    for (uint8_t key = 0; key < row_keys; key++) {
+      for (size_t scan = 0; scan < length; scan++) {
+        if (scan < keys[key].size() && keys[key][scan])
+          scans[scan] |= RowState(1) << key;
+      }
+    }
+  }
+
+ private:
+  void stable(std::vector<bool> &samples, bool state, int count, Random &random, bool with_glitches) {
+    for (int i = 0; i < count; i++) {
+      bool glitch = with_glitches && i > 2 && i < count - 2 && random.next(100) == 0;
+      if (glitch) {
+        glitches++;
+        samples.push_back(!state);
+        // Glitches are single scans, never two in a row.
+        i++;
+      }
+      samples.push_back(state);
+    }
+  }
+  // Bounces between the states, and ends just before `to` takes hold.
+  void bounce(std::vector<bool> &samples, bool to, Random &random, uint8_t max_run) {
+    int length = random.next(8);
+    bool state = to;
+    for (int i = 0; i < length;) {
+      int run = 1 + random.next(max_run);
+      for (int j = 0; j < run && i < length; j++, i++)
+        samples.push_back(state);
+      state = !state;
+    }
+    if (!samples.empty() && samples.back() == to)
+      samples.push_back(!to);
+  }
+};
+
+struct Result {
+  double press_latency   = 0;
+  double release_latency = 0;
+  int max_press_latency  = 0;
+  int false_toggles      = 0;
+  int missed             = 0;
+};
+
+// Runs a row debouncer over the signal, and matches the toggles it reports
+// with the edges of the keystrokes.
+template<typename Debouncer>
+Result measure(const Signal &signal) {
+  Debouncer debouncer;
+  std::vector<std::vector<int>> toggles(row_keys);
+  for (size_t scan = 0; scan < signal.scans.size(); scan++) {
+    RowState changes = debouncer.debounce(signal.scans[scan]);
+    for (uint8_t key = 0; key < row_keys; key++) {
+      if (changes & (RowState(1) << key))
+        toggles[key].push_back(scan);
+    }
+  }
+
+  Result result;
+  int presses = 0, releases = 0;
+  for (uint8_t key = 0; key < row_keys; key++) {
+    const std::vector<int> &edges = signal.edges[key];
+    if (toggles[key].size() != edges.size()) {
+      result.false_toggles += std::max<int>(0, toggles[key].size() - edges.size());
+      result.missed += std::max<int>(0, edges.size() - toggles[key].size());
+      continue;
+    }
+    for (size_t i = 0; i < edges.size(); i++) {
+      // The latency is measured from the first scan that saw the contact
+      // change, bounce or not.
+      int latency = toggles[key][i] - signal.starts[key][i];
+      if (i % 2 == 0) {
+        result.press_latency += latency;
+        result.max_press_latency = std::max(result.max_press_latency, latency);
+        presses++;
+      } else {
+        result.release_latency += latency;
+        releases++;
+      }
+    }
+  }
+  result.press_latency /= std::max(presses, 1);
+  result.release_latency /= std::max(releases, 1);
+  return result;
+}
+
+void report(const char *name, const Result &result) {
+  std::cout << "  " << name << ": press latency " << result.press_latency
+            << " scans (max " << result.max_press_latency << "), release latency "
+            << result.release_latency << " scans, " << result.false_toggles
+            << " false toggles, " << result.missed << " missed" << std::endl;
+}
+
+template<uint8_t _press, uint8_t _release>
+using RowOf = typename Asymmetric<_press, _release>::template Row<RowState>;
+
+TEST(Debounce, DeferMatchesLegacyDebouncer) {
+  Signal signal(1, 5, true);
+  LegacyDebouncer legacy;
+  Defer<4>::Row<RowState> debouncer;
+  for (RowState scan : signal.scans) {
+    ASSERT_EQ(debouncer.debounce(scan), legacy.debounce(scan));
+    ASSERT_EQ(debouncer.state(), legacy.state());
+  }
+}
+
+TEST(Debounce, ThresholdsOnCleanSignal) {
+  Defer<3>::Row<RowState> defer;
+  EagerPress<5>::Row<RowState> eager;
+  RowOf<2, 6> asymmetric;
+
+  // A clean press of key 3, and its release after 10 scans
+  std::vector<int> defer_toggles, eager_toggles, asymmetric_toggles;
+  for (int scan = 0; scan < 30; scan++) {
+    RowState sample = (scan >= 5 && scan < 15) ? 0x0008 : 0;
+    if (defer.debounce(sample))
+      defer_toggles.push_back(scan);
+    if (eager.debounce(sample))
+      eager_toggles.push_back(scan);
+    if (asymmetric.debounce(sample))
+      asymmetric_toggles.push_back(scan);
+  }
+  EXPECT_EQ(defer_toggles, std::vector<int>({7, 17}));
+  EXPECT_EQ(eager_toggles, std::vector<int>({5, 19}));
+  EXPECT_EQ(asymmetric_toggles, std::vector<int>({6, 20}));
+}
+
+TEST(Debounce, RevertRetriesAfterAnotherThreshold) {
+  Defer<2>::Row<RowState> debouncer;
+  EXPECT_EQ(debouncer.debounce(0x0001), 0);
+  EXPECT_EQ(debouncer.debounce(0x0001), 0x0001);
+  debouncer.revert(0x0001);
+  EXPECT_EQ(debouncer.state(), 0);
+  EXPECT_EQ(debouncer.debounce(0x0001), 0);
+  EXPECT_EQ(debouncer.debounce(0x0001), 0x0001);
+}
+
+TEST(Debounce, BouncySignals) {
+  // Bounces no longer than two scans at a time
+  Signal signal(2, 2);
+
+  Result defer4 = measure<Defer<4>::Row<RowState>>(signal);
+  Result defer3 = measure<Defer<3>::Row<RowState>>(signal);
+  Result eager  = measure<EagerPress<4>::Row<RowState>>(signal);
+  Result asym   = measure<RowOf<2, 4>>(signal);
+  Result legacy = measure<LegacyDebouncer>(signal);
+
+  std::cout << row_keys * keystrokes_per_key << " bouncy keystrokes:" << std::endl;
+  report("legacy (4 scans)  ", legacy);
+  report("Defer<4>          ", defer4);
+  report("Defer<3>          ", defer3);
+  report("EagerPress<4>     ", eager);
+  report("Asymmetric<2, 4>  ", asym);
+
+  for (const Result &result : {defer4, defer3, eager, asym}) {
+    EXPECT_EQ(result.false_toggles, 0);
+    EXPECT_EQ(result.missed, 0);
+  }
+  EXPECT_EQ(eager.max_press_latency, 0);
+  EXPECT_LT(eager.press_latency, defer4.press_latency);
+  EXPECT_LT(asym.press_latency, defer4.press_latency);
+  EXPECT_EQ(defer4.press_latency, legacy.press_latency);
+}
+
+TEST(Debounce, GlitchySignals) {
+  Signal signal(3, 2, true);
+  ASSERT_GT(signal.glitches, 0);
+
+  Result defer4 = measure<Defer<4>::Row<RowState>>(signal);
+  Result eager  = measure<EagerPress<4>::Row<RowState>>(signal);
+  Result asym   = measure<RowOf<2, 4>>(signal);
+
+  std::cout << row_keys * keystrokes_per_key << " bouncy keystrokes, with "
+            << signal.glitches << " glitches:" << std::endl;
+  report("Defer<4>          ", defer4);
+  report("EagerPress<4>     ", eager);
+  report("Asymmetric<2, 4>  ", asym);
+
+  // Deferred presses filter out glitches, eager ones don't.
+  EXPECT_EQ(defer4.false_toggles + defer4.missed, 0);
+  EXPECT_EQ(asym.false_toggles + asym.missed, 0);
+  EXPECT_GT(eager.false_toggles, 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
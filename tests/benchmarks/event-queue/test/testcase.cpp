@@ -0,0 +1,181 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>  // for steady_clock, duration
+
+#include "kaleidoscope/KeyAddrEventQueue.h"  // for KeyAddrEventQueue
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr uint8_t queue_capacity = 32;
+constexpr int drain_rounds       = 20000;
+
+// The queue as it was before it became a ring buffer, which moves every entry
+// after the one removed, for comparison.
+template<uint8_t _capacity, typename _Bitfield, typename _Timestamp = uint16_t>
+class ShiftingEventQueue {
+ public:
+  uint8_t length() const {
+    return length_;
+  }
+  KeyAddr addr(uint8_t index) const {
+    return addrs_[index];
+  }
+  void append(const KeyEvent &event) {
+    event_ids_[length_]  = event.id();
+    addrs_[length_]      = event.addr;
+    timestamps_[length_] = Runtime.millisAtCycleStart();
+    bitWrite(release_event_bits_, length_, keyToggledOff(event.state));
+    ++length_;
+  }
+  void shift() {
+    if (length_ == 0)
+      return;
+    --length_;
+    for (uint8_t i{0}; i < length_; ++i) {
+      event_ids_[i]  = event_ids_[i + 1];
+      addrs_[i]      = addrs_[i + 1];
+      timestamps_[i] = timestamps_[i + 1];
+    }
+    release_event_bits_ >>= 1;
+  }
+
+ private:
+  uint8_t length_{0};
+  KeyEventId event_ids_[_capacity];
+  KeyAddr addrs_[_capacity];
+  _Timestamp timestamps_[_capacity];
+  _Bitfield release_event_bits_;
+};
+
+KeyEvent press(uint8_t n) {
+  return KeyEvent::next(KeyAddr(n), IS_PRESSED);
+}
+
+KeyEvent release(uint8_t n) {
+  return KeyEvent::next(KeyAddr(n), WAS_PRESSED);
+}
+
+class EventQueue : public VirtualDeviceTest {
+ protected:
+  // Fills the queue, then shifts the events out one at a time, the way plugins
+  // drain their queues, and returns the time per event.
+  template<typename Queue>
+  static double drainTime() {
+    Queue queue;
+    uint32_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < drain_rounds; ++round) {
+      for (uint8_t i = 0; i < queue_capacity; ++i)
+        queue.append(press(i));
+      while (queue.length() > 0) {
+        checksum += queue.addr(0).toInt();
+        queue.shift();
+      }
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    // Keeps the compiler from dropping the loop.
+    EXPECT_EQ(checksum, drain_rounds * (queue_capacity * (queue_capacity - 1) / 2));
+    return elapsed.count() / (drain_rounds * queue_capacity);
+  }
+};
+
+TEST_F(EventQueue, WrapsAround) {
+  KeyAddrEventQueue<4> queue;
+  for (uint8_t i = 0; i < 4; ++i)
+    queue.append(press(i));
+  EXPECT_TRUE(queue.isFull());
+
+  queue.shift();
+  queue.shift();
+  queue.append(release(4));
+  queue.append(press(5));
+  ASSERT_EQ(queue.length(), 4);
+
+  EXPECT_EQ(queue.addr(0), KeyAddr(uint8_t(2)));
+  EXPECT_EQ(queue.addr(1), KeyAddr(uint8_t(3)));
+  EXPECT_EQ(queue.addr(2), KeyAddr(uint8_t(4)));
+  EXPECT_EQ(queue.addr(3), KeyAddr(uint8_t(5)));
+  EXPECT_TRUE(queue.isPress(1));
+  EXPECT_TRUE(queue.isRelease(2));
+  EXPECT_TRUE(queue.isPress(3));
+  EXPECT_EQ(KeyEventId(queue.id(3) - queue.id(0)), 3);
+}
+
+TEST_F(EventQueue, RemoveFromMiddle) {
+  KeyAddrEventQueue<8> queue;
+  for (uint8_t i = 0; i < 6; ++i)
+    queue.append(i % 2 ? release(i) : press(i));
+
+  // One near the head, and one near the tail
+  queue.remove(1);
+  queue.remove(3);
+  ASSERT_EQ(queue.length(), 4);
+
+  const uint8_t remaining[] = {0, 2, 3, 5};
+  for (uint8_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(queue.addr(i), KeyAddr(remaining[i]));
+    EXPECT_EQ(queue.isRelease(i), remaining[i] % 2 == 1);
+  }
+}
+
+TEST_F(EventQueue, ShiftMovesIds) {
+  KeyAddrEventQueue<8> queue;
+  KeyEventId third;
+  for (uint8_t i = 0; i < 5; ++i) {
+    KeyEvent event = press(i);
+    if (i == 2)
+      third = event.id();
+    queue.append(event);
+  }
+
+  queue.shift(2);
+  ASSERT_EQ(queue.length(), 3);
+  EXPECT_EQ(queue.id(0), third);
+  EXPECT_EQ(queue.addr(0), KeyAddr(uint8_t(2)));
+}
+
+TEST_F(EventQueue, CustomTimestamps) {
+  KeyAddrEventQueue<queue_capacity, uint8_t, uint32_t> queue;
+  queue.append(press(0), 100000);
+  queue.append(press(1), 4000000000UL);
+  EXPECT_EQ(queue.timestamp(0), 100000UL);
+  EXPECT_EQ(queue.timestamp(1), 4000000000UL);
+}
+
+TEST_F(EventQueue, DrainTime) {
+  double shifting_time = drainTime<ShiftingEventQueue<queue_capacity, uint32_t>>();
+  double ring_time     = drainTime<KeyAddrEventQueue<queue_capacity>>();
+
+  std::cout << "Draining a queue of " << int(queue_capacity) << " events:" << std::endl
+            << "  shifting:    " << shifting_time << " ns per event" << std::endl
+            << "  ring buffer: " << ring_time << " ns per event" << std::endl;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,264 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>  // for max
+#include <memory>     // for unique_ptr
+#include <string.h>   // for memset
+#include <vector>     // for vector
+
+#include "kaleidoscope/driver/storage/FlashJournal.h"  // for FlashJournal, FlashJournalProps
+#include "kaleidoscope/driver/storage/VirtualFlash.h"  // for VirtualFlash
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::storage::FlashJournal;
+using driver::storage::FlashJournalProps;
+using driver::storage::VirtualFlash;
+
+constexpr uint16_t storage_length = 4096;
+constexpr int commit_count        = 2000;
+
+struct TestFlashJournalProps : FlashJournalProps {
+  static constexpr uint16_t length     = storage_length;
+  static constexpr uint16_t bank_pages = 2;
+  typedef VirtualFlash<4096, 2 * bank_pages> Flash;
+};
+typedef FlashJournal<TestFlashJournalProps> Journal;
+typedef TestFlashJournalProps::Flash Flash;
+
+// The way `NRF52Flash` writes to flash, for comparison: every page that
+// changed is erased, and programmed again in full.
+class PageRewriteStorage {
+ public:
+  PageRewriteStorage() {
+    memset(image_, 0xff, sizeof(image_));
+  }
+  void write(uint16_t offset, uint8_t value) {
+    if (image_[offset] != value) {
+      image_[offset] = value;
+      dirty_[offset / Flash::page_size] = true;
+    }
+  }
+  void commit() {
+    for (uint16_t page = 0; page < page_count; page++) {
+      if (!dirty_[page])
+        continue;
+      flash_.erasePage(page);
+      flash_.program(page * Flash::page_size, image_ + page * Flash::page_size, Flash::page_size);
+      dirty_[page] = false;
+    }
+  }
+  Flash &flash() {
+    return flash_;
+  }
+
+ private:
+  static constexpr uint16_t page_count = storage_length / Flash::page_size;
+  Flash flash_;
+  uint8_t image_[storage_length];
+  bool dirty_[page_count] = {};
+};
+
+// A small settings change, at a pseudo-random place: the kind of write a
+// keymap or LED theme edit does.
+class Workload {
+ public:
+  uint16_t offset() {
+    return next() % (storage_length - 1);
+  }
+  uint8_t value() {
+    return next();
+  }
+
+ private:
+  uint32_t state_ = 1;
+  uint32_t next() {
+    state_ = state_ * 1103515245 + 12345;
+    return state_ >> 16;
+  }
+};
+
+class FlashJournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    journal_.reset(new Journal);
+    journal_->setup();
+    model_.assign(storage_length, 0xff);
+  }
+
+  void write(uint16_t offset, uint8_t value) {
+    journal_->update(offset, value);
+    model_[offset] = value;
+  }
+
+  // Simulates a reset: a new journal loads its image from the same flash.
+  void reload() {
+    std::unique_ptr<Journal> journal(new Journal);
+    journal->flash() = journal_->flash();
+    journal->setup();
+    journal_.swap(journal);
+  }
+
+  void expectImageMatchesModel() {
+    for (uint16_t offset = 0; offset < storage_length; offset++)
+      ASSERT_EQ(journal_->read(offset), model_[offset]) << "at offset " << offset;
+  }
+
+  std::unique_ptr<Journal> journal_;
+  std::vector<uint8_t> model_;
+};
+
+TEST_F(FlashJournalTest, ChangesSurviveReload) {
+  write(0, 0x12);
+  write(100, 0x34);
+  journal_->commit();
+  uint16_t value = 0xabcd;
+  journal_->put(2000, value);
+  model_[2000] = 0xcd;
+  model_[2001] = 0xab;
+  journal_->commit();
+
+  reload();
+  expectImageMatchesModel();
+  EXPECT_EQ(journal_->get(2000, value), 0xabcd);
+  EXPECT_FALSE(journal_->isSliceUninitialized(0, 1));
+  EXPECT_TRUE(journal_->isSliceUninitialized(1, 99));
+  EXPECT_EQ(journal_->flash().programViolations(), 0);
+}
+
+TEST_F(FlashJournalTest, ChangesSurviveCompactions) {
+  Workload workload;
+  for (int i = 0; i < commit_count; i++) {
+    write(workload.offset(), workload.value());
+    journal_->commit();
+    journal_->betweenCycles();
+    if (i % 250 == 0) {
+      reload();
+      expectImageMatchesModel();
+    }
+  }
+  reload();
+  expectImageMatchesModel();
+
+  // The journal was compacted several times, wearing both banks evenly.
+  const Flash &flash = journal_->flash();
+  EXPECT_GT(flash.eraseCount(0), 5);
+  EXPECT_LE(flash.maxEraseCount() - flash.eraseCount(0), 1);
+  EXPECT_EQ(flash.programViolations(), 0);
+}
+
+TEST_F(FlashJournalTest, TornRecordIsIgnored) {
+  write(10, 0x01);
+  journal_->commit();
+  Flash before = journal_->flash();
+  journal_->update(10, 0x02);
+  journal_->commit();
+
+  // Lose the second half of what the last commit programmed, as if power
+  // was cut halfway through.
+  std::vector<uint32_t> programmed;
+  uint8_t *data = journal_->flash().data();
+  for (uint32_t i = 0; i < Flash::page_size * Flash::page_count; i++) {
+    if (data[i] != before.data()[i])
+      programmed.push_back(i);
+  }
+  ASSERT_FALSE(programmed.empty());
+  for (size_t i = programmed.size() / 2; i < programmed.size(); i++)
+    data[programmed[i]] = 0xff;
+
+  reload();
+  expectImageMatchesModel();
+
+  // Nothing can be appended after the torn record, but later commits still
+  // work, in a compacted bank.
+  write(10, 0x03);
+  write(20, 0x04);
+  journal_->commit();
+  reload();
+  expectImageMatchesModel();
+  EXPECT_EQ(journal_->flash().programViolations(), 0);
+}
+
+TEST_F(FlashJournalTest, EraseClearsEverything) {
+  write(0, 0x12);
+  write(storage_length - 1, 0x34);
+  journal_->commit();
+  journal_->erase();
+  reload();
+  EXPECT_TRUE(journal_->isSliceUninitialized(0, storage_length));
+  EXPECT_EQ(journal_->journalUsed(), 0);
+}
+
+TEST_F(FlashJournalTest, CompareWithPageRewrite) {
+  // A commit after every change, as plugins do, with a few cycles in between
+  Workload workload;
+  PageRewriteStorage baseline;
+  uint64_t baseline_max_latency = 0;
+  for (int i = 0; i < commit_count; i++) {
+    uint64_t start = baseline.flash().busyMicros();
+    baseline.write(workload.offset(), workload.value());
+    baseline.commit();
+    baseline_max_latency = std::max(baseline_max_latency, baseline.flash().busyMicros() - start);
+  }
+
+  // The first commit sets up a bank.
+  write(0, 0);
+  journal_->commit();
+  journal_->flash().resetStats();
+
+  workload                     = Workload();
+  uint64_t journal_max_latency = 0;
+  for (int i = 0; i < commit_count; i++) {
+    uint64_t start = journal_->flash().busyMicros();
+    write(workload.offset(), workload.value());
+    journal_->commit();
+    journal_max_latency = std::max(journal_max_latency, journal_->flash().busyMicros() - start);
+    for (int cycle = 0; cycle < 4; cycle++)
+      journal_->betweenCycles();
+  }
+  reload();
+  expectImageMatchesModel();
+
+  const Flash &flash = journal_->flash();
+  std::cout << commit_count << " commits of a one byte change, "
+            << storage_length << " bytes of storage:" << std::endl
+            << "  page rewrite: " << baseline.flash().totalEraseCount() << " page erases, at most "
+            << baseline.flash().maxEraseCount() << " per page, "
+            << baseline.flash().busyMicros() / commit_count << " us per commit, "
+            << baseline_max_latency << " us at most" << std::endl
+            << "  journal:      " << flash.totalEraseCount() << " page erases, at most "
+            << flash.maxEraseCount() << " per page, "
+            << flash.busyMicros() / commit_count << " us of flash time per commit, "
+            << journal_max_latency << " us of it in commit() at most" << std::endl;
+
+  // Erases happen in the background, one page per cycle, never in commit().
+  uint32_t page_erase_micros = Flash::page_erase_micros;
+  EXPECT_LT(journal_max_latency, page_erase_micros);
+  EXPECT_LT(flash.totalEraseCount() * 10, baseline.flash().totalEraseCount());
+  EXPECT_EQ(flash.programViolations(), 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
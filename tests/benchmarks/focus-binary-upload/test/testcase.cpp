@@ -0,0 +1,247 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>  // for copy
+#include <chrono>     // for steady_clock, duration
+#include <sstream>    // for istringstream, ostringstream
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <Kaleidoscope-FocusSerial.h>  // for FocusSerial
+
+#include "kaleidoscope/util/crc16.h"  // for _crc16_update
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using plugin::FocusSerial;
+
+constexpr uint8_t num_layers = 6;
+constexpr int upload_count   = 20;
+
+class FocusBinaryUpload : public VirtualDeviceTest {
+ protected:
+  // A keymap with a different key in every position of every layer
+  static std::vector<uint16_t> testKeymap(uint16_t seed) {
+    std::vector<uint16_t> keys;
+    for (uint16_t i = 0; i < num_layers * KeyAddr::upper_limit; ++i)
+      keys.push_back((seed + i * 37) & 0x3fff);
+    return keys;
+  }
+
+  static std::string textUpload(const std::vector<uint16_t> &keys) {
+    std::ostringstream command;
+    command << "keymap.custom";
+    for (uint16_t key : keys)
+      command << " " << key;
+    command << "\n";
+    return command.str();
+  }
+
+  static std::string frame(const std::string &payload) {
+    uint16_t crc = _crc16_update(0xffff, payload.size());
+    for (char c : payload)
+      crc = _crc16_update(crc, c);
+
+    std::string result;
+    result += char(FocusSerial::FRAME_START);
+    result += char(payload.size());
+    result += payload;
+    result += char(crc & 0xff);
+    result += char(crc >> 8);
+    return result;
+  }
+
+  // The keys in storage order (flags, then keycode), in frames of
+  // `frame_size` bytes.
+  static std::vector<std::string> frames(const std::vector<uint16_t> &keys,
+                                         size_t frame_size = FocusSerial::MAX_FRAME_SIZE) {
+    std::string bytes;
+    for (uint16_t key : keys) {
+      bytes += char(key >> 8);
+      bytes += char(key & 0xff);
+    }
+
+    std::vector<std::string> result;
+    for (size_t i = 0; i < bytes.size(); i += frame_size)
+      result.push_back(frame(bytes.substr(i, frame_size)));
+    return result;
+  }
+
+  static std::string binaryUpload(const std::vector<std::string> &frames) {
+    std::string command = "keymap.custom ";
+    for (const std::string &frame : frames)
+      command += frame;
+    command += "\n";
+    return command;
+  }
+
+  std::vector<uint16_t> customKeymap() {
+    std::istringstream response(sim_.SendFocusCommand("keymap.custom"));
+    std::vector<uint16_t> keys;
+    for (uint16_t key; response >> key;)
+      keys.push_back(key);
+    return keys;
+  }
+};
+
+TEST_F(FocusBinaryUpload, MatchesTextUpload) {
+  std::vector<uint16_t> keys = testKeymap(1);
+  std::string response       = sim_.SendFocusCommand(binaryUpload(frames(keys, 50)));
+  EXPECT_EQ(response, std::to_string(keys.size() * 2) + " ");
+  EXPECT_EQ(customKeymap(), keys);
+
+  keys = testKeymap(2);
+  sim_.SendFocusCommand(textUpload(keys));
+  EXPECT_EQ(customKeymap(), keys);
+
+  // Keymap lookups see the new keys too. (Layer 0 is the one in PROGMEM.)
+  EXPECT_EQ(Layer.getKey(1, KeyAddr(uint8_t(3))).getRaw(), keys[3]);
+}
+
+TEST_F(FocusBinaryUpload, CorruptFrameIsRejected) {
+  std::vector<uint16_t> old_keys = testKeymap(3);
+  sim_.SendFocusCommand(textUpload(old_keys));
+
+  std::vector<uint16_t> keys        = testKeymap(4);
+  std::vector<std::string> uploaded = frames(keys);
+  // Flip a bit in the payload of the third frame.
+  uploaded[2][5] ^= 0x10;
+
+  std::string response = sim_.SendFocusCommand(binaryUpload(uploaded));
+  EXPECT_EQ(response, std::to_string(2 * FocusSerial::MAX_FRAME_SIZE) + " ");
+
+  // The first two frames are stored, and nothing after them.
+  std::vector<uint16_t> expected = old_keys;
+  std::copy(keys.begin(), keys.begin() + FocusSerial::MAX_FRAME_SIZE, expected.begin());
+  EXPECT_EQ(customKeymap(), expected);
+
+  // The rest of the frames were skipped, not parsed as commands.
+  EXPECT_EQ(sim_.GetSerialOutputAsString(), "");
+}
+
+TEST_F(FocusBinaryUpload, CorruptLengthIsRejected) {
+  std::vector<uint16_t> old_keys = testKeymap(8);
+  sim_.SendFocusCommand(textUpload(old_keys));
+
+  std::vector<uint16_t> keys        = testKeymap(9);
+  std::vector<std::string> uploaded = frames(keys);
+  // Make the third frame claim to be shorter than it is, so that its CRC is
+  // read from the middle of its payload, and what's left of it doesn't start
+  // like a frame. The payload holds newlines, too.
+  uploaded[2][1] = 10;
+  uploaded[2][8] = '\n';
+
+  std::string response = sim_.SendFocusCommand(binaryUpload(uploaded));
+  EXPECT_EQ(response, std::to_string(2 * FocusSerial::MAX_FRAME_SIZE) + " ");
+
+  std::vector<uint16_t> expected = old_keys;
+  std::copy(keys.begin(), keys.begin() + FocusSerial::MAX_FRAME_SIZE, expected.begin());
+  EXPECT_EQ(customKeymap(), expected);
+  // Nothing of the rest of the request was taken for a command.
+  EXPECT_EQ(sim_.GetSerialOutputAsString(), "");
+
+  // The next upload is read from its start.
+  response = sim_.SendFocusCommand(binaryUpload(frames(keys)));
+  EXPECT_EQ(response, std::to_string(keys.size() * 2) + " ");
+  EXPECT_EQ(customKeymap(), keys);
+}
+
+TEST_F(FocusBinaryUpload, LostStartByte) {
+  std::vector<uint16_t> keys        = testKeymap(10);
+  std::vector<std::string> uploaded = frames(keys);
+  uploaded[1][0] = 0;
+  uploaded[1][4] = '\n';
+
+  std::string response = sim_.SendFocusCommand(binaryUpload(uploaded));
+  EXPECT_EQ(response, std::to_string(FocusSerial::MAX_FRAME_SIZE) + " ");
+  EXPECT_EQ(sim_.GetSerialOutputAsString(), "");
+}
+
+TEST_F(FocusBinaryUpload, TruncatedUpload) {
+  std::vector<uint16_t> keys        = testKeymap(11);
+  std::vector<std::string> uploaded = frames(keys);
+  std::string command               = binaryUpload(uploaded);
+  // Cut the request short in the middle of the third frame.
+  command.resize(command.find(uploaded[2]) + 20);
+  sim_.SendString(command);
+
+  std::string response;
+  for (int cycles = 0; cycles < 100 && !SimHarness::IsFocusResponse(response); ++cycles) {
+    RunCycle();
+    response = sim_.GetSerialOutputAsString();
+  }
+  EXPECT_EQ(SimHarness::StripFocusTerminator(response),
+            std::to_string(2 * FocusSerial::MAX_FRAME_SIZE) + " ");
+  EXPECT_EQ(sim_.GetSerialOutputAsString(), "");
+
+  response = sim_.SendFocusCommand(binaryUpload(uploaded));
+  EXPECT_EQ(response, std::to_string(keys.size() * 2) + " ");
+  EXPECT_EQ(customKeymap(), keys);
+}
+
+TEST_F(FocusBinaryUpload, UploadTooLarge) {
+  std::vector<uint16_t> keys = testKeymap(5);
+  keys.push_back(0x1234);
+
+  std::string response = sim_.SendFocusCommand(binaryUpload(frames(keys)));
+  EXPECT_EQ(response, std::to_string((keys.size() - 1) * 2) + " ");
+  keys.pop_back();
+  EXPECT_EQ(customKeymap(), keys);
+}
+
+TEST_F(FocusBinaryUpload, RoundTripTime) {
+  std::vector<uint16_t> keys = testKeymap(6);
+  std::string text           = textUpload(keys);
+  std::string binary         = binaryUpload(frames(keys));
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < upload_count; ++i)
+    sim_.SendFocusCommand(text);
+  std::chrono::duration<double, std::micro> text_time =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(customKeymap(), keys);
+
+  keys   = testKeymap(7);
+  binary = binaryUpload(frames(keys));
+  start  = std::chrono::steady_clock::now();
+  for (int i = 0; i < upload_count; ++i)
+    sim_.SendFocusCommand(binary);
+  std::chrono::duration<double, std::micro> binary_time =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(customKeymap(), keys);
+
+  std::cout << "keymap.custom upload, " << int(num_layers) << " layers of "
+            << int(KeyAddr::upper_limit) << " keys:" << std::endl
+            << "  text:   " << text.size() << " bytes, "
+            << text_time.count() / upload_count << " us round trip" << std::endl
+            << "  binary: " << binary.size() << " bytes, "
+            << binary_time.count() / upload_count << " us round trip" << std::endl;
+
+  // Two bytes per key, plus four per frame, instead of up to six per key.
+  EXPECT_LT(binary.size() * 2, text.size());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
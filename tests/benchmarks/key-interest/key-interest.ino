@@ -0,0 +1,131 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2020  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-Ranges.h>
+
+// Like Macros and most other plugins that have keys of their own: each of
+// these handles a range of eight keys, and ignores all others. Their handlers
+// are not inlined, like those of plugins in a library of their own. They count
+// how often they were called, and how often for one of their keys.
+uint32_t range_plugin_calls[29];
+uint32_t range_plugin_hits[29];
+
+template<uint8_t _n>
+class RangePlugin : public kaleidoscope::Plugin {
+ public:
+  static constexpr uint16_t first = kaleidoscope::ranges::SAFE_START + 8 * _n;
+  static constexpr uint16_t last  = first + 7;
+
+  KALEIDOSCOPE_KEY_INTEREST(kaleidoscope::keyRange(first, last))
+
+  __attribute__((noinline)) kaleidoscope::EventHandlerResult onKeyEvent(KeyEvent &event) {
+    ++range_plugin_calls[_n];
+    if (event.key < first || event.key > last)
+      return kaleidoscope::EventHandlerResult::OK;
+    ++range_plugin_hits[_n];
+    return kaleidoscope::EventHandlerResult::OK;
+  }
+
+  __attribute__((noinline)) kaleidoscope::EventHandlerResult onAddToReport(Key key) {
+    ++range_plugin_calls[_n];
+    if (key < first || key > last)
+      return kaleidoscope::EventHandlerResult::OK;
+    ++range_plugin_hits[_n];
+    return kaleidoscope::EventHandlerResult::OK;
+  }
+};
+
+// A plugin that wants to see every key, and doesn't declare any interest.
+uint32_t watcher_calls;
+
+class Watcher : public kaleidoscope::Plugin {
+ public:
+  __attribute__((noinline)) kaleidoscope::EventHandlerResult onKeyEvent(KeyEvent & /*event*/) {
+    ++watcher_calls;
+    return kaleidoscope::EventHandlerResult::OK;
+  }
+};
+
+// clang-format off
+#define RANGE_PLUGINS(X)                                                \
+  X(0)  X(1)  X(2)  X(3)  X(4)  X(5)  X(6)  X(7)  X(8)  X(9)            \
+  X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19)           \
+  X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28)
+// clang-format on
+
+#define DEFINE_RANGE_PLUGIN(N) RangePlugin<N> rangePlugin##N;
+RANGE_PLUGINS(DEFINE_RANGE_PLUGIN)
+Watcher watcher;
+
+// *INDENT-OFF*
+
+KEYMAPS(
+  [0] = KEYMAP_STACKED
+  (
+    Key_A ,Key(RangePlugin<5>::first + 3) ,XXX ,XXX ,XXX ,XXX ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+          ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+  )
+) // KEYMAPS(
+
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(
+  rangePlugin0, rangePlugin1, rangePlugin2, rangePlugin3, rangePlugin4,
+  rangePlugin5, rangePlugin6, rangePlugin7, rangePlugin8, rangePlugin9,
+  rangePlugin10, rangePlugin11, rangePlugin12, rangePlugin13, rangePlugin14,
+  rangePlugin15, rangePlugin16, rangePlugin17, rangePlugin18, rangePlugin19,
+  rangePlugin20, rangePlugin21, rangePlugin22, rangePlugin23, rangePlugin24,
+  rangePlugin25, rangePlugin26, rangePlugin27, rangePlugin28, watcher);
+
+// The plugins' `onKeyEvent()` handlers, called by the dispatcher that
+// `KALEIDOSCOPE_INIT_PLUGINS()` generated, as `Hooks::onKeyEvent()` does...
+__attribute__((noinline)) kaleidoscope::EventHandlerResult dispatchFiltered(KeyEvent &event) {
+  return kaleidoscope_internal::EventDispatcher::apply<
+    kaleidoscope_internal::EventHandler_onKeyEvent_v1>(event);
+}
+
+// ...and called one after the other, without the filter, as the dispatcher
+// did before: the baseline for the benchmark.
+#define CALL_RANGE_PLUGIN(N)                                            \
+  result = rangePlugin##N.onKeyEvent(event);                            \
+  if (result != kaleidoscope::EventHandlerResult::OK)                   \
+    return result;
+
+__attribute__((noinline)) kaleidoscope::EventHandlerResult dispatchUnfiltered(KeyEvent &event) {
+  kaleidoscope::EventHandlerResult result;
+  RANGE_PLUGINS(CALL_RANGE_PLUGIN)
+  return watcher.onKeyEvent(event);
+}
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
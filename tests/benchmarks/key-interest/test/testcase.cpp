@@ -0,0 +1,123 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>  // for steady_clock, duration
+
+#include "kaleidoscope/key_interest.h"  // for keyRange, keyFlags, singleKey
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+// Defined in the sketch
+extern uint32_t range_plugin_calls[29];
+extern uint32_t range_plugin_hits[29];
+extern uint32_t watcher_calls;
+kaleidoscope::EventHandlerResult dispatchFiltered(KeyEvent &event);
+kaleidoscope::EventHandlerResult dispatchUnfiltered(KeyEvent &event);
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+static_assert(keyRange(Key_A, Key_C).matches(Key_B), "");
+static_assert(!keyRange(Key_A, Key_C).matches(Key_D), "");
+static_assert(!keyRange(Key_A, Key_C).matches(LSHIFT(Key_B)), "");
+static_assert(singleKey(Key_LeftGui).matches(Key_LeftGui), "");
+static_assert(!singleKey(Key_LeftGui).matches(Key_RightGui), "");
+static_assert(keyFlags(SYNTHETIC | IS_CONSUMER, SYNTHETIC | IS_CONSUMER).matches(Consumer_Mute), "");
+static_assert(!keyFlags(SYNTHETIC | IS_CONSUMER).matches(Key_A), "");
+
+constexpr size_t plugin_count = 29;
+constexpr int events          = 100000;
+
+class KeyInterest : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    resetCalls();
+  }
+
+  static void resetCalls() {
+    for (size_t i = 0; i < plugin_count; ++i)
+      range_plugin_calls[i] = range_plugin_hits[i] = 0;
+    watcher_calls = 0;
+  }
+
+  static uint32_t rangePluginCalls() {
+    uint32_t calls = 0;
+    for (size_t i = 0; i < plugin_count; ++i)
+      calls += range_plugin_calls[i];
+    return calls;
+  }
+};
+
+TEST_F(KeyInterest, UninterestedPluginsAreSkipped) {
+  sim_.Press(0, 0);  // Key_A
+  RunCycle();
+  sim_.Release(0, 0);
+  RunCycle();
+
+  EXPECT_EQ(rangePluginCalls(), 0u);
+  // The plugin without a declaration still sees every key.
+  EXPECT_EQ(watcher_calls, 2u);
+}
+
+TEST_F(KeyInterest, InterestedPluginIsCalled) {
+  sim_.Press(0, 1);  // A key of range plugin #5
+  RunCycle();
+  sim_.Release(0, 1);
+  RunCycle();
+
+  // `onKeyEvent()` twice, and `onAddToReport()` once, while it was held.
+  EXPECT_EQ(range_plugin_calls[5], 3u);
+  EXPECT_EQ(range_plugin_hits[5], 3u);
+  EXPECT_EQ(rangePluginCalls(), 3u);
+  EXPECT_EQ(watcher_calls, 2u);
+}
+
+TEST_F(KeyInterest, DispatchCost) {
+  KeyEvent event(KeyAddr(uint8_t(0)), INJECTED | IS_PRESSED, Key_A);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < events; ++i)
+    dispatchUnfiltered(event);
+  std::chrono::duration<double, std::nano> unfiltered_time =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(rangePluginCalls(), plugin_count * events);
+  resetCalls();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < events; ++i)
+    dispatchFiltered(event);
+  std::chrono::duration<double, std::nano> filtered_time =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(rangePluginCalls(), 0u);
+  EXPECT_EQ(watcher_calls, uint32_t(events));
+
+  std::cout << "onKeyEvent() dispatch to " << plugin_count + 1
+            << " plugins, per event:" << std::endl
+            << "  unfiltered: " << unfiltered_time.count() / events << " ns" << std::endl
+            << "  filtered:   " << filtered_time.count() / events << " ns" << std::endl;
+  // The timings depend on the machine running the test, so they're only
+  // reported; the call counts above are what's checked.
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,126 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        ShiftToLayer(1), Key_1, Key_2, Key_3, Key_4, Key_5, ShiftToLayer(5),
+        Key_Backtick, Key_Q, Key_W, Key_E, Key_R, Key_T, Key_Tab,
+        Key_PageUp, Key_A, Key_S, Key_D, Key_F, Key_G,
+        Key_PageDown, Key_Z, Key_X, Key_C, Key_V, Key_B, Key_Escape,
+        Key_LeftControl, Key_Backspace, Key_LeftGui, Key_LeftShift,
+        ShiftToLayer(2),
+
+        ShiftToLayer(3), Key_6, Key_7, Key_8, Key_9, Key_0, ShiftToLayer(4),
+        Key_Enter, Key_Y, Key_U, Key_I, Key_O, Key_P, Key_Equals,
+        Key_H, Key_J, Key_K, Key_L, Key_Semicolon, Key_Quote,
+        Key_RightAlt, Key_N, Key_M, Key_Comma, Key_Period, Key_Slash, Key_Minus,
+        Key_RightShift, Key_LeftAlt, Key_Spacebar, Key_RightControl,
+        ShiftToLayer(2)
+    ),
+    [1] = KEYMAP_STACKED
+    (
+        ___, Key_F1, Key_F2, Key_F3, Key_F4, Key_F5, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, Key_F6, Key_F7, Key_F8, Key_F9, Key_F10, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+    [2] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, Key_LeftArrow, Key_DownArrow, Key_UpArrow, Key_RightArrow, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        Key_LeftArrow, Key_DownArrow, Key_UpArrow, Key_RightArrow, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+    [3] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, Key_Keypad7, Key_Keypad8, Key_Keypad9, ___, ___, ___,
+        ___, Key_Keypad4, Key_Keypad5, Key_Keypad6, ___, ___,
+        ___, Key_Keypad1, Key_Keypad2, Key_Keypad3, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+    [4] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, Key_Home, Key_End, Key_Insert, Key_Delete, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+    [5] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        Key_Mute, Key_VolumeUp, Key_VolumeDown, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, Key_PrintScreen, Key_ScrollLock, Key_Pause, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -0,0 +1,173 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>  // for steady_clock, duration
+#include <random>  // for mt19937
+#include <vector>  // for vector
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr uint8_t num_layers = 6;
+constexpr int toggle_count   = 1000;
+
+// Number of keymap lookups made through `Layer.getKey` since the last reset.
+uint32_t lookups = 0;
+
+Key countingGetKey(uint8_t layer, KeyAddr key_addr) {
+  ++lookups;
+  return Layer_::getKeyFromPROGMEM(layer, key_addr);
+}
+
+class LayerToggle : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    Layer.getKey = countingGetKey;
+    Layer.move(0);
+  }
+
+  void TearDown() override {
+    Layer.move(0);
+    Layer.getKey = Layer_::getKeyFromPROGMEM;
+  }
+
+  KeyAddr findKey(Key key) {
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      if (Layer_::getKeyFromPROGMEM(0, key_addr) == key)
+        return key_addr;
+    }
+    return KeyAddr::none();
+  }
+
+  std::vector<uint8_t> activeLayerKeymap() {
+    std::vector<uint8_t> result;
+    for (KeyAddr key_addr : KeyAddr::all())
+      result.push_back(Layer.lookupActiveLayer(key_addr));
+    return result;
+  }
+
+  // Check that the incrementally-updated active layer keymap matches the one
+  // we get from rebuilding it from scratch.
+  void checkActiveLayerKeymap(int step) {
+    std::vector<uint8_t> incremental = activeLayerKeymap();
+    Layer.updateActiveLayers();
+    ASSERT_EQ(incremental, activeLayerKeymap()) << "after step " << step;
+  }
+};
+
+TEST_F(LayerToggle, MatchesFullRebuild) {
+  std::mt19937 rng(1138);
+  std::vector<KeyAddr> shift_keys;
+  for (uint8_t layer = 1; layer < num_layers; ++layer)
+    shift_keys.push_back(findKey(ShiftToLayer(layer)));
+  std::vector<bool> held(shift_keys.size(), false);
+
+  for (int step = 0; step < 2000; ++step) {
+    uint8_t layer = rng() % num_layers;
+    switch (rng() % 4) {
+    case 0:
+      Layer.activate(layer);
+      break;
+    case 1:
+      Layer.deactivate(layer);
+      break;
+    default: {
+      // Toggle one of the layer shift keys
+      uint8_t i = rng() % shift_keys.size();
+      if (held[i]) {
+        sim_.Release(shift_keys[i]);
+      } else {
+        sim_.Press(shift_keys[i]);
+      }
+      held[i] = !held[i];
+      RunCycle();
+    }
+    }
+    checkActiveLayerKeymap(step);
+  }
+
+  for (uint8_t i = 0; i < shift_keys.size(); ++i) {
+    if (held[i])
+      sim_.Release(shift_keys[i]);
+  }
+  RunCycle();
+}
+
+TEST_F(LayerToggle, ShiftLatency) {
+  KeyAddr shift_key = findKey(ShiftToLayer(5));
+  ASSERT_TRUE(shift_key.isValid());
+
+  // Put a few locked layers on the stack under the shifted layer.
+  Layer.activate(1);
+  Layer.activate(2);
+  Layer.activate(3);
+
+  // How much work it takes to rebuild the whole active layer keymap once with
+  // the shifted layer on top (for the press), and once without it (for the
+  // release), which is what every layer change used to cost.
+  Layer.activate(5 + LAYER_SHIFT_OFFSET);
+  lookups    = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < toggle_count; ++i)
+    Layer.updateActiveLayers();
+  std::chrono::duration<double, std::micro> full_time =
+    std::chrono::steady_clock::now() - start;
+  Layer.deactivate(5 + LAYER_SHIFT_OFFSET);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < toggle_count; ++i)
+    Layer.updateActiveLayers();
+  full_time += std::chrono::steady_clock::now() - start;
+  uint32_t full_lookups = lookups / toggle_count;
+
+  // The actual layer shift key, through the whole event path.
+  lookups = 0;
+  start   = std::chrono::steady_clock::now();
+  for (int i = 0; i < toggle_count; ++i) {
+    sim_.Press(shift_key);
+    RunCycle();
+    sim_.Release(shift_key);
+    RunCycle();
+  }
+  std::chrono::duration<double, std::micro> toggle_time =
+    std::chrono::steady_clock::now() - start;
+  uint32_t toggle_lookups = lookups / toggle_count;
+
+  std::cout << "layer shift press & release, " << int(Layer.mostRecent()) + 1
+            << " layers active underneath:" << std::endl
+            << "  keymap lookups per toggle: " << toggle_lookups
+            << " (full rebuild: " << full_lookups << ")" << std::endl
+            << "  time per toggle (cycles included): "
+            << toggle_time.count() / toggle_count << " us" << std::endl
+            << "  time per toggle (full rebuild, no cycles): "
+            << full_time.count() / toggle_count << " us" << std::endl;
+
+  // Pushing the shifted layer needs one lookup per key, and popping it only
+  // needs to recompute the entries that were mapped from it.
+  EXPECT_LT(toggle_lookups, full_lookups);
+  EXPECT_LE(toggle_lookups, 2 * KeyAddr::upper_limit);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,330 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-Leader.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        LEAD(0), ___, ___, ___, ___, ___, ___,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(Leader);
+
+// The number of actions run, and the index of the last one
+uint16_t leader_calls;
+uint8_t last_sequence;
+
+static void leaderAction(uint8_t seq_index) {
+  ++leader_calls;
+  last_sequence = seq_index;
+}
+
+// 256 of the 343 sequences of three of the keys A to G (the most a dictionary
+// can hold), in the order given by `sequenceKeys()` in the testcase.
+// *INDENT-OFF*
+LEADER_DICTIONARY(leader_dictionary,
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_F, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_F, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_F, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_E, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_E, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_E, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_E, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_E, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_E, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_E, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_D, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_D, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_D, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_D, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_D, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_D, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_D, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_C, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_C, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_C, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_C, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_C, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_C, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_C, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_B, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_B, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_B, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_B, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_B, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_B, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_B, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_A, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_A, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_A, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_A, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_A, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_F, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_F, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_F, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_E, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_E, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_E, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_E, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_E, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_E, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_E, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_D, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_D, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_D, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_D, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_D, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_D, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_D, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_C, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_C, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_C, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_C, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_C, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_C, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_C, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_B, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_B, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_B, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_B, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_B, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_B, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_B, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_A, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_A, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_A, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_A, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_A, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_F, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_F, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_E, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_E, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_E, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_E, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_E, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_E, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_E, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_D, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_D, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_D, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_D, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_D, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_D, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_D, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_C, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_C, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_C, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_C, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_C, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_C, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_C, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_B, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_B, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_B, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_B, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_B, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_B, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_B, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_A, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_A, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_A, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_A, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_A, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_F, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_F, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_F, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_F, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_E, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_E, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_E, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_E, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_E, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_E, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_E, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_D, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_D, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_D, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_D, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_D, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_D, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_D, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_C, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_C, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_C, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_C, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_C, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_C, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_C, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_B, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_B, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_B, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_B, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_B, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_B, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_B, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_A, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_A, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_A, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_A, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_A, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_F, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_F, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_E, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_E, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_E, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_E, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_E, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_E, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_E, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_D, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_D, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_D, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_D, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_D, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_D, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_D, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_C, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_C, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_C, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_C, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_C, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_C, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_C, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_B, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_B, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_B, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_B, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_B, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_B, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_B, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_A, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_A, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_A, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_A, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_A, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_A, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_A, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_G, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_G, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_G, Key_E), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_C, Key_G, Key_D), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_E, Key_G, Key_C), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_G, Key_G, Key_B), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_B, Key_G, Key_A), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_D, Key_F, Key_G), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_F, Key_F, Key_F), leaderAction},
+  {LEADER_SEQ(LEAD(0), Key_A, Key_F, Key_E), leaderAction}
+);
+// *INDENT-ON*
+
+void useIndexedDictionary() {
+  Leader.setDictionary(leader_dictionary);
+}
+
+void useLinearDictionary() {
+  Leader.dictionary = leader_dictionary_sequences;
+}
+
+void setup() {
+  Kaleidoscope.setup();
+  useIndexedDictionary();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
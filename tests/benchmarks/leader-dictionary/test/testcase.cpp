@@ -0,0 +1,133 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>  // for steady_clock, duration
+#include <vector>  // for vector
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+// Defined in the sketch
+extern uint16_t leader_calls;
+extern uint8_t last_sequence;
+void useIndexedDictionary();
+void useLinearDictionary();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr uint16_t sequence_count = 256;
+constexpr int lookup_rounds       = 10;
+
+constexpr KeyAddr leader_addr{0, 0};
+
+class LeaderDictionary : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    useIndexedDictionary();
+    leader_calls = 0;
+  }
+
+  // The addresses of the keys after the leader in sequence `i` of the sketch.
+  // Key_A to Key_G are on the second row.
+  static std::vector<KeyAddr> sequenceKeys(uint16_t i) {
+    uint16_t combination = (i * 97) % 343;
+    return {KeyAddr(uint8_t(1), uint8_t(combination / 49)),
+            KeyAddr(uint8_t(1), uint8_t(combination / 7 % 7)),
+            KeyAddr(uint8_t(1), uint8_t(combination % 7))};
+  }
+
+  void tap(KeyAddr addr) {
+    sim_.Press(addr);
+    RunCycle();
+    sim_.Release(addr);
+    RunCycle();
+  }
+
+  void typeSequence(uint16_t i) {
+    tap(leader_addr);
+    for (KeyAddr addr : sequenceKeys(i))
+      tap(addr);
+  }
+
+  // Types every sequence in the dictionary, and returns the time it took.
+  std::chrono::duration<double, std::micro> typeAll() {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < lookup_rounds; ++round)
+      for (uint16_t i = 0; i < sequence_count; ++i)
+        typeSequence(i);
+    return std::chrono::steady_clock::now() - start;
+  }
+};
+
+TEST_F(LeaderDictionary, EverySequenceRunsItsAction) {
+  for (uint16_t i = 0; i < sequence_count; ++i) {
+    typeSequence(i);
+    ASSERT_EQ(leader_calls, i + 1) << "sequence #" << i;
+    EXPECT_EQ(last_sequence, i) << "sequence #" << i;
+  }
+}
+
+TEST_F(LeaderDictionary, UnknownSequenceRunsNothing) {
+  // The combination right after the last one in the dictionary
+  uint16_t combination = (sequence_count * 97) % 343;
+  tap(leader_addr);
+  tap(KeyAddr(uint8_t(1), uint8_t(combination / 49)));
+  tap(KeyAddr(uint8_t(1), uint8_t(combination / 7 % 7)));
+  auto state = RunCycle();
+  sim_.Press(KeyAddr(uint8_t(1), uint8_t(combination % 7)));
+  state = RunCycle();
+
+  EXPECT_EQ(leader_calls, 0);
+  // The last key doesn't continue any sequence, so it's handled as usual.
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_EQ(state->HIDReports()->Keyboard(0).ActiveKeycodes().size(), 1);
+  sim_.Release(KeyAddr(uint8_t(1), uint8_t(combination % 7)));
+  RunCycle();
+}
+
+TEST_F(LeaderDictionary, LinearLookupMatchesIndex) {
+  useLinearDictionary();
+  for (uint16_t i = 0; i < sequence_count; ++i) {
+    typeSequence(i);
+    ASSERT_EQ(leader_calls, i + 1) << "sequence #" << i;
+    EXPECT_EQ(last_sequence, i) << "sequence #" << i;
+  }
+}
+
+TEST_F(LeaderDictionary, LookupTime) {
+  useLinearDictionary();
+  std::chrono::duration<double, std::micro> linear_time = typeAll();
+  useIndexedDictionary();
+  std::chrono::duration<double, std::micro> indexed_time = typeAll();
+
+  EXPECT_EQ(leader_calls, 2 * lookup_rounds * sequence_count);
+
+  // Every sequence is four taps, of two cycles each.
+  double cycles = lookup_rounds * sequence_count * 8;
+  std::cout << "Leader dictionary of " << sequence_count << " sequences:" << std::endl
+            << "  linear:  " << linear_time.count() / cycles << " us per cycle" << std::endl
+            << "  indexed: " << indexed_time.count() / cycles << " us per cycle" << std::endl;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,175 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-IdleLEDs.h>    // for IdleLEDs
+#include <Kaleidoscope-LEDControl.h>  // for LEDControl
+#include <vector>                     // for vector
+
+#include "kaleidoscope/Deadline.h"  // for Deadline
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::ElementsAre;
+
+// The names and times (relative to `start`) of the deadlines that fired
+struct Firing {
+  char name;
+  uint32_t time;
+
+  bool operator==(const Firing &other) const {
+    return name == other.name && time == other.time;
+  }
+};
+
+std::vector<Firing> firings;
+uint32_t start;
+uint32_t interval;
+
+void record(char name) {
+  firings.push_back({name, Runtime.millisAtCycleStart() - start});
+}
+
+extern Deadline deadline_a, deadline_b, deadline_c;
+
+void onDeadlineA() {
+  record('a');
+}
+void onDeadlineB() {
+  record('b');
+}
+void onDeadlineC() {
+  record('c');
+  if (interval != 0)
+    Runtime.rearmDeadline(deadline_c, interval);
+}
+
+Deadline deadline_a{onDeadlineA};
+Deadline deadline_b{onDeadlineB};
+Deadline deadline_c{onDeadlineC};
+
+class Deadlines : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    firings.clear();
+    interval = 0;
+    RunCycle();
+    start = Runtime.millisAtCycleStart();
+  }
+
+  void TearDown() override {
+    Runtime.cancelDeadline(deadline_a);
+    Runtime.cancelDeadline(deadline_b);
+    Runtime.cancelDeadline(deadline_c);
+  }
+};
+
+TEST_F(Deadlines, FireOnceInOrder) {
+  Runtime.armDeadline(deadline_a, 30);
+  Runtime.armDeadline(deadline_b, 10);
+  Runtime.armDeadline(deadline_c, 20);
+  EXPECT_TRUE(deadline_a.isArmed());
+  // LEDControl and IdleLEDs have deadlines of their own, which may come first.
+  EXPECT_LE(Runtime.millisUntilNextDeadline(), 10u);
+
+  sim_.RunForMillis(50);
+
+  EXPECT_THAT(firings, ElementsAre(Firing{'b', 10}, Firing{'c', 20}, Firing{'a', 30}));
+  EXPECT_FALSE(deadline_a.isArmed());
+  EXPECT_FALSE(deadline_b.isArmed());
+  EXPECT_FALSE(deadline_c.isArmed());
+}
+
+TEST_F(Deadlines, ReArmAndCancel) {
+  Runtime.armDeadline(deadline_a, 10);
+  Runtime.armDeadline(deadline_b, 10);
+  sim_.RunForMillis(5);
+
+  // Arming an armed deadline replaces its expiry time.
+  Runtime.armDeadline(deadline_a, 10);
+  Runtime.cancelDeadline(deadline_b);
+  EXPECT_FALSE(deadline_b.isArmed());
+  sim_.RunForMillis(20);
+
+  EXPECT_THAT(firings, ElementsAre(Firing{'a', 15}));
+}
+
+TEST_F(Deadlines, Periodic) {
+  interval = 5;
+  Runtime.armDeadline(deadline_c, 5);
+  sim_.RunForMillis(22);
+
+  EXPECT_THAT(firings, ElementsAre(Firing{'c', 5}, Firing{'c', 10},
+                                   Firing{'c', 15}, Firing{'c', 20}));
+  EXPECT_TRUE(deadline_c.isArmed());
+  EXPECT_EQ(deadline_c.expiry() - start, 25u);
+}
+
+TEST_F(Deadlines, SlowCyclesCatchUpOncePerCycle) {
+  interval = 2;
+  Runtime.armDeadline(deadline_c, 2);
+  sim_.SetCycleTime(7);
+  RunCycle();
+  RunCycle();
+  sim_.SetCycleTime(1);
+  RunCycle();
+  RunCycle();
+  RunCycle();
+
+  // The cycles started at 7, 14, 15, 16 and 17 ms. Once the deadline is late,
+  // it fires once per cycle until it catches up, without losing any intervals.
+  EXPECT_THAT(firings, ElementsAre(Firing{'c', 7}, Firing{'c', 14},
+                                   Firing{'c', 15}, Firing{'c', 16},
+                                   Firing{'c', 17}));
+  EXPECT_EQ(deadline_c.expiry() - start, 12u);
+}
+
+TEST_F(Deadlines, IdleLEDs) {
+  ASSERT_TRUE(::LEDControl.isEnabled());
+  ::IdleLEDs.setIdleTimeoutSeconds(1);
+
+  sim_.RunForMillis(500);
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+
+  // The timeout counts from the last key event.
+  sim_.RunForMillis(900);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(200);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+
+  sim_.Press(KeyAddr{0, 1});
+  RunCycle();
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.Release(KeyAddr{0, 1});
+  RunCycle();
+
+  ::IdleLEDs.setIdleTimeoutSeconds(0);
+  sim_.RunForMillis(2000);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,104 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+// *INDENT-OFF*
+
+KEYMAPS(
+  [0] = KEYMAP_STACKED
+  (
+    XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+          ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+  )
+) // KEYMAPS(
+
+// *INDENT-ON*
+
+// The number of times each of the plugins below was offered a command
+uint8_t routed_calls;
+uint8_t broadcast_calls;
+
+namespace kaleidoscope {
+namespace plugin {
+
+// Registers its commands, but doesn't consume `routed.decline`, so that one
+// falls back to the broadcast.
+class RoutedCommands : public Plugin {
+ public:
+  KALEIDOSCOPE_FOCUS_COMMANDS("routed.consume", "routed.decline")
+
+  EventHandlerResult onFocusEvent(const char *input) {
+    const char *cmd_consume = PSTR("routed.consume");
+    const char *cmd_decline = PSTR("routed.decline");
+
+    ++routed_calls;
+    if (::Focus.inputMatchesHelp(input))
+      return ::Focus.printHelp(cmd_consume, cmd_decline);
+
+    if (!::Focus.inputMatchesCommand(input, cmd_consume))
+      return EventHandlerResult::OK;
+
+    ::Focus.send(F("routed"));
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+};
+
+// Doesn't register its commands, so it's offered every one that isn't routed.
+class BroadcastCommands : public Plugin {
+ public:
+  EventHandlerResult onFocusEvent(const char *input) {
+    const char *cmd_broadcast = PSTR("broadcast.command");
+
+    ++broadcast_calls;
+    if (::Focus.inputMatchesHelp(input))
+      return ::Focus.printHelp(cmd_broadcast);
+
+    if (!::Focus.inputMatchesCommand(input, cmd_broadcast))
+      return EventHandlerResult::OK;
+
+    ::Focus.send(F("broadcast"));
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::RoutedCommands RoutedCommands;
+kaleidoscope::plugin::BroadcastCommands BroadcastCommands;
+
+KALEIDOSCOPE_INIT_PLUGINS(Focus, RoutedCommands, BroadcastCommands);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
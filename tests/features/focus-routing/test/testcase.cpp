@@ -0,0 +1,93 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/focus_commands.h"  // for focusCommandHash, FocusCommandHash
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+// Defined in the sketch
+extern uint8_t routed_calls;
+extern uint8_t broadcast_calls;
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::HasSubstr;
+
+// The hash of "a", as given in the FNV-1a reference
+static_assert(focusCommandHash("a") == 0xe40c292c, "");
+
+class FocusRouting : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    RunCycle();
+    routed_calls    = 0;
+    broadcast_calls = 0;
+  }
+};
+
+TEST_F(FocusRouting, RuntimeHashMatchesCompileTimeHash) {
+  std::string command = "routed.consume";
+  EXPECT_EQ(focusCommandHash(command.c_str()),
+            FocusCommandHash<focusCommandHash("routed.consume")>::value);
+  EXPECT_NE(focusCommandHash("routed.consume"), focusCommandHash("routed.decline"));
+}
+
+TEST_F(FocusRouting, RegisteredCommandGoesToItsOwner) {
+  EXPECT_EQ(sim_.SendFocusCommand("routed.consume"), "routed ");
+  EXPECT_EQ(routed_calls, 1);
+  EXPECT_EQ(broadcast_calls, 0);
+}
+
+TEST_F(FocusRouting, CommandsOfCorePluginsAreRouted) {
+  // None of the plugins in the sketch have a name to report
+  EXPECT_EQ(sim_.SendFocusCommand("plugins"), "");
+  EXPECT_EQ(routed_calls, 0);
+  EXPECT_EQ(broadcast_calls, 0);
+}
+
+TEST_F(FocusRouting, UnregisteredCommandIsBroadcast) {
+  EXPECT_EQ(sim_.SendFocusCommand("broadcast.command"), "broadcast ");
+  EXPECT_EQ(routed_calls, 1);
+  EXPECT_EQ(broadcast_calls, 1);
+}
+
+TEST_F(FocusRouting, DeclinedCommandFallsBackToBroadcast) {
+  EXPECT_EQ(sim_.SendFocusCommand("routed.decline"), "");
+  // Once when it was routed, and once more in the broadcast
+  EXPECT_EQ(routed_calls, 2);
+  EXPECT_EQ(broadcast_calls, 1);
+}
+
+TEST_F(FocusRouting, HelpListsAllCommands) {
+  std::string help = sim_.SendFocusCommand("help");
+  EXPECT_THAT(help, HasSubstr("device.reset"));
+  EXPECT_THAT(help, HasSubstr("routed.consume"));
+  EXPECT_THAT(help, HasSubstr("routed.decline"));
+  EXPECT_THAT(help, HasSubstr("broadcast.command"));
+  EXPECT_EQ(routed_calls, 1);
+  EXPECT_EQ(broadcast_calls, 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
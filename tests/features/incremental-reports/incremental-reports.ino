@@ -0,0 +1,65 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-MouseKeys.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, Key_B, Key_C, LSHIFT(Key_D), Key_LeftShift, Key_LeftControl, ShiftToLayer(1),
+        Consumer_VolumeIncrement, Consumer_VolumeDecrement, Key_mouseBtnL, Key_mouseBtnR, LCTRL(Key_LeftAlt), ML(LeftGui, 1), Key_A,
+        Key_E, Key_F, Key_G, Key_H, Key_I, Key_J,
+        Key_K, Key_L, Key_M, Key_N, Key_O, Key_P, Key_Q,
+        Key_R, Key_S, Key_T, Key_U,
+        Key_V,
+
+        Key_1, Key_2, Key_3, Key_4, Key_5, Key_6, Key_7,
+        Key_8, Key_9, Key_0, Key_W, Key_X, Key_Y, Key_Z,
+        LALT(Key_1), LGUI(Key_2), Key_RightAlt, Key_RightShift, Key_Minus, Key_Equals,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+    [1] = KEYMAP_STACKED
+    (
+        Key_F1, Key_F2, ___, ___, ___, ___, ___,
+        Consumer_Mute, ___, ___, ___, ___, ___, ___,
+        Key_F3, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(MouseKeys);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
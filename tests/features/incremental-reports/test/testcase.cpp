@@ -0,0 +1,100 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bitset>  // for bitset
+#include <random>  // for mt19937
+#include <vector>  // for vector
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// Everything we compare between the two report building modes. Each report is
+// tagged with the number of the cycle it was sent in.
+struct ReportTrace {
+  std::vector<std::pair<size_t, std::vector<uint8_t>>> keyboard;
+  std::vector<std::pair<size_t, std::vector<uint16_t>>> consumer;
+  std::vector<std::pair<size_t, uint8_t>> mouse_buttons;
+};
+
+class IncrementalReports : public VirtualDeviceTest {
+ protected:
+  // Play the same pseudo-random sequence of presses & releases each time it's
+  // called, ending with all keys released, and record the resulting reports.
+  ReportTrace PlaySequence() {
+    ReportTrace trace;
+    std::mt19937 rng(1138);
+    std::bitset<KeyAddr::upper_limit> pressed;
+    size_t cycle = 0;
+
+    auto run_cycle = [&]() {
+      auto state = RunCycle();
+      for (const auto &report : state->HIDReports()->Keyboard())
+        trace.keyboard.emplace_back(cycle, report.ActiveKeycodes());
+      for (const auto &report : state->HIDReports()->ConsumerControl())
+        trace.consumer.emplace_back(cycle, report.ActiveKeycodes());
+      for (const auto &report : state->HIDReports()->Mouse())
+        trace.mouse_buttons.emplace_back(cycle, report.Buttons());
+      ++cycle;
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+      KeyAddr addr(uint8_t(rng() % KeyAddr::upper_limit));
+      if (pressed[addr.toInt()]) {
+        sim_.Release(addr);
+      } else {
+        sim_.Press(addr);
+      }
+      pressed.flip(addr.toInt());
+      // Sometimes let more than one switch change state in the same cycle.
+      if (rng() % 4 != 0)
+        run_cycle();
+    }
+
+    for (KeyAddr addr : KeyAddr::all()) {
+      if (pressed[addr.toInt()])
+        sim_.Release(addr);
+    }
+    run_cycle();
+    run_cycle();
+
+    return trace;
+  }
+};
+
+TEST_F(IncrementalReports, MatchFullRebuild) {
+  ReportTrace full = PlaySequence();
+
+  Kaleidoscope.enableIncrementalReports();
+  ReportTrace incremental = PlaySequence();
+  Kaleidoscope.disableIncrementalReports();
+
+  ASSERT_FALSE(full.keyboard.empty());
+  ASSERT_FALSE(full.consumer.empty());
+  ASSERT_FALSE(full.mouse_buttons.empty());
+
+  EXPECT_EQ(incremental.keyboard, full.keyboard);
+  EXPECT_EQ(incremental.consumer, full.consumer);
+  EXPECT_EQ(incremental.mouse_buttons, full.mouse_buttons);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,138 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-LEDControl.h>
+#include <Kaleidoscope-LEDEffect-SolidColor.h>
+#include <Kaleidoscope-LED-ActiveModColor.h>
+
+// *INDENT-OFF*
+
+KEYMAPS(
+  [0] = KEYMAP_STACKED
+  (
+    Key_LeftShift ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+          ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+  )
+) // KEYMAPS(
+
+// *INDENT-ON*
+
+namespace kaleidoscope {
+namespace plugin {
+
+// An animated effect: it changes the color of the first LED on every update.
+class LEDCounter : public LEDMode {
+ protected:
+  void update() final {
+    ++count_;
+    ::LEDControl.setCrgbAt(uint8_t(0), CRGB(count_, 0, 0));
+  }
+
+ private:
+  uint8_t count_ = 0;
+};
+
+// A layer of a single color, covering the LEDs the testcase asks it to.
+class TestLayer : public Plugin,
+                  public LEDLayer {
+ public:
+  TestLayer(Blend blend, cRGB color)
+    : LEDLayer(blend), color_(color) {}
+
+  EventHandlerResult onSetup() {
+    ::LEDControl.addLayer(*this);
+    return EventHandlerResult::OK;
+  }
+
+  cRGB colorAt(uint8_t led_index) final {
+    return color_;
+  }
+
+  void show(uint8_t led_index) {
+    cover(led_index);
+  }
+  void hide(uint8_t led_index) {
+    uncover(led_index);
+  }
+  void hideAll() {
+    for (uint8_t i = 0; i < LEDBitfield::size; ++i)
+      uncover(i);
+  }
+  void setColor(cRGB color) {
+    color_ = color;
+    for (uint8_t i = 0; i < LEDBitfield::size; ++i)
+      refresh(i);
+  }
+
+ private:
+  cRGB color_;
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::LEDSolidColor solidBlue(0, 0, 160);
+kaleidoscope::plugin::LEDCounter LEDCounter;
+kaleidoscope::plugin::TestLayer replaceLayer(kaleidoscope::plugin::LEDLayer::Blend::Replace,
+                                             CRGB(160, 0, 0));
+kaleidoscope::plugin::TestLayer addLayer(kaleidoscope::plugin::LEDLayer::Blend::Add,
+                                         CRGB(0, 100, 0));
+
+// Used by the testcase, which doesn't see the definition of `TestLayer`
+void showReplaceLayer(uint8_t led_index) {
+  replaceLayer.show(led_index);
+}
+void hideReplaceLayer(uint8_t led_index) {
+  replaceLayer.hide(led_index);
+}
+void showAddLayer(uint8_t led_index) {
+  addLayer.show(led_index);
+}
+void setReplaceLayerColor(cRGB color) {
+  replaceLayer.setColor(color);
+}
+void resetLayers() {
+  replaceLayer.hideAll();
+  replaceLayer.setColor(CRGB(160, 0, 0));
+  addLayer.hideAll();
+}
+
+KALEIDOSCOPE_INIT_PLUGINS(LEDControl,
+                          solidBlue,
+                          LEDCounter,
+                          replaceLayer,
+                          addLayer,
+                          ActiveModColorEffect);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
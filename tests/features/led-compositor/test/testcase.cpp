@@ -0,0 +1,145 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-LEDControl.h>  // for LEDControl
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+// Defined in the sketch
+extern void showReplaceLayer(uint8_t led_index);
+extern void hideReplaceLayer(uint8_t led_index);
+extern void showAddLayer(uint8_t led_index);
+extern void setReplaceLayerColor(cRGB color);
+extern void resetLayers();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The default interval between LED syncs
+constexpr uint32_t sync_interval = 32;
+
+// The LED modes of the sketch
+constexpr uint8_t solid_blue  = 0;
+constexpr uint8_t led_counter = 1;
+
+class LEDCompositor : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    RunCycle();
+    resetLayers();
+    ::LEDControl.set_mode(solid_blue);
+    waitForSync();
+  }
+
+  // Lets enough time pass for one more sync.
+  void waitForSync() {
+    sim_.RunForMillis(sync_interval);
+  }
+
+  static void expectColor(uint8_t led_index, uint8_t r, uint8_t g, uint8_t b) {
+    cRGB color = ::LEDControl.getCrgbAt(led_index);
+    EXPECT_EQ(color.r, r) << "LED " << int(led_index);
+    EXPECT_EQ(color.g, g) << "LED " << int(led_index);
+    EXPECT_EQ(color.b, b) << "LED " << int(led_index);
+  }
+};
+
+TEST_F(LEDCompositor, ReplaceLayerCoversTheLEDMode) {
+  showReplaceLayer(5);
+  waitForSync();
+  expectColor(5, 160, 0, 0);
+  expectColor(4, 0, 0, 160);
+
+  hideReplaceLayer(5);
+  waitForSync();
+  expectColor(5, 0, 0, 160);
+}
+
+TEST_F(LEDCompositor, AddLayerBlendsWithTheLEDMode) {
+  showAddLayer(7);
+  waitForSync();
+  expectColor(7, 0, 100, 160);
+}
+
+TEST_F(LEDCompositor, LayersAreStackedInOrder) {
+  showReplaceLayer(9);
+  showAddLayer(9);
+  waitForSync();
+  expectColor(9, 160, 100, 0);
+
+  setReplaceLayerColor(CRGB(100, 0, 0));
+  waitForSync();
+  expectColor(9, 100, 100, 0);
+}
+
+TEST_F(LEDCompositor, StaticLayersSendNoFrames) {
+  showReplaceLayer(5);
+  waitForSync();
+  uint32_t sent = ::LEDControl.framesSent();
+
+  for (int i = 0; i < 10; ++i)
+    waitForSync();
+  EXPECT_EQ(::LEDControl.framesSent(), sent);
+}
+
+TEST_F(LEDCompositor, CoveredUpdatesOfTheLEDModeSendNoFrames) {
+  // The counter only changes the first LED, and the layer replaces its color.
+  ::LEDControl.set_mode(led_counter);
+  showReplaceLayer(0);
+  waitForSync();
+  waitForSync();
+  expectColor(0, 160, 0, 0);
+  uint32_t sent = ::LEDControl.framesSent();
+
+  for (int i = 0; i < 10; ++i)
+    waitForSync();
+  expectColor(0, 160, 0, 0);
+  EXPECT_EQ(::LEDControl.framesSent(), sent);
+}
+
+TEST_F(LEDCompositor, ActiveModifierIsHighlighted) {
+  uint8_t shift_led = Runtime.device().getLedIndex(KeyAddr(0, 0));
+
+  sim_.Press(KeyAddr(0, 0));
+  RunCycle();
+  waitForSync();
+  expectColor(shift_led, 160, 160, 160);
+
+  sim_.Release(KeyAddr(0, 0));
+  RunCycle();
+  waitForSync();
+  expectColor(shift_led, 0, 0, 160);
+}
+
+TEST_F(LEDCompositor, DisabledLEDsAreAllOff) {
+  showReplaceLayer(5);
+  waitForSync();
+
+  ::LEDControl.disable();
+  expectColor(5, 0, 0, 0);
+
+  ::LEDControl.enable();
+  expectColor(5, 160, 0, 0);
+  expectColor(4, 0, 0, 160);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,111 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-LEDControl.h>  // for LEDControl
+#include <string>                     // for string, to_string
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The default interval between LED syncs
+constexpr uint32_t sync_interval = 32;
+
+class LEDFrameDiff : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    RunCycle();
+  }
+
+  // Lets enough time pass for one more sync.
+  void waitForSync() {
+    sim_.RunForMillis(sync_interval);
+  }
+};
+
+TEST_F(LEDFrameDiff, StaticEffectSendsOnlyTheFirstFrame) {
+  ::LEDControl.set_mode(0);
+  waitForSync();
+  uint32_t sent    = ::LEDControl.framesSent();
+  uint32_t skipped = ::LEDControl.framesSkipped();
+
+  for (int i = 0; i < 10; ++i)
+    waitForSync();
+
+  EXPECT_EQ(::LEDControl.framesSent(), sent);
+  EXPECT_GE(::LEDControl.framesSkipped(), skipped + 10);
+}
+
+TEST_F(LEDFrameDiff, AnimatedEffectSendsEveryFrame) {
+  ::LEDControl.set_mode(1);
+  waitForSync();
+  uint32_t sent    = ::LEDControl.framesSent();
+  uint32_t skipped = ::LEDControl.framesSkipped();
+
+  for (int i = 0; i < 10; ++i)
+    waitForSync();
+
+  EXPECT_GE(::LEDControl.framesSent(), sent + 10);
+  EXPECT_EQ(::LEDControl.framesSkipped(), skipped);
+}
+
+TEST_F(LEDFrameDiff, OnlyChangesMarkLeds) {
+  ::LEDControl.set_mode(0);
+  waitForSync();
+  cRGB color = ::LEDControl.getCrgbAt(uint8_t(5));
+  EXPECT_FALSE(::LEDControl.hasChanged(5));
+
+  // Setting an LED to the color it already has isn't a change.
+  ::LEDControl.setCrgbAt(uint8_t(5), color);
+  EXPECT_FALSE(::LEDControl.hasChanged(5));
+
+  uint16_t generation = ::LEDControl.frameGeneration();
+  ::LEDControl.setCrgbAt(uint8_t(5), CRGB(0, 0, 160));
+  EXPECT_TRUE(::LEDControl.hasChanged(5));
+  EXPECT_FALSE(::LEDControl.hasChanged(6));
+
+  ::LEDControl.syncLeds();
+  EXPECT_FALSE(::LEDControl.hasChanged(5));
+  EXPECT_EQ(::LEDControl.frameGeneration(), uint16_t(generation + 1));
+}
+
+TEST_F(LEDFrameDiff, BrightnessChangeSendsAFrame) {
+  ::LEDControl.set_mode(0);
+  waitForSync();
+  uint32_t sent = ::LEDControl.framesSent();
+
+  ::LEDControl.setBrightness(128);
+  ::LEDControl.syncLeds();
+  EXPECT_EQ(::LEDControl.framesSent(), sent + 1);
+}
+
+TEST_F(LEDFrameDiff, FocusReportsFrameCounts) {
+  ::LEDControl.set_mode(0);
+  waitForSync();
+
+  std::string expected = std::to_string(::LEDControl.framesSent()) + " " +
+                         std::to_string(::LEDControl.framesSkipped()) + " ";
+  EXPECT_EQ(sim_.SendFocusCommand("led.frames"), expected);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
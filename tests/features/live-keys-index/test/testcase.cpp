@@ -0,0 +1,169 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bitset>  // for bitset
+#include <random>  // for mt19937
+#include <set>     // for set
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr addr_a{0, 0};
+constexpr KeyAddr addr_b{0, 1};
+constexpr KeyAddr addr_c{0, 2};
+constexpr KeyAddr addr_shift_to_layer{0, 6};
+
+class LiveKeysIndex : public VirtualDeviceTest {
+ protected:
+  // The addresses of the entries that aren't inactive, from a full scan
+  std::set<uint8_t> ScanLiveKeys() {
+    std::set<uint8_t> addrs;
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      if (live_keys[key_addr] != Key_Inactive)
+        addrs.insert(key_addr.toInt());
+    }
+    return addrs;
+  }
+
+  // The addresses the index visits
+  std::set<uint8_t> IndexedLiveKeys() {
+    std::set<uint8_t> addrs;
+    for (KeyAddr key_addr : live_keys.active()) {
+      EXPECT_TRUE(live_keys.isActive(key_addr));
+      addrs.insert(key_addr.toInt());
+    }
+    return addrs;
+  }
+
+  void ExpectIndexInStep() {
+    EXPECT_EQ(IndexedLiveKeys(), ScanLiveKeys());
+  }
+};
+
+TEST_F(LiveKeysIndex, FollowsPressAndRelease) {
+  sim_.Press(addr_a);
+  RunCycle();
+  sim_.Press(addr_b);
+  RunCycle();
+  EXPECT_EQ(IndexedLiveKeys(), (std::set<uint8_t>{addr_a.toInt(), addr_b.toInt()}));
+  ExpectIndexInStep();
+
+  sim_.Release(addr_a);
+  RunCycle();
+  EXPECT_EQ(IndexedLiveKeys(), (std::set<uint8_t>{addr_b.toInt()}));
+  EXPECT_FALSE(live_keys.isActive(addr_a));
+  ExpectIndexInStep();
+
+  sim_.Release(addr_b);
+  RunCycle();
+  EXPECT_TRUE(IndexedLiveKeys().empty());
+  ExpectIndexInStep();
+}
+
+TEST_F(LiveKeysIndex, CountsMaskedKeysAsActive) {
+  // A masked key that isn't held stays in the index until it's released.
+  live_keys.mask(addr_c);
+  EXPECT_TRUE(live_keys.isActive(addr_c));
+  ExpectIndexInStep();
+
+  // Pressing it doesn't unmask it.
+  sim_.Press(addr_c);
+  RunCycle();
+  EXPECT_EQ(live_keys[addr_c], Key_Masked);
+  EXPECT_TRUE(live_keys.isActive(addr_c));
+  ExpectIndexInStep();
+
+  sim_.Release(addr_c);
+  RunCycle();
+  EXPECT_FALSE(live_keys.isActive(addr_c));
+  ExpectIndexInStep();
+
+  // Masking a held key keeps it in the index, with its new value.
+  sim_.Press(addr_a);
+  RunCycle();
+  live_keys.mask(addr_a);
+  EXPECT_TRUE(live_keys.isActive(addr_a));
+  ExpectIndexInStep();
+
+  sim_.Release(addr_a);
+  RunCycle();
+  EXPECT_TRUE(IndexedLiveKeys().empty());
+  ExpectIndexInStep();
+}
+
+TEST_F(LiveKeysIndex, ClearEmptiesTheIndex) {
+  sim_.Press(addr_a);
+  sim_.Press(addr_shift_to_layer);
+  RunCycle();
+  live_keys.mask(addr_c);
+  ASSERT_EQ(IndexedLiveKeys().size(), 3u);
+
+  live_keys.clear();
+  EXPECT_TRUE(IndexedLiveKeys().empty());
+  ExpectIndexInStep();
+
+  // The keys are still held, but were cleared, so their releases leave the
+  // index empty.
+  sim_.Release(addr_a);
+  sim_.Release(addr_shift_to_layer);
+  RunCycle();
+  EXPECT_TRUE(IndexedLiveKeys().empty());
+  ExpectIndexInStep();
+}
+
+TEST_F(LiveKeysIndex, StaysInStepWithRandomInput) {
+  std::mt19937 rng(1138);
+  std::bitset<KeyAddr::upper_limit> pressed;
+
+  for (int i = 0; i < 2000; ++i) {
+    KeyAddr addr(uint8_t(rng() % KeyAddr::upper_limit));
+    if (pressed[addr.toInt()]) {
+      sim_.Release(addr);
+    } else {
+      sim_.Press(addr);
+    }
+    pressed.flip(addr.toInt());
+    // Now and then, mask a random key, or clear everything.
+    uint32_t action = rng() % 64;
+    if (action == 0) {
+      live_keys.mask(KeyAddr(uint8_t(rng() % KeyAddr::upper_limit)));
+    } else if (action == 1) {
+      live_keys.clear();
+    }
+    // Sometimes let more than one switch change state in the same cycle.
+    if (rng() % 4 != 0) {
+      RunCycle();
+      ExpectIndexInStep();
+    }
+  }
+
+  for (KeyAddr addr : KeyAddr::all()) {
+    if (pressed[addr.toInt()])
+      sim_.Release(addr);
+  }
+  RunCycle();
+  ExpectIndexInStep();
+  EXPECT_TRUE(IndexedLiveKeys().empty());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
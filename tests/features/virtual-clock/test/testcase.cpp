@@ -0,0 +1,191 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-IdleLEDs.h>    // for IdleLEDs
+#include <Kaleidoscope-LEDControl.h>  // for LEDControl
+#include <Kaleidoscope-OneShot.h>     // for OneShot
+#include <Kaleidoscope-TapDance.h>    // for TapDance
+#include <chrono>                     // for steady_clock, duration
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+// Defined in the sketch
+extern uint32_t cycles;
+extern uint32_t oneshot_timed_out_at;
+extern uint32_t tapdance_timed_out_at;
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr uint32_t minute = 60000;
+constexpr uint32_t hour   = 60 * minute;
+
+constexpr KeyAddr addr_oneshot{0, 3};
+constexpr KeyAddr addr_tapdance{0, 4};
+
+constexpr uint16_t tapdance_timeout = 200;
+
+class VirtualClock : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    ::IdleLEDs.setIdleTimeoutSeconds(10 * 60);
+    // Wake the LEDs up, in case an earlier test left them idle.
+    sim_.Press(KeyAddr{0, 0});
+    RunCycle();
+    sim_.Release(KeyAddr{0, 0});
+    RunCycle();
+    key_event_time_ = sim_.Now();
+    cycles          = 0;
+  }
+
+  uint32_t key_event_time_;
+};
+
+TEST_F(VirtualClock, AdvanceToSetsTheNextCycleStart) {
+  uint32_t target = sim_.Now() + 1000;
+  sim_.AdvanceTo(target);
+  RunCycle();
+  EXPECT_EQ(sim_.Now(), target);
+
+  sim_.AdvanceBy(500);
+  RunCycle();
+  EXPECT_EQ(sim_.Now(), target + 500 + sim_.CycleTime());
+
+  // The cycle time doesn't change where the next cycle starts.
+  sim_.SetCycleTime(5);
+  target = sim_.Now() + 1000;
+  sim_.AdvanceTo(target);
+  RunCycle();
+  EXPECT_EQ(sim_.Now(), target);
+  RunCycle();
+  EXPECT_EQ(sim_.Now(), target + 5);
+
+  // A time in the past just leaves the clock alone.
+  sim_.AdvanceTo(target);
+  RunCycle();
+  EXPECT_EQ(sim_.Now(), target + 10);
+  EXPECT_EQ(cycles, 5u);
+}
+
+TEST_F(VirtualClock, FastForwardFiresDeadlinesOnTime) {
+  sim_.SetFastForward(true);
+
+  sim_.RunForMillis(10 * minute - 1);
+  EXPECT_EQ(sim_.Now(), key_event_time_ + 10 * minute - 1);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  RunCycle();
+  EXPECT_FALSE(::LEDControl.isEnabled());
+
+  // Only the cycles in which LEDControl syncs the LEDs had to run. (Give or
+  // take a few, in which it catches up after an earlier test jumped ahead.)
+  EXPECT_LT(cycles, 10 * minute / 32 + 100);
+}
+
+TEST_F(VirtualClock, FastForwardThroughHoursOfIdle) {
+  sim_.SetFastForward(true);
+
+  auto wall_start = std::chrono::steady_clock::now();
+  sim_.RunForMillis(8 * hour);
+  std::chrono::duration<double, std::milli> wall_time =
+    std::chrono::steady_clock::now() - wall_start;
+
+  EXPECT_EQ(sim_.Now(), key_event_time_ + 8 * hour);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+  // Once the LEDs are off, nothing is left to do until the end.
+  EXPECT_LT(cycles, 10 * minute / 32 + 100);
+
+  std::cout << "8 hours of idle in " << cycles << " cycles, "
+            << wall_time.count() << " ms" << std::endl;
+
+  // A key press still wakes the LEDs up.
+  sim_.Press(KeyAddr{0, 1});
+  RunCycle();
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.Release(KeyAddr{0, 1});
+  RunCycle();
+}
+
+TEST_F(VirtualClock, FastForwardMatchesStepping) {
+  ::IdleLEDs.setIdleTimeoutSeconds(1);
+  sim_.RunForMillis(999);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(1);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+  uint32_t stepped_cycles = cycles;
+
+  sim_.Press(KeyAddr{0, 1});
+  RunCycle();
+  sim_.Release(KeyAddr{0, 1});
+  RunCycle();
+  cycles = 0;
+
+  sim_.SetFastForward(true);
+  sim_.RunForMillis(999);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(1);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+  EXPECT_LT(cycles * 10, stepped_cycles);
+}
+
+TEST_F(VirtualClock, FastForwardTimesOutOneShot) {
+  sim_.SetFastForward(true);
+
+  sim_.Press(addr_oneshot);
+  RunCycle();
+  uint32_t start = sim_.Now();
+  sim_.Release(addr_oneshot);
+  RunCycle();
+  ASSERT_TRUE(::OneShot.isActive());
+  cycles = 0;
+
+  sim_.RunForMillis(2 * ::OneShot.getTimeout());
+  EXPECT_FALSE(::OneShot.isActive());
+  // A cycle ran right when the timeout ran out, and few others did.
+  EXPECT_EQ(oneshot_timed_out_at, start + ::OneShot.getTimeout());
+  EXPECT_LT(cycles, 2u * ::OneShot.getTimeout() / 32 + 10);
+}
+
+TEST_F(VirtualClock, FastForwardResolvesTapDanceOnTime) {
+  sim_.SetFastForward(true);
+  ::TapDance.setTimeout(tapdance_timeout);
+
+  // A released tap is resolved when the timeout runs out, counted from the
+  // press, even though nothing else happens until then.
+  sim_.Press(addr_tapdance);
+  RunCycle();
+  uint32_t start = sim_.Now();
+  sim_.Release(addr_tapdance);
+  RunCycle();
+  tapdance_timed_out_at = 0;
+  cycles                = 0;
+
+  sim_.RunForMillis(2 * tapdance_timeout);
+  EXPECT_EQ(tapdance_timed_out_at, start + tapdance_timeout);
+  EXPECT_LT(cycles, 2u * tapdance_timeout / 32 + 10);
+
+  std::cout << "TapDance timeout of " << tapdance_timeout << " ms in "
+            << cycles << " cycles" << std::endl;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
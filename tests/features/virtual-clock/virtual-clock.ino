@@ -0,0 +1,85 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2020  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-IdleLEDs.h>
+#include <Kaleidoscope-LEDControl.h>
+#include <Kaleidoscope-OneShot.h>
+#include <Kaleidoscope-TapDance.h>
+
+// *INDENT-OFF*
+
+KEYMAPS(
+  [0] = KEYMAP_STACKED
+  (
+    Key_A ,Key_B ,Key_C ,OSM(LeftShift) ,TD(0) ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+          ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX   ,XXX   ,XXX   ,XXX
+   ,XXX
+  )
+) // KEYMAPS(
+
+// *INDENT-ON*
+
+// Counts the cycles that actually ran, for the test to compare with the time
+// that passed, and records when OneShot and TapDance last timed out.
+uint32_t cycles;
+uint32_t oneshot_timed_out_at;
+uint32_t tapdance_timed_out_at;
+
+void tapDanceAction(uint8_t tap_dance_index,
+                    KeyAddr key_addr,
+                    uint8_t tap_count,
+                    kaleidoscope::plugin::TapDance::ActionType tap_dance_action) {
+  if (tap_dance_action == TapDance.Timeout)
+    tapdance_timed_out_at = kaleidoscope::Runtime.millisAtCycleStart();
+  tapDanceActionKeys(tap_count, tap_dance_action, Key_X, Key_Y);
+}
+
+class CycleCounter : public kaleidoscope::Plugin {
+ public:
+  kaleidoscope::EventHandlerResult afterEachCycle() {
+    ++cycles;
+    if (oneshot_active_ && !OneShot.isActive())
+      oneshot_timed_out_at = kaleidoscope::Runtime.millisAtCycleStart();
+    oneshot_active_ = OneShot.isActive();
+    return kaleidoscope::EventHandlerResult::OK;
+  }
+
+ private:
+  bool oneshot_active_ = false;
+};
+
+CycleCounter cycleCounter;
+
+KALEIDOSCOPE_INIT_PLUGINS(LEDControl, IdleLEDs, OneShot, TapDance, cycleCounter);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
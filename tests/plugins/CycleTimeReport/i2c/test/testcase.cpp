@@ -0,0 +1,200 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+
+#include "kaleidoscope/device/keyboardio/VirtualTWI.h"   // for VirtualTWI
+#include "kaleidoscope/driver/color/GammaCorrection.h"   // for gamma_correction
+#include "kaleidoscope/driver/keyboardio/Model01Side.h"  // for Model01Side
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using device::keyboardio::VirtualTWI;
+using driver::keyboardio::Model01Side;
+
+class I2CTelemetry : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    VirtualTWI::reset();
+    // The sides on the keyboard are statically allocated, so their LED data
+    // starts out zeroed.
+    left_.ledData  = {};
+    right_.ledData = {};
+    left_.telemetry.reset();
+    right_.telemetry.reset();
+  }
+
+  Model01Side left_{0};
+  Model01Side right_{3};
+};
+
+TEST_F(I2CTelemetry, KeyReads) {
+  VirtualTWI::Scanner &scanner = VirtualTWI::scanner(3);
+  scanner.rows[0]              = 0x81;
+  scanner.rows[3]              = 0x02;
+
+  ASSERT_TRUE(right_.readKeys());
+  EXPECT_EQ(right_.getKeyData().rows[0], 0x81);
+  EXPECT_EQ(right_.getKeyData().rows[1], 0x00);
+  EXPECT_EQ(right_.getKeyData().rows[3], 0x02);
+  EXPECT_EQ(scanner.key_reads, 1);
+  EXPECT_EQ(VirtualTWI::scanner(0).key_reads, 0);
+
+  EXPECT_EQ(right_.telemetry.transactions, 1u);
+  EXPECT_EQ(right_.telemetry.bytes, 5u);
+  EXPECT_EQ(right_.telemetry.nacks, 0u);
+  EXPECT_EQ(left_.telemetry.transactions, 0u);
+}
+
+TEST_F(I2CTelemetry, Nacks) {
+  VirtualTWI::Scanner &scanner = VirtualTWI::scanner(0);
+  scanner.rows[1]              = 0x10;
+  scanner.nacks                = 2;
+
+  // Failed reads leave the last key data alone.
+  EXPECT_FALSE(left_.readKeys());
+  EXPECT_FALSE(left_.readKeys());
+  EXPECT_EQ(left_.getKeyData().rows[1], 0x00);
+  EXPECT_TRUE(left_.readKeys());
+  EXPECT_EQ(left_.getKeyData().rows[1], 0x10);
+  EXPECT_TRUE(left_.readKeys());
+
+  EXPECT_EQ(left_.telemetry.transactions, 4u);
+  EXPECT_EQ(left_.telemetry.bytes, 10u);
+  EXPECT_EQ(left_.telemetry.nacks, 2u);
+
+  scanner.connected = false;
+  EXPECT_FALSE(left_.readKeys());
+  EXPECT_EQ(left_.readVersion(), -1);
+  EXPECT_EQ(left_.telemetry.nacks, 5u);
+}
+
+TEST_F(I2CTelemetry, Registers) {
+  EXPECT_EQ(right_.setKeyscanInterval(50), 0);
+  EXPECT_EQ(right_.readKeyscanInterval(), 50);
+  EXPECT_EQ(left_.readKeyscanInterval(), 0);
+  EXPECT_GT(right_.readVersion(), 0);
+
+  // A write of two bytes, then a one-byte write and a one-byte read for each
+  // register read.
+  EXPECT_EQ(right_.telemetry.transactions, 5u);
+  EXPECT_EQ(right_.telemetry.bytes, 6u);
+  EXPECT_EQ(right_.telemetry.nacks, 0u);
+}
+
+TEST_F(I2CTelemetry, OnlyChangedLEDBanksAreSent) {
+  VirtualTWI::Scanner &scanner = VirtualTWI::scanner(0);
+
+  // To begin with, every LED is dirty, and they all have the same color, so
+  // they get sent with a single command.
+  EXPECT_TRUE(left_.sendLEDData());
+  EXPECT_FALSE(left_.isLEDDataDirty());
+  EXPECT_EQ(scanner.led_set_all_writes, 1);
+  EXPECT_EQ(scanner.led_bank_writes, 0);
+  EXPECT_FALSE(left_.sendLEDData());
+
+  // Setting an LED to its current color doesn't dirty anything.
+  EXPECT_FALSE(left_.setCrgbAt(3, CRGB(0, 0, 0)));
+  EXPECT_FALSE(left_.isLEDDataDirty());
+
+  // LED 17 is in the third bank.
+  EXPECT_TRUE(left_.setCrgbAt(17, CRGB(100, 150, 200)));
+  EXPECT_TRUE(left_.isLEDDataDirty());
+  EXPECT_TRUE(left_.sendLEDData());
+  EXPECT_FALSE(left_.isLEDDataDirty());
+  EXPECT_FALSE(left_.sendLEDData());
+  EXPECT_EQ(scanner.led_bank_writes, 1);
+
+  const uint8_t *led = &scanner.led_data[2][(17 % LEDS_PER_BANK) * 3];
+  EXPECT_EQ(led[0], driver::color::gamma_correction[200]);
+  EXPECT_EQ(led[1], driver::color::gamma_correction[150]);
+  EXPECT_EQ(led[2], driver::color::gamma_correction[100]);
+
+  EXPECT_EQ(left_.telemetry.transactions, 2u);
+  EXPECT_EQ(left_.telemetry.bytes, 4u + LED_BYTES_PER_BANK + 1);
+}
+
+TEST_F(I2CTelemetry, FailedLEDBankIsResent) {
+  VirtualTWI::Scanner &scanner = VirtualTWI::scanner(3);
+  EXPECT_TRUE(right_.sendLEDData());
+  right_.setCrgbAt(0, CRGB(1, 2, 3));
+
+  scanner.nacks = 1;
+  EXPECT_TRUE(right_.sendLEDData());
+  EXPECT_TRUE(right_.isLEDDataDirty());
+  EXPECT_EQ(scanner.led_bank_writes, 0);
+
+  EXPECT_TRUE(right_.sendLEDData());
+  EXPECT_FALSE(right_.isLEDDataDirty());
+  EXPECT_EQ(scanner.led_bank_writes, 1);
+
+  EXPECT_EQ(right_.telemetry.nacks, 1u);
+  EXPECT_EQ(right_.telemetry.transactions, 3u);
+}
+
+TEST_F(I2CTelemetry, Cycles) {
+  for (int i = 0; i < 10; ++i) {
+    left_.telemetry.startCycle();
+    left_.readKeys();
+    if (i == 5)
+      left_.setCrgbAt(0, CRGB(1, 2, 3));
+    left_.sendLEDData();
+  }
+  left_.telemetry.startCycle();
+
+  const driver::i2c::Telemetry &telemetry = left_.telemetry;
+  EXPECT_EQ(telemetry.cycles, 11u);
+  EXPECT_EQ(telemetry.transactions, 12u);
+  EXPECT_EQ(telemetry.cycle_bus_time, 0);
+  EXPECT_LE(telemetry.max_cycle_bus_time, telemetry.bus_time);
+
+  left_.telemetry.reset();
+  EXPECT_EQ(telemetry.cycles, 0u);
+  EXPECT_EQ(telemetry.transactions, 0u);
+  EXPECT_EQ(telemetry.bus_time, 0u);
+  EXPECT_EQ(telemetry.max_cycle_bus_time, 0);
+}
+
+TEST_F(I2CTelemetry, LongCyclesSaturate) {
+  driver::i2c::Telemetry telemetry;
+  telemetry.record(1, 40000, true);
+  telemetry.record(1, 40000, true);
+  EXPECT_EQ(telemetry.cycle_bus_time, UINT16_MAX);
+  telemetry.record(1, 100000, false);
+  EXPECT_EQ(telemetry.cycle_bus_time, UINT16_MAX);
+  EXPECT_EQ(telemetry.bus_time, 180000u);
+
+  telemetry.startCycle();
+  EXPECT_EQ(telemetry.max_cycle_bus_time, UINT16_MAX);
+  EXPECT_EQ(telemetry.cycle_bus_time, 0);
+}
+
+TEST_F(I2CTelemetry, FocusCommand) {
+  // The virtual device has no I2C bus of its own.
+  EXPECT_EQ(sim_.SendFocusCommand("cycletime.i2c"), "");
+  EXPECT_EQ(Runtime.device().i2cTelemetry(0), nullptr);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,147 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>  // for istringstream
+#include <string>   // for string, getline
+#include <vector>   // for vector
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr addr_a{0, 0};
+constexpr KeyAddr addr_qukey{0, 1};
+constexpr KeyAddr addr_c{0, 2};
+
+struct Sample {
+  unsigned row, col, pressed;
+  uint32_t latency;
+};
+
+class LatencyTrace : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    sim_.SendFocusCommand("cycletime.reset");
+  }
+
+  std::vector<Sample> latencySamples() {
+    std::vector<Sample> samples;
+    std::istringstream response(sim_.SendFocusCommand("cycletime.latency"));
+    for (std::string line; std::getline(response, line);) {
+      std::istringstream fields(line);
+      Sample sample;
+      if (fields >> sample.row >> sample.col >> sample.pressed >> sample.latency)
+        samples.push_back(sample);
+    }
+    return samples;
+  }
+
+  void tap(KeyAddr key_addr) {
+    sim_.Press(key_addr);
+    RunCycle();
+    sim_.Release(key_addr);
+    RunCycle();
+  }
+};
+
+TEST_F(LatencyTrace, KeyPressAndRelease) {
+  tap(addr_a);
+
+  auto samples = latencySamples();
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0].row, addr_a.row());
+  EXPECT_EQ(samples[0].col, addr_a.col());
+  EXPECT_EQ(samples[0].pressed, 1u);
+  EXPECT_GT(samples[0].latency, 0u);
+  EXPECT_EQ(samples[1].pressed, 0u);
+  EXPECT_GT(samples[1].latency, 0u);
+}
+
+TEST_F(LatencyTrace, DelayedByQukeys) {
+  // Qukeys holds the press back until the key is released, so the latency of
+  // the press has to include all of the time it spent in its queue. That is,
+  // unless a printable key was pressed just before, which the previous test
+  // might have done.
+  sim_.RunForMillis(200);
+  sim_.Press(addr_qukey);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 0u);
+  uint32_t pressed_at = micros();
+  sim_.RunCycles(5);
+  uint32_t released_at = micros();
+  sim_.Release(addr_qukey);
+  state = RunCycle();
+  ASSERT_GT(state->HIDReports()->Keyboard().size(), 0u);
+  // Qukeys also holds the release back, in case the key gets pressed again to
+  // repeat the tap.
+  sim_.RunForMillis(250);
+
+  auto samples = latencySamples();
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0].col, addr_qukey.col());
+  EXPECT_EQ(samples[0].pressed, 1u);
+  EXPECT_GE(samples[0].latency, released_at - pressed_at);
+  EXPECT_EQ(samples[1].pressed, 0u);
+}
+
+TEST_F(LatencyTrace, DetectionTimeCoversEveryKey) {
+  // A keyscanner that detected several keys toggling at once, before the
+  // cycle that handles them, has all of them start from that time.
+  sim_.RunForMillis(10);
+  uint32_t detected_at = micros() - 5000;
+  kaleidoscope_internal::latency_trace::detectedAt(detected_at);
+  sim_.Press(addr_a);
+  sim_.Press(addr_c);
+  RunCycle();
+  uint32_t handled_at = micros();
+  kaleidoscope_internal::latency_trace::clearDetectionTime();
+
+  sim_.Release(addr_a);
+  sim_.Release(addr_c);
+  RunCycle();
+
+  auto samples = latencySamples();
+  ASSERT_EQ(samples.size(), 4u);
+  EXPECT_EQ(samples[0].pressed, 1u);
+  EXPECT_GE(samples[0].latency, 5000u);
+  EXPECT_EQ(samples[1].pressed, 1u);
+  EXPECT_GE(samples[1].latency, 5000u);
+  EXPECT_LE(samples[1].latency, handled_at - detected_at);
+  // Later events are stamped when they are handled again.
+  EXPECT_EQ(samples[2].pressed, 0u);
+  EXPECT_LT(samples[2].latency, 5000u);
+  EXPECT_EQ(samples[3].pressed, 0u);
+  EXPECT_LT(samples[3].latency, 5000u);
+}
+
+TEST_F(LatencyTrace, RingBuffer) {
+  for (int i = 0; i < 20; ++i)
+    tap(addr_a);
+  // Only the most recent 32 events are kept.
+  EXPECT_EQ(latencySamples().size(), 32u);
+
+  sim_.SendFocusCommand("cycletime.reset");
+  EXPECT_TRUE(latencySamples().empty());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,146 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <map>      // for map
+#include <sstream>  // for istringstream
+#include <string>   // for string, getline
+#include <vector>   // for vector
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr addr_a{0, 0};
+
+class CycleTimeProfiler : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    sim_.SendFocusCommand("cycletime.reset");
+  }
+
+  // Splits a Focus response into lines of space-separated words.
+  std::vector<std::vector<std::string>> focusLines(const std::string &command) {
+    std::vector<std::vector<std::string>> lines;
+    std::istringstream response(sim_.SendFocusCommand(command));
+    for (std::string line; std::getline(response, line);) {
+      std::istringstream words(line);
+      std::vector<std::string> fields;
+      for (std::string word; words >> word;)
+        fields.push_back(word);
+      if (!fields.empty())
+        lines.push_back(fields);
+    }
+    return lines;
+  }
+};
+
+TEST_F(CycleTimeProfiler, Histogram) {
+  sim_.RunCycles(100);
+
+  auto lines = focusLines("cycletime.histogram");
+  ASSERT_EQ(lines.size(), 17u);
+  ASSERT_EQ(lines[0].size(), 4u);
+  uint32_t cycles = std::stoul(lines[0][0]);
+  uint32_t min    = std::stoul(lines[0][1]);
+  uint32_t max    = std::stoul(lines[0][2]);
+  uint32_t p99    = std::stoul(lines[0][3]);
+
+  // The cycles run since the reset, plus the ones it took to get the response.
+  EXPECT_GE(cycles, 100u);
+  EXPECT_LE(cycles, 110u);
+  EXPECT_LE(min, p99);
+  EXPECT_LE(p99, max);
+
+  uint32_t bucket_total = 0;
+  for (size_t i = 1; i < lines.size(); ++i) {
+    ASSERT_EQ(lines[i].size(), 2u);
+    EXPECT_EQ(std::stoul(lines[i][0]), i == 1 ? 0u : 1u << (i - 1));
+    bucket_total += std::stoul(lines[i][1]);
+  }
+  EXPECT_EQ(bucket_total, cycles);
+}
+
+TEST_F(CycleTimeProfiler, IdleCycles) {
+  sim_.RunCycles(100);
+  sim_.Press(addr_a);
+  sim_.RunCycles(50);
+  sim_.Release(addr_a);
+  sim_.RunCycles(2);
+
+  auto lines = focusLines("cycletime.idle");
+  ASSERT_EQ(lines.size(), 1u);
+  ASSERT_EQ(lines[0].size(), 3u);
+  uint32_t cycles = std::stoul(lines[0][0]);
+
+  // The cycles with the key held don't count, apart from the one it was
+  // pressed in.
+  EXPECT_GE(cycles, 101u);
+  EXPECT_LE(cycles, 112u);
+  EXPECT_GT(std::stoul(lines[0][2]), 0u);
+
+  sim_.SendFocusCommand("cycletime.reset");
+  lines = focusLines("cycletime.idle");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_LE(std::stoul(lines[0][0]), 10u);
+}
+
+TEST_F(CycleTimeProfiler, Hooks) {
+  for (int i = 0; i < 2; ++i) {
+    sim_.Press(addr_a);
+    RunCycle();
+    sim_.Release(addr_a);
+    RunCycle();
+  }
+
+  // hook -> plugin -> calls
+  std::map<std::string, std::map<std::string, uint32_t>> calls;
+  for (const auto &line : focusLines("cycletime.hooks")) {
+    ASSERT_EQ(line.size(), 5u);
+    calls[line[0]][line[1]] = std::stoul(line[2]);
+  }
+
+  EXPECT_EQ(calls["onKeyEvent"]["KeyEventSink"], 4u);
+  EXPECT_GE(calls["onKeyEvent"]["all"], 4u);
+  EXPECT_EQ(calls["onKeyswitchEvent"]["all"], 4u);
+  EXPECT_GT(calls["beforeEachCycle"]["CycleTimeReport"], 4u);
+  EXPECT_EQ(calls["beforeEachCycle"]["CycleTimeReport"],
+            calls["beforeEachCycle"]["all"]);
+  // KeyEventSink doesn't have any other handlers, so it isn't listed for any
+  // other hook.
+  EXPECT_EQ(calls["beforeEachCycle"].count("KeyEventSink"), 0u);
+
+  sim_.SendFocusCommand("cycletime.reset");
+  calls.clear();
+  for (const auto &line : focusLines("cycletime.hooks"))
+    calls[line[0]][line[1]] = std::stoul(line[2]);
+  EXPECT_EQ(calls["onKeyEvent"].count("KeyEventSink"), 0u);
+}
+
+TEST_F(CycleTimeProfiler, ScanTiming) {
+  // The virtual device scans its matrix in the main loop, untimed.
+  driver::keyscanner::ScanTiming timing;
+  EXPECT_FALSE(Runtime.device().scanTiming(timing));
+  EXPECT_EQ(sim_.SendFocusCommand("cycletime.scan"), "");
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,144 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>  // for istringstream, ostringstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <Kaleidoscope-EEPROM-Keymap.h>  // for EEPROMKeymap
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::Contains;
+
+class EEPROMKeymapCache : public VirtualDeviceTest {
+ protected:
+  KeyAddr findKey(Key key) {
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      if (Layer_::getKeyFromPROGMEM(0, key_addr) == key)
+        return key_addr;
+    }
+    return KeyAddr::none();
+  }
+
+  // Write both EEPROM layers with `keymap.custom`, with every key transparent
+  // except the one at `addr_a_`.
+  void writeCustomKeymap(Key layer1_key, Key layer2_key) {
+    std::ostringstream command;
+    command << "keymap.custom";
+    for (Key key : {layer1_key, layer2_key}) {
+      for (KeyAddr key_addr : KeyAddr::all()) {
+        command << " " << (key_addr == addr_a_ ? key : Key_Transparent).getRaw();
+      }
+    }
+    sim_.SendFocusCommand(command.str());
+  }
+
+  // Returns the keycodes in the report sent when `addr_a_` gets pressed while
+  // the key at `shift_addr` is held.
+  std::vector<uint8_t> pressWithShift(KeyAddr shift_addr) {
+    sim_.Press(shift_addr);
+    RunCycle();
+    sim_.Press(addr_a_);
+    auto state = RunCycle();
+    sim_.Release(addr_a_);
+    RunCycle();
+    sim_.Release(shift_addr);
+    RunCycle();
+
+    if (state->HIDReports()->Keyboard().size() != 1)
+      return {};
+    return state->HIDReports()->Keyboard(0).ActiveKeycodes();
+  }
+
+  KeyAddr addr_a_      = findKey(Key_A);
+  KeyAddr addr_shift1_ = findKey(ShiftToLayer(1));
+  KeyAddr addr_shift2_ = findKey(ShiftToLayer(2));
+};
+
+TEST_F(EEPROMKeymapCache, LookupsFollowKeymapUpdates) {
+  writeCustomKeymap(Key_B, Key_C);
+  EXPECT_THAT(pressWithShift(addr_shift2_), Contains(Key_C.getKeyCode()));
+  EXPECT_THAT(pressWithShift(addr_shift1_), Contains(Key_B.getKeyCode()));
+
+  // Layer 1 is the one in the cache now; updating it must update the cached
+  // copy.
+  writeCustomKeymap(Key_D, Key_C);
+  EXPECT_THAT(pressWithShift(addr_shift1_), Contains(Key_D.getKeyCode()));
+
+  // With layer 2 active and in the cache, layer 1 can't evict it, but lookups
+  // from it must still return the right keys.
+  sim_.Press(addr_shift2_);
+  RunCycle();
+  EXPECT_EQ(Layer.getKey(2, addr_a_), Key_C);
+  EXPECT_EQ(Layer.getKey(1, addr_a_), Key_D);
+  EXPECT_EQ(Layer.getKey(2, addr_a_), Key_C);
+  sim_.Release(addr_shift2_);
+  RunCycle();
+}
+
+TEST_F(EEPROMKeymapCache, SlotGoesToActiveLayerAfterLayerChange) {
+  using plugin::eeprom_keymap::cache;
+
+  writeCustomKeymap(Key_B, Key_C);
+  EXPECT_THAT(pressWithShift(addr_shift2_), Contains(Key_C.getKeyCode()));
+  EXPECT_EQ(cache[0].layer, 1);
+
+  // Layer 2 got deactivated when its shift key was released, so layer 1 can
+  // take over its slot.
+  EXPECT_THAT(pressWithShift(addr_shift1_), Contains(Key_B.getKeyCode()));
+  EXPECT_EQ(cache[0].layer, 0);
+
+  // While layer 1 is active, looking up keys from the inactive layer 2 must
+  // leave it in the cache.
+  sim_.Press(addr_shift1_);
+  RunCycle();
+  EXPECT_EQ(Layer.getKey(2, addr_a_), Key_C);
+  EXPECT_EQ(cache[0].layer, 0);
+  sim_.Release(addr_shift1_);
+  RunCycle();
+}
+
+TEST_F(EEPROMKeymapCache, ContentsWriteDiscardsCache) {
+  writeCustomKeymap(Key_B, Key_C);
+  EXPECT_THAT(pressWithShift(addr_shift1_), Contains(Key_B.getKeyCode()));
+
+  // Overwrite the keycode byte of the layer 1 entry directly.
+  std::istringstream contents(sim_.SendFocusCommand("eeprom.contents"));
+  std::vector<unsigned> bytes;
+  for (unsigned byte; contents >> byte;)
+    bytes.push_back(byte);
+  ASSERT_FALSE(bytes.empty());
+  bytes[EEPROMKeymap.keymap_base() + addr_a_.toInt() * 2 + 1] = Key_E.getKeyCode();
+
+  std::ostringstream command;
+  command << "eeprom.contents";
+  for (unsigned byte : bytes)
+    command << " " << byte;
+  sim_.SendFocusCommand(command.str());
+
+  EXPECT_THAT(pressWithShift(addr_shift1_), Contains(Key_E.getKeyCode()));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,187 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>  // for count, max
+#include <chrono>     // for steady_clock, duration
+#include <vector>     // for vector
+
+#include <Kaleidoscope-MacroSupport.h>  // for MacroSupport
+
+#include "testing/setup-googletest.h"
+
+#include "testing/iostream.h"  // for cout
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::IsEmpty;
+
+constexpr KeyAddr addr_macro{0, 0};
+constexpr KeyAddr addr_dynamic_macro{0, 1};
+constexpr KeyAddr addr_z{0, 2};
+
+constexpr int macro_steps = 500;
+
+class LongMacro : public VirtualDeviceTest {
+ protected:
+  void TearDown() override {
+    ::MacroSupport.abort();
+    RunCycle();
+  }
+
+  // Returns the number of keyboard reports in `state` that contain `key`.
+  static int countReportsWith(const State &state, Key key) {
+    int count = 0;
+    for (const auto &report : state.HIDReports()->Keyboard()) {
+      std::vector<uint8_t> keycodes = report.ActiveKeycodes();
+      count += std::count(keycodes.begin(), keycodes.end(), key.getKeyCode());
+    }
+    return count;
+  }
+};
+
+TEST_F(LongMacro, CyclesStayShort) {
+  sim_.Press(addr_macro);
+  size_t max_reports      = 0;
+  uint32_t max_cycle_time = 0;
+  int taps                = 0;
+  int cycles              = 0;
+  uint32_t start          = Runtime.millisAtCycleStart();
+  std::chrono::duration<double, std::micro> max_time{0}, total_time{0};
+
+  do {
+    uint32_t cycle_start = Runtime.millisAtCycleStart();
+    auto wall_start      = std::chrono::steady_clock::now();
+    auto state           = RunCycle();
+    std::chrono::duration<double, std::micro> time =
+      std::chrono::steady_clock::now() - wall_start;
+    max_time = std::max(max_time, time);
+    total_time += time;
+    // Any `delay()` during the cycle would show up as virtual time that
+    // passed on top of the cycle time.
+    max_cycle_time = std::max(max_cycle_time, Runtime.millisAtCycleStart() - cycle_start);
+
+    max_reports = std::max(max_reports, state->HIDReports()->Keyboard().size());
+    taps += countReportsWith(*state, Key_A) + countReportsWith(*state, Key_B);
+    if (++cycles == 1)
+      sim_.Release(addr_macro);
+  } while (::MacroSupport.isPlaying() && cycles < 100 * macro_steps);
+
+  std::cout << macro_steps << "-step macro played over " << cycles << " cycles:"
+            << std::endl
+            << "  max keyboard reports per cycle: " << max_reports << std::endl
+            << "  max time per cycle: " << max_time.count() << " us" << std::endl
+            << "  whole macro: " << total_time.count() << " us" << std::endl;
+
+  EXPECT_FALSE(::MacroSupport.isPlaying());
+  EXPECT_EQ(taps, macro_steps);
+  // No cycle blocked: each of them started one cycle time after the last.
+  EXPECT_EQ(max_cycle_time, uint32_t(sim_.CycleTime()));
+  // At most the release of one tap and the press of the next one per cycle
+  EXPECT_LE(max_reports, 2u);
+  // The press and release of each tap are still spaced out.
+  EXPECT_GE(Runtime.millisAtCycleStart() - start,
+            uint32_t(macro_steps * MACRO_TAP_RELEASE_DELAY));
+}
+
+TEST_F(LongMacro, TypingWhilePlaying) {
+  sim_.Press(addr_macro);
+  sim_.RunCycles(3);
+  ASSERT_TRUE(::MacroSupport.isPlaying());
+
+  sim_.Press(addr_z);
+  auto state = RunCycle();
+  EXPECT_GT(countReportsWith(*state, Key_Z), 0);
+  EXPECT_TRUE(::MacroSupport.isPlaying());
+
+  sim_.Release(addr_z);
+  sim_.Release(addr_macro);
+  state = RunCycle();
+  EXPECT_EQ(countReportsWith(*state, Key_Z), 0);
+  EXPECT_GT(countReportsWith(*state, Key_A), 0);
+}
+
+TEST_F(LongMacro, Abort) {
+  sim_.Press(addr_macro);
+  RunCycle();
+  sim_.Release(addr_macro);
+  RunCycle();
+  ASSERT_TRUE(::MacroSupport.isPlaying());
+
+  ::MacroSupport.abort();
+  EXPECT_FALSE(::MacroSupport.isPlaying());
+  // Aborting releases the key of the tap that was in progress, and nothing
+  // else gets typed after that.
+  auto state = RunCycle();
+  EXPECT_EQ(countReportsWith(*state, Key_A), 0);
+  EXPECT_EQ(countReportsWith(*state, Key_B), 0);
+  state = RunCycle();
+  EXPECT_THAT(state->HIDReports()->Keyboard(), IsEmpty());
+}
+
+TEST_F(LongMacro, DynamicMacroWaits) {
+  // Tc(A), W(50), Tc(B)
+  sim_.SendFocusCommand("macros.map 8 4 2 50 8 5 0");
+
+  sim_.Press(addr_dynamic_macro);
+  auto state = RunCycle();
+  EXPECT_EQ(countReportsWith(*state, Key_A), 1);
+  EXPECT_EQ(countReportsWith(*state, Key_B), 0);
+  uint32_t start = Runtime.millisAtCycleStart();
+
+  sim_.Release(addr_dynamic_macro);
+  int cycles = 0;
+  do {
+    state = RunCycle();
+    ++cycles;
+  } while (countReportsWith(*state, Key_B) == 0 && cycles < 100);
+
+  EXPECT_GE(Runtime.millisAtCycleStart() - start, 50u);
+  EXPECT_GT(cycles, 1);
+
+  // The final tap is released in a later cycle.
+  sim_.RunForMillis(MACRO_TAP_RELEASE_DELAY);
+  EXPECT_FALSE(::MacroSupport.isPlaying());
+}
+
+TEST_F(LongMacro, WakesForTheNextStep) {
+  EXPECT_EQ(Runtime.millisUntilNextWake(), Runtime.no_deadline);
+
+  // Tc(A), W(50), Tc(B)
+  sim_.SendFocusCommand("macros.map 8 4 2 50 8 5 0");
+  sim_.Press(addr_dynamic_macro);
+  RunCycle();
+  sim_.Release(addr_dynamic_macro);
+  EXPECT_EQ(Runtime.millisUntilNextWake(), uint32_t(MACRO_TAP_RELEASE_DELAY));
+
+  // A device that sleeps between cycles would wake up just in time for B.
+  sim_.RunForMillis(MACRO_TAP_RELEASE_DELAY);
+  uint32_t wake_at = Runtime.millisAtCycleStart() + Runtime.millisUntilNextWake();
+  int cycles       = 0;
+  while (countReportsWith(*RunCycle(), Key_B) == 0 && ++cycles < 100) {}
+  EXPECT_EQ(Runtime.millisAtCycleStart(), wake_at);
+
+  sim_.RunForMillis(MACRO_TAP_RELEASE_DELAY);
+  EXPECT_FALSE(::MacroSupport.isPlaying());
+  EXPECT_EQ(Runtime.millisUntilNextWake(), Runtime.no_deadline);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,188 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "HIDReportObserver.h"                                     // for HIDReportObserver
+#include "kaleidoscope/device/virtual/DefaultHIDReportConsumer.h"  // for DefaultHIDReportConsumer
+#include "kaleidoscope/device/virtual/Logging.h"                   // for toggleVerboseOutput
+#include "kaleidoscope/device/virtual/Trace.h"                     // for TraceReader, TraceWriter
+#include "testing/HIDState.h"                                      // for HIDStateBuilder
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using device::virt::HIDReportRecord;
+using device::virt::KeyEventRecord;
+using device::virt::TraceKind;
+using device::virt::TraceReader;
+using device::virt::TraceWriter;
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr KeyAddr addr_a{0, 0};
+constexpr KeyAddr addr_b{0, 1};
+constexpr KeyAddr addr_c{0, 2};
+
+// The cycle (counted from the start of the replay) and keycodes of a keyboard
+// report
+typedef std::pair<uint32_t, std::vector<uint8_t>> TimedReport;
+
+class Trace : public VirtualDeviceTest {
+ protected:
+  void TearDown() override {
+    scanner().stopRecording();
+  }
+
+  static Device::KeyScanner &scanner() {
+    return Runtime.device().keyScanner();
+  }
+
+  static std::string tracePath(const char *name) {
+    return ::testing::TempDir() + name;
+  }
+
+  static void writeKeyTrace(const std::string &path,
+                            const std::vector<KeyEventRecord> &records) {
+    TraceWriter writer;
+    ASSERT_TRUE(writer.open(path.c_str(), TraceKind::KeyEvents));
+    for (const KeyEventRecord &record : records)
+      writer.write(record);
+  }
+
+  // Runs cycles until the replay of the trace at `path` is done, and returns
+  // the keyboard reports sent meanwhile.
+  std::vector<TimedReport> replay(const std::string &path) {
+    std::vector<TimedReport> reports;
+    EXPECT_TRUE(scanner().replayTrace(path.c_str()));
+    for (uint32_t cycle = 1; scanner().isReplaying(); ++cycle) {
+      auto state = RunCycle();
+      for (const auto &report : state->HIDReports()->Keyboard())
+        reports.emplace_back(cycle, report.ActiveKeycodes());
+    }
+    return reports;
+  }
+};
+
+TEST_F(Trace, Replay) {
+  std::string path = tracePath("replay.ktrace");
+  writeKeyTrace(path, {
+                        {1, addr_a.row(), addr_a.col(), true},
+                        {3, addr_b.row(), addr_b.col(), true},
+                        {5, addr_a.row(), addr_a.col(), false},
+                        {8, addr_b.row(), addr_b.col(), false},
+                      });
+
+  EXPECT_THAT(replay(path),
+              ElementsAre(TimedReport{1, {Key_A.getKeyCode()}},
+                          TimedReport{3, {Key_A.getKeyCode(), Key_B.getKeyCode()}},
+                          TimedReport{5, {Key_B.getKeyCode()}},
+                          TimedReport{8, {}}));
+  EXPECT_EQ(scanner().getKeystate(addr_a), Device::KeyScanner::KeyState::NotPressed);
+}
+
+TEST_F(Trace, PressAndReleaseInOneCycle) {
+  std::string path = tracePath("tap.ktrace");
+  writeKeyTrace(path, {
+                        {2, addr_c.row(), addr_c.col(), true},
+                        {2, addr_c.row(), addr_c.col(), false},
+                      });
+
+  EXPECT_THAT(replay(path),
+              ElementsAre(TimedReport{2, {Key_C.getKeyCode()}},
+                          TimedReport{2, {}}));
+}
+
+TEST_F(Trace, RecordAndReplay) {
+  std::string path = tracePath("recorded.ktrace");
+  ASSERT_TRUE(scanner().recordTrace(path.c_str()));
+
+  std::vector<TimedReport> expected;
+  auto runCycles = [&](int count) {
+    for (int i = 0; i < count; ++i) {
+      auto state = RunCycle();
+      for (const auto &report : state->HIDReports()->Keyboard())
+        expected.emplace_back(scanner().scanCount(), report.ActiveKeycodes());
+    }
+  };
+  uint32_t start = scanner().scanCount();
+
+  sim_.Press(addr_a);
+  runCycles(2);
+  sim_.Press(addr_c);
+  runCycles(1);
+  sim_.Release(addr_a);
+  sim_.Release(addr_c);
+  runCycles(4);
+  scanner().setKeystate(addr_b, Device::KeyScanner::KeyState::Tap);
+  runCycles(2);
+  scanner().stopRecording();
+
+  for (TimedReport &report : expected)
+    report.first -= start;
+  ASSERT_FALSE(expected.empty());
+  EXPECT_EQ(replay(path), expected);
+}
+
+TEST_F(Trace, RecordHIDReports) {
+  std::string keys_path = tracePath("keys.ktrace");
+  std::string hid_path  = tracePath("reports.ktrace");
+  writeKeyTrace(keys_path, {
+                             {1, addr_a.row(), addr_a.col(), true},
+                             {4, addr_a.row(), addr_a.col(), false},
+                           });
+
+  logging::toggleVerboseOutput(false);
+  HIDReportObserver::resetHook(&DefaultHIDReportConsumer::processHIDReport);
+  ASSERT_TRUE(DefaultHIDReportConsumer::startRecording(hid_path.c_str()));
+  EXPECT_THAT(replay(keys_path), IsEmpty());
+  DefaultHIDReportConsumer::stopRecording();
+  HIDReportObserver::resetHook(&internal::HIDStateBuilder::ProcessHidReport);
+  logging::toggleVerboseOutput(true);
+
+  TraceReader reader;
+  ASSERT_TRUE(reader.open(hid_path.c_str(), TraceKind::HIDReports));
+  std::vector<TimedReport> reports;
+  HIDReportRecord record;
+  while (reader.next(record)) {
+    if (record.id == KeyboardReport::kHidReportType)
+      reports.emplace_back(record.cycle, KeyboardReport(record.data).ActiveKeycodes());
+  }
+  EXPECT_THAT(reports,
+              ElementsAre(TimedReport{1, {Key_A.getKeyCode()}},
+                          TimedReport{4, {}}));
+
+  // A trace of HID reports can't be replayed as key events.
+  EXPECT_FALSE(scanner().replayTrace(hid_path.c_str()));
+  EXPECT_FALSE(scanner().isReplaying());
+}
+
+TEST_F(Trace, MissingTrace) {
+  EXPECT_FALSE(scanner().replayTrace(tracePath("missing.ktrace").c_str()));
+  EXPECT_FALSE(scanner().isReplaying());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope